@@ -131,6 +131,17 @@ set(FLECSI_ID_FBITS "4" CACHE STRING
 set(FLECSI_COUNTER_TYPE "int32_t" CACHE STRING
   "Select the type that will be used for loop and iterator values")
 
+#------------------------------------------------------------------------------#
+# Add options for field data alignment and huge pages
+#------------------------------------------------------------------------------#
+
+set(FLECSI_FIELD_ALIGNMENT "64" CACHE STRING
+  "Select the alignment in bytes of field data (a power of two)")
+
+option(ENABLE_HUGE_PAGES
+  "Back large field data allocations with transparent huge pages" OFF)
+set(FLECSI_ENABLE_HUGE_PAGES ${ENABLE_HUGE_PAGES})
+
 #------------------------------------------------------------------------------#
 # Add option for FleCSIT command-line tool.
 #------------------------------------------------------------------------------#
@@ -196,6 +207,23 @@ if(ENABLE_OPENSSL)
   endif()
 endif()
 
+#------------------------------------------------------------------------------#
+# OpenMP
+#------------------------------------------------------------------------------#
+
+option(ENABLE_OPENMP "Enable OpenMP on-node kernels" OFF)
+
+if(ENABLE_OPENMP)
+  find_package(OpenMP REQUIRED)
+
+  if(OPENMP_FOUND)
+    set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} ${OpenMP_C_FLAGS}")
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${OpenMP_CXX_FLAGS}")
+    set(CMAKE_EXE_LINKER_FLAGS
+      "${CMAKE_EXE_LINKER_FLAGS} ${OpenMP_CXX_FLAGS}")
+  endif()
+endif()
+
 #------------------------------------------------------------------------------#
 # Caliper
 #------------------------------------------------------------------------------#
@@ -10,6 +10,7 @@
 ///
 
 #include "flecsi/execution/execution.h"
+#include "flecsi/execution/kernel.h"
 #include "flecsi/data/data.h"
 #include "flecsi/io/simple_definition.h"
 #include "flecsi/coloring/dcrs_utils.h"
@@ -30,10 +31,18 @@
 #define DT std::min(CFL * DX / U, CFL * DY / V)
 #define X_ADVECTION U * DT / DX
 #define Y_ADVECTION V * DT / DX
+#define GRAIN 128
 
 using namespace flecsi;
 using namespace supplemental;
 
+using flecsi::execution::for_each_offset__;
+
+// The on-node execution policy of the task loops. Chunks of GRAIN cells
+// run on OpenMP threads (OMP_NUM_THREADS), or on the calling thread if
+// FleCSI is built without ENABLE_OPENMP.
+static const flecsi::execution::openmp_execution_t kernel_policy(GRAIN);
+
 void initialize_data(
         dense_accessor<size_t, flecsi::rw, flecsi::rw, flecsi::ro> global_IDs,
         dense_accessor<double, flecsi::rw, flecsi::rw, flecsi::ro> phi);
@@ -385,7 +394,8 @@ void calculate_exclusive_x_update(
     create_gid_to_index_maps(global_IDs, &map_gid_to_excl_index,
         &map_gid_to_shared_index, &map_gid_to_ghost_index);
 
-    for (size_t index = 0; index < phi.exclusive_size(); index++) {
+    for_each_offset__(kernel_policy, 0, phi.exclusive_size(),
+      [&](size_t index) {
         size_t gid_plus_i, gid_minus_i;
         calc_x_indices(global_IDs(index), &gid_plus_i, &gid_minus_i);
 
@@ -414,7 +424,7 @@ void calculate_exclusive_x_update(
           assert(false);
 
         phi_update(index) = update;
-    }
+      });
 
 
 }
@@ -433,7 +443,8 @@ void advect_owned_cells_in_x(
   create_gid_to_index_maps(global_IDs, &map_gid_to_excl_index,
       &map_gid_to_shared_index, &map_gid_to_ghost_index);
 
-  for (size_t index = 0; index < phi.shared_size(); index++) {
+  for_each_offset__(kernel_policy, 0, phi.shared_size(),
+    [&](size_t index) {
       size_t gid_plus_i, gid_minus_i;
       calc_x_indices(global_IDs.shared(index), &gid_plus_i, &gid_minus_i);
 
@@ -470,13 +481,13 @@ void advect_owned_cells_in_x(
         assert(false);
 
       phi_update.shared(index) = update;
-  }
+    });
 
-  for (size_t index = 0; index < phi.exclusive_size(); index++)
-      phi(index) += phi_update(index);
+  for_each_offset__(kernel_policy, 0, phi.exclusive_size(),
+    [&](size_t index) { phi(index) += phi_update(index); });
 
-  for (size_t index = 0; index < phi.shared_size(); index++)
-      phi.shared(index) += phi_update.shared(index);
+  for_each_offset__(kernel_policy, 0, phi.shared_size(),
+    [&](size_t index) { phi.shared(index) += phi_update.shared(index); });
 
 }
 
@@ -494,7 +505,8 @@ void calculate_exclusive_y_update(
   create_gid_to_index_maps(global_IDs, &map_gid_to_excl_index,
       &map_gid_to_shared_index, &map_gid_to_ghost_index);
 
-  for (size_t index = 0; index < phi.exclusive_size(); index++) {
+  for_each_offset__(kernel_policy, 0, phi.exclusive_size(),
+    [&](size_t index) {
       size_t gid_plus_j, gid_minus_j;
       calc_y_indices(global_IDs(index), &gid_plus_j, &gid_minus_j);
 
@@ -523,7 +535,7 @@ void calculate_exclusive_y_update(
         assert(false);
 
       phi_update(index) = update;
-  }
+    });
 
 }
 
@@ -541,7 +553,8 @@ void advect_owned_cells_in_y(
   create_gid_to_index_maps(global_IDs, &map_gid_to_excl_index,
       &map_gid_to_shared_index, &map_gid_to_ghost_index);
 
-  for (size_t index = 0; index < phi.shared_size(); index++) {
+  for_each_offset__(kernel_policy, 0, phi.shared_size(),
+    [&](size_t index) {
       size_t gid_plus_j, gid_minus_j;
       calc_y_indices(global_IDs.shared(index), &gid_plus_j, &gid_minus_j);
 
@@ -578,13 +591,13 @@ void advect_owned_cells_in_y(
         assert(false);
 
       phi_update.shared(index) = update;
-  }
+    });
 
-  for (size_t index = 0; index < phi.exclusive_size(); index++)
-      phi(index) += phi_update(index);
+  for_each_offset__(kernel_policy, 0, phi.exclusive_size(),
+    [&](size_t index) { phi(index) += phi_update(index); });
 
-  for (size_t index = 0; index < phi.shared_size(); index++)
-      phi.shared(index) += phi_update.shared(index);
+  for_each_offset__(kernel_policy, 0, phi.shared_size(),
+    [&](size_t index) { phi.shared(index) += phi_update.shared(index); });
 
 }
 
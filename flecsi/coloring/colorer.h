@@ -15,11 +15,34 @@
 
 /*! @file */
 
+#include <set>
+#include <vector>
+
 #include <flecsi/coloring/crs.h>
 
 namespace flecsi {
 namespace coloring {
 
+/*!
+ The coloring_statistics_t type records the quality of a coloring.
+
+ @var edgecut   The (weighted) number of edges that are cut by the coloring.
+ @var weights   The total weight of each color for each constraint,
+                stored contiguously for each color.
+ @var imbalance The load imbalance for each constraint, i.e., the maximum
+                over the colors of the ratio of the weight of a color to
+                its target weight. A perfectly balanced coloring has an
+                imbalance of 1.
+
+ @ingroup coloring
+ */
+
+struct coloring_statistics_t {
+  size_t edgecut = 0;
+  std::vector<size_t> weights;
+  std::vector<double> imbalance;
+}; // struct coloring_statistics_t
+
 /*!
  The colorer_t type provides an interface for creating distributed-memory
  colorings from a distributed, compressed-row storage graph representation.
@@ -36,12 +59,42 @@ struct colorer_t {
    @param dcrs A distributed, compressed-row-storage representation
                of the graph to color.
 
-   @return The set of indices that belong to the current execution
-           instance.
+   @return The set of indices (or ids, see dcrs_t::ids) that belong to
+           the current execution instance.
    */
 
   virtual std::set<size_t> color(const dcrs_t & dcrs) = 0;
 
+  /*!
+   This method takes a distributed, compressed-row-storage representation
+   of a graph that is distributed according to an existing coloring,
+   e.g., with weights that reflect the current cost of each index, and
+   returns a new coloring that balances the weights, while moving few
+   indices to other colors.
+
+   @param dcrs A distributed, compressed-row-storage representation
+               of the graph to color, in which the indices of each
+               execution instance are those of its current coloring.
+
+   @return The set of ids (see dcrs_t::ids) that belong to the current
+           execution instance.
+   */
+
+  virtual std::set<size_t> repartition(const dcrs_t & dcrs) = 0;
+
+  /*!
+   Return the statistics of the coloring that was created by the last
+   call to color or repartition. The statistics are the same on each
+   execution instance.
+   */
+
+  const coloring_statistics_t & statistics() const {
+    return statistics_;
+  } // statistics
+
+protected:
+  coloring_statistics_t statistics_;
+
 }; // class colorer_t
 
 } // namespace coloring
@@ -15,9 +15,11 @@
 
 /*! @file */
 
-#include <set>
+#include <ostream>
 #include <vector>
 
+#include <flecsi/utils/flat_set.h>
+
 namespace flecsi {
 namespace coloring {
 
@@ -37,10 +39,10 @@ struct coloring_info_t {
   size_t ghost;
 
   //! The aggregate set of colors that depend on our shared indices.
-  std::set<size_t> shared_users;
+  utils::flat_set__<size_t> shared_users;
 
   //! The aggregate set of colors that we depend on for ghosts.
-  std::set<size_t> ghost_owners;
+  utils::flat_set__<size_t> ghost_owners;
 
 }; // struct coloring_info_t
 
@@ -73,7 +75,7 @@ struct entity_info_t {
   size_t id;
   size_t rank;
   size_t offset;
-  std::set<size_t> shared;
+  utils::flat_set__<size_t> shared;
 
   /*!
    Constructor.
@@ -89,8 +91,8 @@ struct entity_info_t {
       size_t id_ = 0,
       size_t rank_ = 0,
       size_t offset_ = 0,
-      std::set<size_t> shared_ = {})
-      : id(id_), rank(rank_), offset(offset_), shared(shared_) {}
+      utils::flat_set__<size_t> shared_ = {})
+      : id(id_), rank(rank_), offset(offset_), shared(std::move(shared_)) {}
 
   /*!
    Comparison operator for container insertion. This sorts by the
@@ -79,10 +79,12 @@ public:
    Return information about entities that belong to other colors.
    */
 
-  virtual std::pair<std::vector<std::set<size_t>>, std::set<entity_info_t>>
+  virtual std::pair<
+      std::vector<utils::flat_set__<size_t>>,
+      utils::flat_set__<entity_info_t>>
   get_primary_info(
-      const std::set<size_t> & primary,
-      const std::set<size_t> & request_indices) = 0;
+      const utils::flat_set__<size_t> & primary,
+      const utils::flat_set__<size_t> & request_indices) = 0;
 
   /*!
    Get the 1-to-1 intersection between all colorings of the given set.
@@ -92,8 +94,8 @@ public:
            intersecting color.
    */
 
-  virtual std::unordered_map<size_t, std::set<size_t>>
-  get_intersection_info(const std::set<size_t> & request_indices) = 0;
+  virtual std::unordered_map<size_t, utils::flat_set__<size_t>>
+  get_intersection_info(const utils::flat_set__<size_t> & request_indices) = 0;
 
   /*!
    Return a map of the reduced index information across all colors.
@@ -101,8 +103,8 @@ public:
    @param local_indices The indices of the calling color.
    */
 
-  virtual std::unordered_map<size_t, std::set<size_t>>
-  get_entity_reduction(const std::set<size_t> & local_indices) = 0;
+  virtual std::unordered_map<size_t, utils::flat_set__<size_t>>
+  get_entity_reduction(const utils::flat_set__<size_t> & local_indices) = 0;
 
   //--------------------------------------------------------------------------//
   // Same admonishment as for get_primary_info...
@@ -114,9 +116,9 @@ public:
   /*!
    FIXME documantation
    */
-  virtual std::vector<std::set<size_t>> get_entity_info(
-      const std::set<entity_info_t> & entity_info,
-      const std::vector<std::set<size_t>> & request_indices) = 0;
+  virtual std::vector<utils::flat_set__<size_t>> get_entity_info(
+      const utils::flat_set__<entity_info_t> & entity_info,
+      const std::vector<utils::flat_set__<size_t>> & request_indices) = 0;
 
   /*!
    Return size across all colors.
@@ -75,15 +75,30 @@ operator<<(std::ostream & stream, const crs_t & crs) {
 /*!
  This type is a container for distrinuted compressed-storage of sparse data.
 
- @var distribution The index ranges for each color.
+ @var distribution    The index ranges for each color.
+ @var num_constraints The number of weights of each index.
+ @var vertex_weights  Optional weights of the local indices, i.e., the cost
+                      of each index for each constraint. If not empty, this
+                      holds num_constraints weights per index, stored
+                      contiguously for each index.
+ @var edge_weights    Optional weights of the local edges, e.g., the
+                      communication volume between two indices. If not
+                      empty, this is parallel to the indices.
+ @var ids             Optional ids of the local indices, e.g., the mesh ids
+                      of the entities of a coloring. If empty, the id of
+                      an index is the index itself.
 
  @ingroup coloring
  */
 
 struct dcrs_t : public crs_t {
   std::vector<size_t> distribution;
+  size_t num_constraints = 1;
+  std::vector<size_t> vertex_weights;
+  std::vector<size_t> edge_weights;
+  std::vector<size_t> ids;
 
-  define_as(distribution)
+  define_as(distribution) define_as(vertex_weights) define_as(edge_weights)
 
 }; // struct dcrs_t
 
@@ -100,6 +115,20 @@ operator<<(std::ostream & stream, const dcrs_t & dcrs) {
     stream << i << " ";
   } // for
 
+  if (!dcrs.vertex_weights.empty()) {
+    stream << std::endl << "vertex weights: ";
+    for (auto i : dcrs.vertex_weights) {
+      stream << i << " ";
+    } // for
+  } // if
+
+  if (!dcrs.edge_weights.empty()) {
+    stream << std::endl << "edge weights: ";
+    for (auto i : dcrs.edge_weights) {
+      stream << i << " ";
+    } // for
+  } // if
+
   return stream;
 } // operator <<
 
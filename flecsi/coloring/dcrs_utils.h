@@ -23,9 +23,15 @@
 
 #include <mpi.h>
 
-#include <map>
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
+#include <flecsi/coloring/coloring_types.h>
 #include <flecsi/coloring/crs.h>
+#include <flecsi/coloring/index_coloring.h>
+#include <flecsi/coloring/mpi_utils.h>
 #include <flecsi/topology/closure_utils.h>
 #include <flecsi/topology/mesh_definition.h>
 
@@ -143,56 +149,481 @@ make_dcrs(const typename topology::mesh_definition__<DIMENSION> & md) {
   // Set the first offset (always zero).
   dcrs.offsets.push_back(0);
 
-  // Add the graph adjacencies by getting the neighbors of each
-  // cell index
-  using cellid = size_t;
-  using vertexid = size_t;
-
-  // essentially vertex to cell and cell to cell through vertices
-  // connectivity.
-  std::map<vertexid, std::vector<cellid>> vertex2cells;
-  std::map<cellid, std::vector<cellid>> cell2cells;
-
-  // build global cell to cell through # of shared vertices connectivity
-  for (size_t cell(0); cell < md.num_entities(FROM_DIMENSION); ++cell) {
-    std::map<cellid, size_t> cell_counts;
-
-    for (auto vertex : md.entities(FROM_DIMENSION, 0, cell)) {
-      // build vertex to cell connectivity, O(n_cells * n_polygon_sides)
-      // of insert().
-      vertex2cells[vertex].push_back(cell);
-
-      // Count the number of times this cell shares a common vertex with
-      // some other cell. O(n_cells * n_polygon_sides * vertex to cells degrees)
-      for (auto other : vertex2cells[vertex]) {
-        if (other != cell)
-          cell_counts[other] += 1;
-      }
-    }
-
-    for (auto count : cell_counts) {
-      if (count.second > THRU_DIMENSION) {
-        // append cell to cell through "dimension" connectivity, we need to
-        // add both directions
-        cell2cells[cell].push_back(count.first);
-        cell2cells[count.first].push_back(cell);
-      }
-    }
-  }
+  // Cell to vertex connectivity and its transpose. The neighbors of a
+  // cell are found by visiting the cells that share one of its vertices.
+  const auto cell2vertices = md.entities_crs(FROM_DIMENSION, 0);
+  const auto vertex2cells =
+      topology::transpose(cell2vertices, md.num_entities(0));
+
+  std::vector<size_t> scratch;
+  std::vector<size_t> neighbors;
 
   // turn subset of cell 2 cell connectivity to dcrs
   for (size_t i(0); i < init_indices; ++i) {
     auto cell = dcrs.distribution[rank] + i;
 
-    for (auto n : cell2cells[cell]) {
-      dcrs.indices.push_back(n);
+    topology::crs_neighbors(
+        cell2vertices, vertex2cells.view(), cell, THRU_DIMENSION, scratch,
+        neighbors);
+
+    dcrs.indices.insert(
+        dcrs.indices.end(), neighbors.begin(), neighbors.end());
+    dcrs.offsets.push_back(dcrs.indices.size());
+  } // for
+
+  return dcrs;
+} // make_dcrs
+
+/*!
+ Create distributed CRS representation of the graph defined by entities
+ of FROM_DIMENSION to TO_DIMENSION through THRU_DIMENSION, distributed
+ according to an existing coloring of the entities, e.g., to repartition
+ the entities. The indices of each rank are its exclusive and shared
+ entities in local order, and the ids of the return object are their
+ mesh ids.
+
+ The offsets of the shared and ghost entities of the coloring must be
+ offsets within the shared range of the local order of their owner, as
+ in the colorings of the execution context. The neighbors of the
+ exclusive and shared entities must be exclusive, shared or ghost.
+
+ @param md            The mesh definition.
+ @param coloring      The index coloring of the entities.
+ @param coloring_info The coloring information of all colors.
+
+ @ingroup coloring
+ */
+
+template<
+    std::size_t DIMENSION,
+    std::size_t FROM_DIMENSION = DIMENSION,
+    std::size_t TO_DIMENSION = DIMENSION,
+    std::size_t THRU_DIMENSION = DIMENSION - 1>
+inline dcrs_t
+make_dcrs(
+    const typename topology::mesh_definition__<DIMENSION> & md,
+    const index_coloring_t & coloring,
+    const std::unordered_map<size_t, coloring_info_t> & coloring_info) {
+  int size;
+  int rank;
+
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  dcrs_t dcrs;
+  dcrs.distribution.push_back(0);
+
+  for (size_t r(0); r < size; ++r) {
+    const auto & ci = coloring_info.at(r);
+    dcrs.distribution.push_back(
+        dcrs.distribution[r] + ci.exclusive + ci.shared);
+  } // for
+
+  const size_t num_owned = coloring.exclusive.size() + coloring.shared.size();
+
+  // The index of each neighbor: the owned entities are numbered in local
+  // order, and the ghosts by the local order of their owner.
+  std::unordered_map<size_t, size_t> indices;
+  indices.reserve(num_owned + coloring.ghost.size());
+
+  const auto local_ids = coloring.local_ids();
+  for (size_t i(0); i < num_owned; ++i) {
+    indices[local_ids[i]] = dcrs.distribution[rank] + i;
+  } // for
+
+  for (const auto & g : coloring.ghost) {
+    indices[g.id] = dcrs.distribution[g.rank] +
+                    coloring_info.at(g.rank).exclusive + g.offset;
+  } // for
+
+  //--------------------------------------------------------------------------//
+  // Create the cell-to-cell graph.
+  //--------------------------------------------------------------------------//
+
+  dcrs.offsets.push_back(0);
+  dcrs.ids.assign(local_ids.begin(), local_ids.begin() + num_owned);
+
+  const auto cell2vertices = md.entities_crs(FROM_DIMENSION, 0);
+  const auto vertex2cells =
+      topology::transpose(cell2vertices, md.num_entities(0));
+
+  std::vector<size_t> scratch;
+  std::vector<size_t> neighbors;
+
+  for (size_t i(0); i < num_owned; ++i) {
+    topology::crs_neighbors(
+        cell2vertices, vertex2cells.view(), dcrs.ids[i], THRU_DIMENSION,
+        scratch, neighbors);
+
+    for (auto n : neighbors) {
+      auto itr = indices.find(n);
+      clog_assert(
+          itr != indices.end(), "neighbor " << n << " of entity "
+                                            << dcrs.ids[i]
+                                            << " is not in the coloring");
+      dcrs.indices.push_back(itr->second);
     } // for
 
-    dcrs.offsets.push_back(dcrs.offsets[i] + cell2cells[cell].size());
-  }
+    dcrs.offsets.push_back(dcrs.indices.size());
+  } // for
 
   return dcrs;
 } // make_dcrs
 
+namespace detail {
+
+/*!
+ Exchange variable-length blocks of size_t values between all ranks.
+
+ MPI counts and displacements are int, so the exchange is split into
+ rounds in which each rank sends at most \em limit / size values to every
+ other rank. Large exchanges therefore never overflow, and small ones take
+ a single MPI_Alltoallv directly on the given buffers.
+
+ @param send_buffer The values to send, grouped by destination rank.
+ @param send_counts The number of values for each rank.
+ @param limit       The maximum number of values that a rank sends or
+                    receives in one MPI_Alltoallv.
+
+ @return The received values, grouped by source rank.
+
+ @ingroup coloring
+ */
+
+inline std::vector<size_t>
+alltoallv(
+    const std::vector<size_t> & send_buffer,
+    const std::vector<size_t> & send_counts,
+    size_t limit = std::numeric_limits<int>::max()) {
+  const int size = send_counts.size();
+  const auto mpi_size_t_type = mpi_typetraits__<size_t>::type();
+
+  std::vector<size_t> recv_counts(size);
+  MPI_Alltoall(
+      send_counts.data(), 1, mpi_size_t_type, recv_counts.data(), 1,
+      mpi_size_t_type, MPI_COMM_WORLD);
+
+  std::vector<size_t> send_displs(size + 1, 0);
+  std::vector<size_t> recv_displs(size + 1, 0);
+
+  for (int r(0); r < size; ++r) {
+    send_displs[r + 1] = send_displs[r] + send_counts[r];
+    recv_displs[r + 1] = recv_displs[r] + recv_counts[r];
+  } // for
+
+  std::vector<size_t> recv_buffer(recv_displs[size]);
+
+  // The largest block sent between any two ranks sets the number of rounds.
+  const size_t chunk = std::max<size_t>(limit / size, 1);
+  size_t rounds =
+      (*std::max_element(send_counts.begin(), send_counts.end()) + chunk -
+          1) /
+      chunk;
+  MPI_Allreduce(
+      MPI_IN_PLACE, &rounds, 1, mpi_size_t_type, MPI_MAX, MPI_COMM_WORLD);
+
+  std::vector<int> round_send_counts(size);
+  std::vector<int> round_recv_counts(size);
+  std::vector<int> round_send_displs(size);
+  std::vector<int> round_recv_displs(size);
+
+  std::vector<size_t> round_send;
+  std::vector<size_t> round_recv;
+
+  // Return the part of a block of \em count values that is sent in the
+  // round starting at \em first.
+  auto part = [chunk](size_t count, size_t first) -> int {
+    return count > first ? std::min(count - first, chunk) : 0;
+  };
+
+  for (size_t round(0); round < rounds; ++round) {
+    const size_t first = round * chunk;
+
+    int send_total(0);
+    int recv_total(0);
+
+    for (int r(0); r < size; ++r) {
+      round_send_counts[r] = part(send_counts[r], first);
+      round_recv_counts[r] = part(recv_counts[r], first);
+      round_send_displs[r] = send_total;
+      round_recv_displs[r] = recv_total;
+      send_total += round_send_counts[r];
+      recv_total += round_recv_counts[r];
+    } // for
+
+    // A single round sends every block whole, so the buffers are used
+    // directly.
+    if (rounds == 1) {
+      MPI_Alltoallv(
+          send_buffer.data(), round_send_counts.data(),
+          round_send_displs.data(), mpi_size_t_type, recv_buffer.data(),
+          round_recv_counts.data(), round_recv_displs.data(),
+          mpi_size_t_type, MPI_COMM_WORLD);
+      break;
+    } // if
+
+    round_send.resize(send_total);
+    round_recv.resize(recv_total);
+
+    for (int r(0); r < size; ++r) {
+      std::copy_n(
+          send_buffer.begin() + send_displs[r] + first, round_send_counts[r],
+          round_send.begin() + round_send_displs[r]);
+    } // for
+
+    MPI_Alltoallv(
+        round_send.data(), round_send_counts.data(), round_send_displs.data(),
+        mpi_size_t_type, round_recv.data(), round_recv_counts.data(),
+        round_recv_displs.data(), mpi_size_t_type, MPI_COMM_WORLD);
+
+    for (int r(0); r < size; ++r) {
+      std::copy_n(
+          round_recv.begin() + round_recv_displs[r], round_recv_counts[r],
+          recv_buffer.begin() + recv_displs[r] + first);
+    } // for
+  } // for
+
+  return recv_buffer;
+} // alltoallv
+
+/*!
+ Group (key, value) pairs by key with a counting sort.
+
+ @param pairs     Interleaved (key, value) pairs.
+ @param num_keys  The number of distinct local keys.
+ @param local_key Maps a key to a local key in [0, num_keys).
+
+ @return For each local key, the values that were paired with it, in the
+         order in which they appear in \em pairs.
+
+ @ingroup coloring
+ */
+
+template<typename LOCAL_KEY>
+inline topology::crs_storage_t
+bucket(
+    const std::vector<size_t> & pairs,
+    size_t num_keys,
+    LOCAL_KEY && local_key) {
+  topology::crs_storage_t result;
+
+  result.offsets.assign(num_keys + 1, 0);
+  for (size_t i(0); i < pairs.size(); i += 2) {
+    ++result.offsets[local_key(pairs[i]) + 1];
+  } // for
+
+  for (size_t k(0); k < num_keys; ++k) {
+    result.offsets[k + 1] += result.offsets[k];
+  } // for
+
+  std::vector<size_t> fill(result.offsets.begin(), result.offsets.end() - 1);
+  result.indices.resize(pairs.size() / 2);
+
+  for (size_t i(0); i < pairs.size(); i += 2) {
+    result.indices[fill[local_key(pairs[i])]++] = pairs[i + 1];
+  } // for
+
+  return result;
+} // bucket
+
+} // namespace detail
+
+/*!
+ Create distributed CRS representation of the graph defined by entities
+ of FROM_DIMENSION to TO_DIMENSION through THRU_DIMENSION without building
+ any global connectivity.
+
+ This produces the same result as make_dcrs, but each rank only requests
+ the definitions of the entities in its own naive block, with a single
+ bulk entities_crs() call. Vertex-to-entity connectivity is assembled with
+ a rendezvous: every (vertex, entity) pair is sent to the rank that owns
+ the vertex (vertex id modulo the number of ranks), which then returns,
+ for each entity, the other entities that share the vertex.
+
+ Work per rank is proportional to the local entities and their neighbors.
+ For memory to be proportional as well, the definition must only load the
+ local block, e.g., a simple_definition_t constructed with the number of
+ ranks and this rank as the block (see topology::naive_block_range).
+
+ @tparam FROM_DIMENSION The topological dimension of the entity for which
+                        the partitioning is requested.
+ @tparam TO_DIMENSION   The topological dimension to search for neighbors.
+ @tparam THRU_DIMENSION The topological dimension through which the neighbor
+                        connection exists.
+
+ @param md The mesh definition.
+
+ @ingroup coloring
+ */
+
+template<
+    std::size_t DIMENSION,
+    std::size_t FROM_DIMENSION = DIMENSION,
+    std::size_t TO_DIMENSION = DIMENSION,
+    std::size_t THRU_DIMENSION = DIMENSION - 1>
+inline dcrs_t
+make_dcrs_distributed(
+    const typename topology::mesh_definition__<DIMENSION> & md) {
+  int size;
+  int rank;
+
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  //--------------------------------------------------------------------------//
+  // Create a naive initial distribution of the indices
+  //--------------------------------------------------------------------------//
+
+  const size_t num_entities = md.num_entities(FROM_DIMENSION);
+
+  dcrs_t dcrs;
+  dcrs.distribution.push_back(0);
+
+  for (int r(0); r < size; ++r) {
+    dcrs.distribution.push_back(
+        topology::naive_block_range(num_entities, size, r).second);
+  } // for
+
+  const size_t begin = dcrs.distribution[rank];
+  const size_t end = dcrs.distribution[rank + 1];
+
+  auto vertex_owner = [size](size_t vertex) { return vertex % size; };
+
+  auto entity_owner = [&dcrs](size_t entity) {
+    return std::upper_bound(
+               dcrs.distribution.begin(), dcrs.distribution.end(), entity) -
+           dcrs.distribution.begin() - 1;
+  };
+
+  //--------------------------------------------------------------------------//
+  // Read the definitions of the local block.
+  //--------------------------------------------------------------------------//
+
+  const auto entity_vertices =
+      md.entities_crs(FROM_DIMENSION, 0, begin, end);
+
+  //--------------------------------------------------------------------------//
+  // Send (vertex, entity) pairs to the vertex owners.
+  //--------------------------------------------------------------------------//
+
+  std::vector<size_t> send_counts(size, 0);
+
+  for (size_t e(0); e < end - begin; ++e) {
+    for (auto v : entity_vertices[e]) {
+      send_counts[vertex_owner(v)] += 2;
+    } // for
+  } // for
+
+  std::vector<size_t> send_buffer;
+
+  {
+    size_t total(0);
+    std::vector<size_t> fill(size, 0);
+
+    for (int r(0); r < size; ++r) {
+      fill[r] = total;
+      total += send_counts[r];
+    } // for
+
+    send_buffer.resize(total);
+
+    for (size_t e(begin); e < end; ++e) {
+      for (auto v : entity_vertices[e - begin]) {
+        auto & f = fill[vertex_owner(v)];
+        send_buffer[f++] = v;
+        send_buffer[f++] = e;
+      } // for
+    } // for
+  } // scope
+
+  auto recv_buffer = detail::alltoallv(send_buffer, send_counts);
+
+  //--------------------------------------------------------------------------//
+  // On the vertex owners, group the entities that reference each vertex,
+  // and return (entity, other) pairs to the owners of the entities.
+  //--------------------------------------------------------------------------//
+
+  // Owned vertices are v = rank + k * size, so k is a dense local index.
+  const size_t num_owned = (md.num_entities(0) + size - 1) / size;
+  const auto vertex_entities = detail::bucket(
+      recv_buffer, num_owned, [size](size_t vertex) { return vertex / size; });
+
+  // Visit each pair of distinct entities that share a vertex.
+  auto for_each_pair = [&vertex_entities, num_owned](auto && f) {
+    for (size_t k(0); k < num_owned; ++k) {
+      const auto entities = vertex_entities.view()[k];
+
+      for (auto a : entities) {
+        for (auto b : entities) {
+          if (a != b) {
+            f(a, b);
+          } // if
+        } // for
+      } // for
+    } // for
+  };
+
+  std::fill(send_counts.begin(), send_counts.end(), 0);
+
+  for_each_pair([&](size_t entity, size_t) {
+    send_counts[entity_owner(entity)] += 2;
+  });
+
+  {
+    size_t total(0);
+    std::vector<size_t> fill(size, 0);
+
+    for (int r(0); r < size; ++r) {
+      fill[r] = total;
+      total += send_counts[r];
+    } // for
+
+    send_buffer.resize(total);
+
+    for_each_pair([&](size_t entity, size_t other) {
+      auto & f = fill[entity_owner(entity)];
+      send_buffer[f++] = entity;
+      send_buffer[f++] = other;
+    });
+  } // scope
+
+  recv_buffer = detail::alltoallv(send_buffer, send_counts);
+  std::vector<size_t>().swap(send_buffer);
+
+  //--------------------------------------------------------------------------//
+  // Count the shared vertices for each (entity, other) pair and emit the
+  // dcrs rows.
+  //--------------------------------------------------------------------------//
+
+  auto shared =
+      detail::bucket(recv_buffer, end - begin, [begin](size_t entity) {
+        return entity - begin;
+      });
+
+  dcrs.offsets.push_back(0);
+
+  for (size_t e(0); e < end - begin; ++e) {
+    auto first = shared.indices.begin() + shared.offsets[e];
+    auto last = shared.indices.begin() + shared.offsets[e + 1];
+
+    // Each other entity appears once for every shared vertex.
+    std::sort(first, last);
+
+    while (first != last) {
+      auto next = std::upper_bound(first, last, *first);
+
+      if (next - first > THRU_DIMENSION) {
+        dcrs.indices.push_back(*first);
+      } // if
+
+      first = next;
+    } // while
+
+    dcrs.offsets.push_back(dcrs.indices.size());
+  } // for
+
+  return dcrs;
+} // make_dcrs_distributed
+
 } // namespace coloring
 } // namespace flecsi
@@ -35,20 +35,67 @@ struct index_coloring_t {
   //------------------------------------------------------------------------//
 
   // Set of mesh ids of the primary coloring
-  std::set<size_t> primary;
+  utils::flat_set__<size_t> primary;
 
   // Set of entity_info_t type of the exclusive coloring
-  std::set<entity_info_t> exclusive;
+  utils::flat_set__<entity_info_t> exclusive;
 
   // Set of entity_info_t type of the shared coloring
-  std::set<entity_info_t> shared;
+  utils::flat_set__<entity_info_t> shared;
 
   // Set of entity_info_t type of the ghost coloring
-  std::set<entity_info_t> ghost;
+  utils::flat_set__<entity_info_t> ghost;
 
   // Rank id to number of entities
   std::unordered_map<size_t, size_t> entities_per_rank;
 
+  // Mesh ids in local order, i.e., the exclusive, shared and ghost ids,
+  // each permuted within its range. If empty, each range is ordered by id.
+  // See coloring/reorder_utils.h.
+  std::vector<size_t> order;
+
+  /*!
+   Return the mesh ids in local order.
+   */
+  std::vector<size_t> local_ids() const {
+    if (!order.empty()) {
+      return order;
+    } // if
+
+    std::vector<size_t> ids;
+    ids.reserve(exclusive.size() + shared.size() + ghost.size());
+
+    for (auto range : {&exclusive, &shared, &ghost}) {
+      for (const auto & e : *range) {
+        ids.push_back(e.id);
+      } // for
+    } // for
+
+    return ids;
+  } // local_ids
+
+  /*!
+   Return a map from mesh id to the offset of the entity within its range
+   (exclusive, shared or ghost) of the local order.
+   */
+  std::unordered_map<size_t, size_t> local_offsets() const {
+    const auto ids = local_ids();
+    const size_t shared_start = exclusive.size();
+    const size_t ghost_start = shared_start + shared.size();
+
+    assert(ids.size() == ghost_start + ghost.size());
+
+    std::unordered_map<size_t, size_t> offsets;
+    offsets.reserve(ids.size());
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+      offsets[ids[i]] = i < shared_start
+        ? i : i < ghost_start ? i - shared_start : i - ghost_start;
+    } // for
+
+    return offsets;
+  } // local_offsets
+
   /*!
    Equality operator.
 
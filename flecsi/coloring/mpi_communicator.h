@@ -21,6 +21,12 @@
 #error FLECSI_ENABLE_MPI not defined! This file depends on MPI!
 #endif
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
 #include <mpi.h>
 
 #include <flecsi/coloring/communicator.h>
@@ -38,8 +44,10 @@ namespace coloring {
 
 class mpi_communicator_t : public communicator_t {
 public:
-  /// Default constructor
-  mpi_communicator_t() {}
+  /// Default constructor (collective: duplicates MPI_COMM_WORLD)
+  mpi_communicator_t() {
+    MPI_Comm_dup(MPI_COMM_WORLD, &comm_);
+  }
 
   /// Copy constructor (disabled)
   mpi_communicator_t(const mpi_communicator_t &) = delete;
@@ -48,7 +56,14 @@ public:
   mpi_communicator_t & operator=(const mpi_communicator_t &) = delete;
 
   /// Destructor
-  ~mpi_communicator_t() {}
+  ~mpi_communicator_t() {
+    int finalized;
+    MPI_Finalized(&finalized);
+
+    if (!finalized) {
+      MPI_Comm_free(&comm_);
+    } // if
+  }
 
   /*!
    Return the size of the communicatora
@@ -72,265 +87,164 @@ public:
     return rk;
   }
 
-  /*!
-   Reduces info_indices from all MPI ranks
-
-   @param request_indices  std::set of shared, ghost etc
-   @param max_request_indices Maximum # of indices per rank
-   @param colors Number of MPI ranks
-
-   @return std::vector vith the infirmation for the info_indices from all
-           MPI ranks
-
-   @ingroup coloring
-   */
-
-  std::vector<size_t> get_info_indices(
-      const std::set<size_t> & request_indices,
-      size_t max_request_indices,
-      int colors) {
-    // Pad the request indices with size_t max. We will then set
-    // the indices of the actual request. Each rank that receives
-    // the request will try to provide information about the
-    // non size_t max values in the request. The others will
-    // be ignored.
-    std::vector<size_t> input_indices(
-        colors * max_request_indices, std::numeric_limits<size_t>::max());
-    std::vector<size_t> info_indices(colors * max_request_indices);
-
-    for (size_t c(0); c < colors; ++c) {
-      size_t off(0);
-      const size_t coff = c * max_request_indices;
-
-      for (auto s : request_indices) {
-        input_indices[coff + off++] = s;
-      } // for
-    } // for
-
-    const auto mpi_size_t_type =
-        flecsi::coloring::mpi_typetraits__<size_t>::type();
-
-    // Send the request indices to all other ranks.
-    int result = MPI_Alltoall(
-        &input_indices[0], max_request_indices, mpi_size_t_type,
-        &info_indices[0], max_request_indices, mpi_size_t_type, MPI_COMM_WORLD);
-
-    return info_indices;
-  } // get_info_indices
-
   /*!
    Rerturn a set containing the entity_info_t information for each
    member of the input set request_indices (from other ranks) and
    the information for the local indices in primary.
 
-   @param FIXME
+   The owners of the requested indices are found through a directory
+   distributed over the ranks (see directory_rank()): the owners register
+   their primary indices with the directory, which answers the requests
+   and tells the owners which ranks requested their indices. The memory
+   and message volume are proportional to the number of indices, and the
+   messages only go to ranks with data to exchange.
+
+   @param primary         The indices owned by the calling color.
+   @param request_indices The indices for which to find the owner.
 
-   @return FIXME
+   @return A pair of the ranks other than the calling color that requested
+           each primary index, in the order of primary, and the
+           entity_info_t information of the requested indices that are
+           owned by other ranks.
 
    @ingroup coloring
   */
 
-  std::pair<std::vector<std::set<size_t>>, std::set<entity_info_t>>
+  std::pair<
+      std::vector<utils::flat_set__<size_t>>,
+      utils::flat_set__<entity_info_t>>
   get_primary_info(
-      const std::set<size_t> & primary,
-      const std::set<size_t> & request_indices) override {
+      const utils::flat_set__<size_t> & primary,
+      const utils::flat_set__<size_t> & request_indices) override {
     auto colors = size();
-    auto color = rank();
-
-    // Store the request in a vector for indexed access below.
-    std::vector<size_t> request_indices_vector(
-        request_indices.begin(), request_indices.end());
 
-    const auto mpi_size_t_type =
-        flecsi::coloring::mpi_typetraits__<size_t>::type();
+    // Register the primary indices and their offsets with the directory.
+    buffers_t sends;
+    size_t offset(0);
+    for (auto i : primary) {
+      auto & buffer = sends[directory_rank(i, colors)];
+      buffer.push_back(i);
+      buffer.push_back(offset++);
+    } // for
 
-    size_t max_request_indices = get_max_request_size(request_indices.size());
-
-    // Pad the request indices with size_t max. We will then set
-    // the indices of the actual request. Each rank that receives
-    // the request will try to provide information about the
-    // non size_t max values in the request. The others will
-    // be ignored.
-    std::vector<size_t> input_indices(
-        colors * max_request_indices, std::numeric_limits<size_t>::max());
-    std::vector<size_t> info_indices(colors * max_request_indices);
-    info_indices =
-        get_info_indices(request_indices, max_request_indices, colors);
-
-    // For now, we need two arrays for each all-to-all communication:
-    // One for rank ownership of the request indices, and one
-    // for the offsets. We could probably combine these. However,
-    // we would probably have to define a custom MPI type. It
-    // will only be worth the effort if this appraoch is slow.
-    // The input offsets do not need to be initialized because
-    // the information is available in the input_indices array.
-    std::vector<size_t> input_offsets(colors * max_request_indices);
-    std::vector<size_t> info_offsets(colors * max_request_indices);
-
-    // Reset input indices to use to send back information
-    std::fill(
-        input_indices.begin(), input_indices.end(),
-        std::numeric_limits<size_t>::max());
-
-    // For the primary coloring, provide rank and entity information
-    // on indices that are shared with other processes.
-    std::vector<std::set<size_t>> local(primary.size());
-
-    // See if we can fill any requests...
-    for (size_t r(0); r < colors; ++r) {
+    std::unordered_map<size_t, std::pair<size_t, size_t>> directory;
+    for (auto & r : sparse_exchange(sends)) {
+      for (size_t i(0); i < r.second.size(); i += 2) {
+        directory[r.second[i]] = {r.first, r.second[i + 1]};
+      } // for
+    } // for
 
-      // Ignore our rank
-      if (r == color) {
-        continue;
-      } // if
+    // Send the requests to the directory.
+    sends.clear();
+    for (auto i : request_indices) {
+      sends[directory_rank(i, colors)].push_back(i);
+    } // for
 
-      // These array slices are just for convenience.
-      size_t * info = &info_indices[r * max_request_indices];
-      size_t * offset = &input_offsets[r * max_request_indices];
-      size_t * input = &input_indices[r * max_request_indices];
+    auto requests = sparse_exchange(sends);
 
-      // See which requests we can fulfill.
-      for (size_t i(0); i < max_request_indices; ++i) {
+    // Answer the requests with the rank (ownership) and offset, and
+    // register with the owner that the index is shared with the
+    // requesting rank. A rank's own indices are neither.
+    buffers_t answers;
+    buffers_t shared;
+    for (auto & r : requests) {
+      for (auto i : r.second) {
+        auto match = directory.find(i);
 
-        auto match = primary.find(info[i]);
+        if (match == directory.end() || match->second.first == r.first) {
+          continue;
+        } // if
 
-        if (match != primary.end()) {
-          // This is a match, i.e., we own this entity, so we can
-          // set the rank (ownership) and offset.
-          input[i] = color;
-          offset[i] = std::distance(primary.begin(), match);
+        const size_t owner = match->second.first;
+        const size_t owner_offset = match->second.second;
 
-          // We also need to register that this index is shared
-          // with other ranks
-          local[offset[i]].insert(r);
-        } // if
+        answers[r.first].insert(
+            answers[r.first].end(), {i, owner, owner_offset});
+        shared[owner].insert(shared[owner].end(), {owner_offset, r.first});
       } // for
     } // for
 
-    // Send the indices information back to all ranks.
-    int result = MPI_Alltoall(
-        &input_indices[0], max_request_indices, mpi_size_t_type,
-        &info_indices[0], max_request_indices, mpi_size_t_type, MPI_COMM_WORLD);
-
-    // Send the offsets information back to all ranks.
-    result = MPI_Alltoall(
-        &input_offsets[0], max_request_indices, mpi_size_t_type,
-        &info_offsets[0], max_request_indices, mpi_size_t_type, MPI_COMM_WORLD);
-
-    std::set<entity_info_t> remote;
-
-    // Collect all of the information for the remote entities.
-    for (size_t r(0); r < colors; ++r) {
-      // Skip these (we already know them!)
-      if (r == color) {
-        continue;
-      } // if
-
-      // Another slice for convenience.
-      size_t * ranks = &info_indices[r * max_request_indices];
-      size_t * offsets = &info_offsets[r * max_request_indices];
-
-      for (size_t i(0); i < max_request_indices; ++i) {
+    std::vector<entity_info_t> remote;
+    for (auto & r : sparse_exchange(answers)) {
+      for (size_t i(0); i < r.second.size(); i += 3) {
+        remote.emplace_back(r.second[i], r.second[i + 1], r.second[i + 2]);
+      } // for
+    } // for
 
-        if (ranks[i] != std::numeric_limits<size_t>::max()) {
-          // If this is not size_t max, this rank answered our request
-          // and we can set the information.
-          remote.insert(entity_info_t(
-              request_indices_vector[i], ranks[i], offsets[i], {}));
-        } // if
+    std::vector<utils::flat_set__<size_t>> local(primary.size());
+    for (auto & r : sparse_exchange(shared)) {
+      for (size_t i(0); i < r.second.size(); i += 2) {
+        local[r.second[i]].insert(r.second[i + 1]);
       } // for
     } // for
 
-    return std::make_pair(local, remote);
+    return std::make_pair(
+        std::move(local), utils::flat_set__<entity_info_t>(std::move(remote)));
   } // get_primary_info
 
   /*!
-   Rerturn FIXME
+   Rerturn the indices that the calling color has in common with each
+   other color. The indices meet at their directory rank (see
+   directory_rank()), which sends each requesting rank the other ranks
+   that requested the same indices.
 
-   @param request_indices FIXME...
-                          information.
-   @return A std::unordered_map<size_t, std::set<size_t>> FIXME ...
+   @param request_indices The indices of the calling color.
+   @return A std::unordered_map<size_t, utils::flat_set__<size_t>> with an
+           entry for each other color with a non-empty intersection.
 
    @ingroup coloring
   */
 
-  std::unordered_map<size_t, std::set<size_t>>
-  get_intersection_info(const std::set<size_t> & request_indices) override {
+  std::unordered_map<size_t, utils::flat_set__<size_t>>
+  get_intersection_info(
+      const utils::flat_set__<size_t> & request_indices) override {
     auto colors = size();
-    auto color = rank();
 
-    // Store the request in a vector for indexed access below.
-    std::vector<size_t> request_indices_vector(
-        request_indices.begin(), request_indices.end());
+    buffers_t sends;
+    for (auto i : request_indices) {
+      sends[directory_rank(i, colors)].push_back(i);
+    } // for
 
-    const auto mpi_size_t_type =
-        flecsi::coloring::mpi_typetraits__<size_t>::type();
+    // The ranks that requested each index.
+    std::unordered_map<size_t, std::vector<size_t>> requesters;
+    for (auto & r : sparse_exchange(sends)) {
+      for (auto i : r.second) {
+        requesters[i].push_back(r.first);
+      } // for
+    } // for
 
-    size_t max_request_indices = get_max_request_size(request_indices.size());
+    buffers_t answers;
+    for (auto & i : requesters) {
+      for (auto r : i.second) {
+        for (auto s : i.second) {
+          if (r != s) {
+            answers[r].insert(answers[r].end(), {i.first, s});
+          } // if
+        } // for
+      } // for
+    } // for
 
-    // Pad the request indices with size_t max. We will then set
-    // the indices of the actual request. Each rank that receives
-    // the request will try to provide information about the
-    // non size_t max values in the request. The others will
-    // be ignored.
-    std::vector<size_t> input_indices(
-        colors * max_request_indices, std::numeric_limits<size_t>::max());
-    std::vector<size_t> info_indices(colors * max_request_indices);
-    info_indices =
-        get_info_indices(request_indices, max_request_indices, colors);
+    std::unordered_map<size_t, std::vector<size_t>> intersections;
+    for (auto & r : sparse_exchange(answers)) {
+      for (size_t i(0); i < r.second.size(); i += 2) {
+        intersections[r.second[i + 1]].push_back(r.second[i]);
+      } // for
+    } // for
 
-    // Reset input indices to use to send back information
-    std::fill(
-        input_indices.begin(), input_indices.end(),
-        std::numeric_limits<size_t>::max());
+    std::unordered_map<size_t, utils::flat_set__<size_t>> intersection_map;
+    for (auto & i : intersections) {
+      intersection_map.emplace(
+          i.first, utils::flat_set__<size_t>(std::move(i.second)));
+    } // for
 
     {
       clog_tag_guard(mpi_communicator);
-      clog_container_one(info, "input_indices", info_indices, clog::space);
-    }
-
-    //
-    std::unordered_map<size_t, std::set<size_t>> intersection_map;
-
-    for (size_t r(0); r < colors; ++r) {
-
-      // Ignore our rank
-      if (r == color) {
-        continue;
-      } // if
-
-      // Array slice for convenience.
-      size_t * info = &info_indices[r * max_request_indices];
-
-      // Create a set of the off-color request indices.
-      std::set<size_t> intersection_set;
-      for (size_t i(0); i < max_request_indices; ++i) {
-        if (info[i] != std::numeric_limits<size_t>::max()) {
-          intersection_set.insert(info[i]);
-        } // if
-      } // for
-
-      {
-        clog_tag_guard(mpi_communicator);
+      for (auto & i : intersection_map) {
         clog_container_one(
-            info, "intersection_set", intersection_set, clog::space);
-      }
-
-      // Compute the intersection
-      auto intersection =
-          flecsi::utils::set_intersection(intersection_set, request_indices);
-
-      {
-        clog_tag_guard(mpi_communicator);
-        clog_container_one(
-            info, "rank " << r << " intersection", intersection, clog::space);
-      }
-
-      // If the intersection is non-empty, add it to the return map
-      if (intersection.size()) {
-        intersection_map[r] = intersection;
-      } // if
-    } // for
+            info, "rank " << i.first << " intersection", i.second,
+            clog::space);
+      } // for
+    }
 
     return intersection_map;
   } // get_intersection_info
@@ -340,38 +254,25 @@ public:
 
    @param local_indices The indices of the calling color.
 
-   @return A std::unordered_map<size_t, std::set<size_t>> containing the
-           indices of each rank for the given index space.
+   @return A std::unordered_map<size_t, utils::flat_set__<size_t>>
+           containing the indices of each rank for the given index space.
 
    @ingroup coloring
    */
 
-  std::unordered_map<size_t, std::set<size_t>>
-  get_entity_reduction(const std::set<size_t> & local_indices) override {
+  std::unordered_map<size_t, utils::flat_set__<size_t>>
+  get_entity_reduction(
+      const utils::flat_set__<size_t> & local_indices) override {
     auto colors = size();
-    auto color = rank();
-
-    size_t max_request_indices = get_max_request_size(local_indices.size());
 
-    auto info_indices =
-        get_info_indices(local_indices, max_request_indices, colors);
+    auto indices = allgather_indices(local_indices);
 
-    std::unordered_map<size_t, std::set<size_t>> entity_reduction_map;
+    std::unordered_map<size_t, utils::flat_set__<size_t>> entity_reduction_map;
 
     for (size_t c(0); c < colors; ++c) {
-
-      // Array slice for convenience.
-      size_t * info = &info_indices[c * max_request_indices];
-
-      // Create a set of the off-color request indices.
-      std::set<size_t> reduction_set;
-      for (size_t i(0); i < max_request_indices; ++i) {
-        if (info[i] != std::numeric_limits<size_t>::max()) {
-          reduction_set.insert(info[i]);
-        } // if
-      } // for
-
-      entity_reduction_map[c] = reduction_set;
+      entity_reduction_map[c] = utils::flat_set__<size_t>(
+          indices.begin() + indices.offset(c),
+          indices.begin() + indices.offset(c + 1));
     } // for
 
     return entity_reduction_map;
@@ -381,117 +282,46 @@ public:
    Return a set containing the entity_info_t information for each
    member of the input set request_indices (from other ranks).
 
-   @param entity_info FIXME...
+   @param entity_info The entity_info_t information of the indices of
+                      the calling color.
    @param request_indices A set of entity ids for which to return
-                          information.
-   @return A std::vector<std::set<size_t>> containing the offset
+                          information, for each rank.
+   @return A std::vector<utils::flat_set__<size_t>> containing the offset
            information for the requested indices.
 
    @ingroup coloring
    */
 
-  std::vector<std::set<size_t>> get_entity_info(
-      const std::set<entity_info_t> & entity_info,
-      const std::vector<std::set<size_t>> & request_indices) override {
+  std::vector<utils::flat_set__<size_t>> get_entity_info(
+      const utils::flat_set__<entity_info_t> & entity_info,
+      const std::vector<utils::flat_set__<size_t>> & request_indices)
+      override {
     auto colors = size();
-    auto color = rank();
 
-    // Collect the size of each rank request to send.
-    std::vector<size_t> send_cnts(colors, 0);
+    // Send the requests, only to the ranks that we request indices from.
+    buffers_t sends;
     for (size_t r(0); r < colors; ++r) {
-      send_cnts[r] = request_indices[r].size();
-    } // for
-
-    // Send the request size (in indices) to each rank.
-    std::vector<size_t> recv_cnts(colors);
-    int result = MPI_Alltoall(
-        &send_cnts[0], 1, mpi_typetraits__<size_t>::type(), &recv_cnts[0], 1,
-        mpi_typetraits__<size_t>::type(), MPI_COMM_WORLD);
-
-    // Start receive operations (non-blocking).
-    std::vector<std::vector<size_t>> rbuffers(colors);
-    std::vector<MPI_Request> requests;
-    for (size_t r(0); r < colors; ++r) {
-      if (recv_cnts[r]) {
-        rbuffers[r].resize(recv_cnts[r]);
-        requests.push_back({});
-        MPI_Irecv(
-            &rbuffers[r][0], recv_cnts[r], mpi_typetraits__<size_t>::type(), r,
-            0, MPI_COMM_WORLD, &requests[requests.size() - 1]);
-      } // if
-    } // for
-
-    // Start send operations (blocking is ok here).
-    std::vector<std::vector<size_t>> sbuffers(colors);
-    for (size_t r(0); r < colors; ++r) {
-      if (send_cnts[r]) {
-        std::copy(
-            request_indices[r].begin(), request_indices[r].end(),
-            std::back_inserter(sbuffers[r]));
-
-        MPI_Send(
-            &sbuffers[r][0], send_cnts[r], mpi_typetraits__<size_t>::type(), r,
-            0, MPI_COMM_WORLD);
+      if (request_indices[r].size()) {
+        sends[r].assign(request_indices[r].begin(), request_indices[r].end());
       } // if
     } // for
 
-    // Create a map version of the entity info for lookups below.
-    std::unordered_map<size_t, entity_info_t> entity_info_map;
-    for (auto i : entity_info) {
-      entity_info_map[i.id] = i;
-    } // for
-
-    // Wait on the receive operations
-    std::vector<MPI_Status> status(requests.size());
-    MPI_Waitall(requests.size(), &requests[0], &status[0]);
+    auto requests = sparse_exchange(sends);
 
-    // Set the offsets for each requested index in the send buffer.
-    for (size_t r(0); r < colors; ++r) {
-      sbuffers[r].resize(rbuffers[r].size());
-
-      size_t offset(0);
-      for (auto i : rbuffers[r]) {
-        sbuffers[r][offset++] = entity_info_map[i].offset;
+    // Answer with the offset of each requested index. The entity info is
+    // sorted by id, so it is searched in place.
+    buffers_t answers;
+    for (auto & r : requests) {
+      auto & answer = answers[r.first];
+      for (auto i : r.second) {
+        auto match = entity_info.find(entity_info_t(i));
+        answer.push_back(match != entity_info.end() ? match->offset : 0);
       } // for
     } // for
 
-    // we are reusing requests in the following code, need to clear the content
-    // first.
-    requests.clear();
-
-    // Start receive operations (non-blocking) to get back the
-    // offsets we requested.
-    for (size_t r(0); r < colors; ++r) {
-      // If we sent a request, prepare to receive an answer.
-      if (send_cnts[r]) {
-        // We're done with our receive buffers, so we can re-use them.
-        rbuffers[r].resize(send_cnts[r], 0);
-        requests.push_back({});
-        MPI_Irecv(
-            &rbuffers[r][0], send_cnts[r], mpi_typetraits__<size_t>::type(), r,
-            0, MPI_COMM_WORLD, &requests[requests.size() - 1]);
-      } // if
-    } // for
-
-    // Start send operations (blocking is probably ok here).
-    for (size_t r(0); r < colors; ++r) {
-      // If we received a request, prepare to send an answer.
-      if (recv_cnts[r]) {
-        MPI_Send(
-            &sbuffers[r][0], recv_cnts[r], mpi_typetraits__<size_t>::type(), r,
-            0, MPI_COMM_WORLD);
-      } // if
-    } // for
-
-    // Wait on the receive operations
-    status.resize(requests.size());
-    MPI_Waitall(requests.size(), &requests[0], &status[0]);
-
-    std::vector<std::set<size_t>> remote(colors);
-    for (size_t r(0); r < colors; ++r) {
-      for (size_t i(0); i < send_cnts[r]; ++i) {
-        remote[r].insert(rbuffers[r][i]);
-      } // for
+    std::vector<utils::flat_set__<size_t>> remote(colors);
+    for (auto & r : sparse_exchange(answers)) {
+      remote[r.first].insert(r.second.begin(), r.second.end());
     } // for
 
     return remote;
@@ -537,31 +367,15 @@ public:
 
   template<typename Lambda>
   void alltoall_coloring_info(
-      std::set<size_t> & request_indices,
+      const utils::flat_set__<size_t> & request_indices,
       Lambda && function) {
     auto colors = size();
-    auto color = rank();
 
-    size_t max_request_indices = get_max_request_size(request_indices.size());
-
-    // Pad the request indices with size_t max. We will then set
-    // the indices of the actual request. Each rank that receives
-    // the request will try to provide information about the
-    // non size_t max values in the request. The others will
-    // be ignored.
-    std::vector<size_t> info_indices(colors * max_request_indices);
-    info_indices =
-        get_info_indices(request_indices, max_request_indices, colors);
+    auto indices = allgather_indices(request_indices);
 
     for (size_t c(0); c < colors; ++c) {
-
-      size_t * info = &info_indices[c * max_request_indices];
-
-      for (size_t i(0); i < max_request_indices; ++i) {
-        if (info[i] != std::numeric_limits<size_t>::max()) {
-          const size_t value = info[i];
-          function(c, value);
-        } // if
+      for (size_t i(indices.offset(c)); i < indices.offset(c + 1); ++i) {
+        function(c, indices[i]);
       } // for
     } // for
 
@@ -612,34 +426,177 @@ public:
     return coloring_info;
   } // gather_coloring_info
 
-  /*!
-   Find maximum size for the "requested_indicies" - MPI reduction
+private:
 
-   @param request_indices request_indices for local MPI rank
+  //! Buffers of indices, keyed by rank.
+  using buffers_t = std::map<size_t, std::vector<size_t>>;
 
-   @return max_request_indices Maximum size for the "requested_indicies"
+  //! The indices of all ranks, stored contiguously in rank order.
+  struct gathered_indices_t : public std::vector<size_t> {
+    //! The position of the first index of a rank, for rank in [0, colors].
+    size_t offset(size_t rank) const {
+      return offsets[rank];
+    }
 
-   @ingroup coloring
+    std::vector<size_t> offsets;
+  }; // struct gathered_indices_t
+
+  /*!
+   Return the rank of the directory that holds the information about an
+   index: the indices are dealt to the ranks in turn.
    */
 
-  size_t get_max_request_size(size_t request_indices) {
-    size_t max_request_indices = 0;
+  static size_t directory_rank(size_t index, size_t colors) {
+    return index % colors;
+  } // directory_rank
+
+  /*!
+   Gather the indices of all ranks, in a buffer of the exact total size.
+   MPI counts and displacements are ints, so if the total exceeds INT_MAX,
+   each rank broadcasts its indices in turn, in chunks of at most INT_MAX.
+   */
 
-    // Get a valid MPI type for size_t.
+  gathered_indices_t
+  allgather_indices(const utils::flat_set__<size_t> & indices) {
     const auto mpi_size_t_type =
         flecsi::coloring::mpi_typetraits__<size_t>::type();
 
-    // This may be inefficient, but this call is doing a reduction
-    // to determine the maximum number of indices requested by any rank
-    // so that we can pad out the all-to-all communication below.
-    int result = MPI_Allreduce(
-        &request_indices, &max_request_indices, 1, mpi_size_t_type, MPI_MAX,
-        MPI_COMM_WORLD);
+    const auto & send = indices.values();
+    auto sizes = gather_sizes(send.size());
 
-    return max_request_indices;
-  } // get_max_request_size
+    gathered_indices_t gathered;
+    gathered.offsets.resize(sizes.size() + 1, 0);
+
+    for (size_t r(0); r < sizes.size(); ++r) {
+      gathered.offsets[r + 1] = gathered.offsets[r] + sizes[r];
+    } // for
+
+    gathered.resize(gathered.offsets.back());
+
+    constexpr size_t max_count = std::numeric_limits<int>::max();
+
+    if (gathered.size() <= max_count) {
+      std::vector<int> counts(sizes.size());
+      std::vector<int> displs(sizes.size());
+
+      for (size_t r(0); r < sizes.size(); ++r) {
+        counts[r] = sizes[r];
+        displs[r] = gathered.offsets[r];
+      } // for
+
+      MPI_Allgatherv(
+          send.data(), send.size(), mpi_size_t_type, gathered.data(),
+          counts.data(), displs.data(), mpi_size_t_type, MPI_COMM_WORLD);
+
+      return gathered;
+    } // if
+
+    const size_t color = rank();
+
+    for (size_t r(0); r < sizes.size(); ++r) {
+      size_t * data = gathered.data() + gathered.offset(r);
+
+      if (r == color) {
+        std::copy(send.begin(), send.end(), data);
+      } // if
+
+      for (size_t i(0); i < sizes[r]; i += max_count) {
+        MPI_Bcast(data + i, std::min(sizes[r] - i, max_count),
+            mpi_size_t_type, r, MPI_COMM_WORLD);
+      } // for
+    } // for
+
+    return gathered;
+  } // allgather_indices
+
+  /*!
+   Sparse personalized exchange: send each buffer to its rank, and return
+   the buffers received, keyed by source rank. The ranks that send to the
+   calling rank need not be known in advance: the exchange terminates by a
+   non-blocking consensus (NBX, Hoefler et al., 2010). Each rank sends
+   synchronous messages, and enters a non-blocking barrier once all of
+   them have been received, while it keeps receiving messages; when the
+   barrier completes, all messages have been received. This is a
+   collective operation.
+   */
+
+  buffers_t sparse_exchange(const buffers_t & sends) {
+    const auto mpi_size_t_type =
+        flecsi::coloring::mpi_typetraits__<size_t>::type();
+    const size_t color = rank();
+
+    // A rank can only leave an exchange after all ranks have entered its
+    // barrier, so the messages of at most two consecutive exchanges on
+    // this communicator can be in flight, which alternate between two tags.
+    const int tag = sparse_exchange_tag + exchanges_++ % 2;
+
+    buffers_t recvs;
+    std::vector<MPI_Request> requests;
+    requests.reserve(sends.size());
+
+    for (auto & s : sends) {
+      if (s.second.empty()) {
+        continue;
+      } // if
+
+      if (s.first == color) {
+        recvs[color] = s.second;
+        continue;
+      } // if
+
+      requests.push_back({});
+      MPI_Issend(
+          const_cast<size_t *>(s.second.data()), s.second.size(),
+          mpi_size_t_type, s.first, tag, comm_, &requests.back());
+    } // for
+
+    MPI_Request barrier;
+    bool barrier_started = false;
+    int done = 0;
+
+    while (!done) {
+      int flag;
+      MPI_Status status;
+      MPI_Iprobe(MPI_ANY_SOURCE, tag, comm_, &flag, &status);
+
+      if (flag) {
+        int count;
+        MPI_Get_count(&status, mpi_size_t_type, &count);
+
+        auto & buffer = recvs[status.MPI_SOURCE];
+        buffer.resize(count);
+        MPI_Recv(
+            buffer.data(), count, mpi_size_t_type, status.MPI_SOURCE, tag,
+            comm_, MPI_STATUS_IGNORE);
+      } // if
+
+      if (barrier_started) {
+        MPI_Test(&barrier, &done, MPI_STATUS_IGNORE);
+      } else {
+        int sent;
+        MPI_Testall(
+            requests.size(), requests.data(), &sent, MPI_STATUSES_IGNORE);
+
+        if (sent) {
+          MPI_Ibarrier(comm_, &barrier);
+          barrier_started = true;
+        } // if
+      } // if
+    } // while
+
+    return recvs;
+  } // sparse_exchange
+
+  static constexpr int sparse_exchange_tag = 1024;
+
+  // The communicator of the sparse exchanges. It is a duplicate of
+  // MPI_COMM_WORLD, so that these messages cannot match receives posted
+  // by other code, and other messages cannot match its probes.
+  MPI_Comm comm_ = MPI_COMM_NULL;
+
+  // The number of sparse exchanges on comm_, which selects their tag.
+  size_t exchanges_ = 0;
 
-private:
 }; // class mpi_communicator_t
 
 } // namespace coloring
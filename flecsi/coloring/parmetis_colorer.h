@@ -15,7 +15,10 @@
 
 /*! @file */
 
+#include <algorithm>
+#include <limits>
 #include <set>
+#include <vector>
 
 #include <cinchlog.h>
 
@@ -40,9 +43,31 @@ namespace coloring {
 
 struct parmetis_colorer_t : public colorer_t {
   /*!
-   Default constructor
+   Constructor.
+
+   @param target_weights      The fraction of the total weight that each
+                              color should receive, either one value per
+                              color, or one value per color and constraint,
+                              stored contiguously for each color. The
+                              fractions are normalized for each constraint.
+                              If empty, the weight is evenly distributed.
+   @param imbalance_tolerance The allowed load imbalance, either one value,
+                              or one value per constraint.
+   @param redistribution_cost The cost of the communication during the
+                              computation, relative to the cost of moving
+                              the data to other colors, for repartition:
+                              larger values favor a smaller edgecut over
+                              less data movement (see the itr parameter
+                              of ParMETIS_V3_AdaptiveRepart).
    */
-  parmetis_colorer_t() {}
+
+  parmetis_colorer_t(
+      std::vector<double> target_weights = {},
+      std::vector<double> imbalance_tolerance = {1.05},
+      double redistribution_cost = 1000.0)
+      : target_weights_(std::move(target_weights)),
+        imbalance_tolerance_(std::move(imbalance_tolerance)),
+        redistribution_cost_(redistribution_cost) {}
 
   /*!
    Copy constructor (disabled)
@@ -61,42 +86,19 @@ struct parmetis_colorer_t : public colorer_t {
 
   /*!
    Implementation of color method. See \ref colorer_t::color.
+
+   The vertex and edge weights of the dCRS, if any, are passed to
+   ParMETIS, which balances the weight of each constraint over the
+   colors, according to the target weights, while minimizing the
+   weighted edgecut.
    */
 
   std::set<size_t> color(const dcrs_t & dcrs) override {
     int size;
-    int rank;
-
     MPI_Comm_size(MPI_COMM_WORLD, &size);
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-
-    //------------------------------------------------------------------------//
-    // Call ParMETIS partitioner.
-    //------------------------------------------------------------------------//
-
-    idx_t wgtflag = 0;
-    idx_t numflag = 0;
-    idx_t ncon = 1;
-    std::vector<real_t> tpwgts(size);
-
-    real_t sum = 0.0;
-    for (size_t i(0); i < tpwgts.size(); ++i) {
-      if (i == (tpwgts.size() - 1)) {
-        tpwgts[i] = 1.0 - sum;
-      } else {
-        tpwgts[i] = 1.0 / size;
-        sum += tpwgts[i];
-      } // if
-
-#if 0
-      if(rank == 0) {
-        std::cout << tpwgts[i] << std::endl;
-      } // if
-#endif
-    } // for
 
-    // We may need to expose some of the ParMETIS configuration options.
-    real_t ubvec = 1.05;
+    graph_t graph = make_graph(dcrs, size);
+    idx_t nparts = size;
     idx_t options = 0;
     idx_t edgecut;
     MPI_Comm comm = MPI_COMM_WORLD;
@@ -111,23 +113,226 @@ struct parmetis_colorer_t : public colorer_t {
     } // if
 #endif
 
-    //    std::set<size_t> ret;
-    //    return ret;
+    // Actual call to ParMETIS.
+    int result = ParMETIS_V3_PartKway(
+        graph.vtxdist.data(), graph.xadj.data(), graph.adjncy.data(),
+        graph.vwgt(), graph.adjwgt(), &graph.wgtflag, &graph.numflag,
+        &graph.ncon, &nparts, graph.tpwgts.data(), graph.ubvec.data(), &options,
+        &edgecut, part.data(), &comm);
+
+    clog_assert(result == METIS_OK, "ParMETIS_V3_PartKway failed");
+
+    set_statistics(dcrs, graph, part, edgecut);
+
+    return primary_coloring(dcrs, part);
+  } // color
+
+  /*!
+   Implementation of repartition method. See \ref colorer_t::repartition.
+
+   This calls ParMETIS_V3_AdaptiveRepart, which balances the weights like
+   color, while trading the edgecut for the number of indices that move
+   to another color, according to the redistribution cost of the
+   constructor.
+   */
+
+  std::set<size_t> repartition(const dcrs_t & dcrs) override {
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    graph_t graph = make_graph(dcrs, size);
+    real_t itr = redistribution_cost_;
+    idx_t nparts = size;
+    idx_t options = 0;
+    idx_t edgecut;
+    MPI_Comm comm = MPI_COMM_WORLD;
+    std::vector<idx_t> part(dcrs.size(), std::numeric_limits<idx_t>::max());
+
+    int result = ParMETIS_V3_AdaptiveRepart(
+        graph.vtxdist.data(), graph.xadj.data(), graph.adjncy.data(),
+        graph.vwgt(), nullptr, graph.adjwgt(), &graph.wgtflag, &graph.numflag,
+        &graph.ncon, &nparts, graph.tpwgts.data(), graph.ubvec.data(), &itr,
+        &options, &edgecut, part.data(), &comm);
+
+    clog_assert(result == METIS_OK, "ParMETIS_V3_AdaptiveRepart failed");
+
+    set_statistics(dcrs, graph, part, edgecut);
+
+    return primary_coloring(dcrs, part);
+  } // repartition
+
+private:
+  /*!
+   The graph of a dCRS, and the weights and balance constraints, in the
+   form expected by ParMETIS.
+   */
+
+  struct graph_t {
+    idx_t * vwgt() {
+      return vertex_weights.empty() ? nullptr : vertex_weights.data();
+    } // vwgt
+
+    idx_t * adjwgt() {
+      return edge_weights.empty() ? nullptr : edge_weights.data();
+    } // adjwgt
+
+    std::vector<idx_t> vtxdist;
+    std::vector<idx_t> xadj;
+    std::vector<idx_t> adjncy;
+    std::vector<idx_t> vertex_weights;
+    std::vector<idx_t> edge_weights;
+    idx_t wgtflag;
+    idx_t numflag = 0;
+    idx_t ncon;
+    std::vector<real_t> tpwgts;
+    std::vector<real_t> ubvec;
+  }; // struct graph_t
+
+  /*!
+   Return the graph of a dCRS, with its weights, and the target weights
+   and imbalance tolerances for the given number of colors.
+   */
+
+  graph_t make_graph(const dcrs_t & dcrs, size_t colors) const {
+    const size_t ncon = dcrs.num_constraints;
+
+    clog_assert(ncon > 0, "invalid number of constraints");
+    clog_assert(
+        dcrs.vertex_weights.empty() ||
+            dcrs.vertex_weights.size() == ncon * dcrs.size(),
+        "invalid number of vertex weights " << dcrs.vertex_weights.size()
+                                            << " for " << dcrs.size()
+                                            << " vertices and " << ncon
+                                            << " constraints");
+    clog_assert(
+        dcrs.edge_weights.empty() ||
+            dcrs.edge_weights.size() == dcrs.indices.size(),
+        "invalid number of edge weights " << dcrs.edge_weights.size()
+                                          << " for " << dcrs.indices.size()
+                                          << " edges");
+    clog_assert(
+        dcrs.ids.empty() || dcrs.ids.size() == dcrs.size(),
+        "invalid number of ids " << dcrs.ids.size() << " for "
+                                 << dcrs.size() << " vertices");
+
+    // ParMETIS requires a consistent weight flag on all ranks, so ranks
+    // without weights use unit weights.
+    int has_weights[2] = {!dcrs.vertex_weights.empty(),
+                          !dcrs.edge_weights.empty()};
+    MPI_Allreduce(
+        MPI_IN_PLACE, has_weights, 2, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+
+    clog_assert(
+        ncon == 1 || has_weights[0],
+        "multiple constraints require vertex weights");
+
+    graph_t graph;
 
     // Get the dCRS information using ParMETIS types.
-    std::vector<idx_t> vtxdist = dcrs.distribution_as<idx_t>();
-    std::vector<idx_t> xadj = dcrs.offsets_as<idx_t>();
-    std::vector<idx_t> adjncy = dcrs.indices_as<idx_t>();
+    graph.vtxdist = dcrs.distribution_as<idx_t>();
+    graph.xadj = dcrs.offsets_as<idx_t>();
+    graph.adjncy = dcrs.indices_as<idx_t>();
 
-    // Actual call to ParMETIS.
-    int result = ParMETIS_V3_PartKway(
-        &vtxdist[0], &xadj[0], &adjncy[0], nullptr, nullptr, &wgtflag, &numflag,
-        &ncon, &size, &tpwgts[0], &ubvec, &options, &edgecut, &part[0], &comm);
+    if (has_weights[0]) {
+      graph.vertex_weights = dcrs.vertex_weights_as<idx_t>();
+      graph.vertex_weights.resize(ncon * dcrs.size(), 1);
+    } // if
 
+    if (has_weights[1]) {
+      graph.edge_weights = dcrs.edge_weights_as<idx_t>();
+      graph.edge_weights.resize(dcrs.indices.size(), 1);
+    } // if
+
+    graph.wgtflag = (has_weights[0] ? 2 : 0) + (has_weights[1] ? 1 : 0);
+    graph.ncon = ncon;
+    graph.tpwgts = target_weights(colors, ncon);
+
+    graph.ubvec.resize(ncon);
+    for (size_t c(0); c < ncon; ++c) {
+      graph.ubvec[c] = imbalance_tolerance_.size() == ncon
+                           ? imbalance_tolerance_[c]
+                           : imbalance_tolerance_.at(0);
+    } // for
+
+    return graph;
+  } // make_graph
+
+  /*!
+   Return the id of a local index of a dCRS.
+   */
+
+  static size_t id(const dcrs_t & dcrs, size_t i) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    return dcrs.ids.empty() ? dcrs.distribution[rank] + i : dcrs.ids[i];
+  } // id
+
+  /*!
+   Compute the statistics of a coloring (see colorer_t::statistics).
+   */
+
+  void set_statistics(
+      const dcrs_t & dcrs,
+      const graph_t & graph,
+      const std::vector<idx_t> & part,
+      idx_t edgecut) {
+    const size_t ncon = graph.ncon;
+    const size_t size = graph.tpwgts.size() / ncon;
+    const auto & vwgt = graph.vertex_weights;
+    const auto & tpwgts = graph.tpwgts;
+
+    statistics_.edgecut = edgecut;
+    statistics_.weights.assign(size * ncon, 0);
+
+    for (size_t i(0); i < dcrs.size(); ++i) {
+      for (size_t c(0); c < ncon; ++c) {
+        statistics_.weights[part[i] * ncon + c] +=
+            vwgt.empty() ? 1 : vwgt[i * ncon + c];
+      } // for
+    } // for
+
+    MPI_Allreduce(
+        MPI_IN_PLACE, &statistics_.weights[0], size * ncon,
+        mpi_typetraits__<size_t>::type(), MPI_SUM, MPI_COMM_WORLD);
+
+    statistics_.imbalance.assign(ncon, 1.0);
+
+    for (size_t c(0); c < ncon; ++c) {
+      double total(0.0);
+      for (size_t r(0); r < size; ++r) {
+        total += statistics_.weights[r * ncon + c];
+      } // for
+
+      if (total == 0.0) {
+        continue;
+      } // if
+
+      double imbalance(0.0);
+      for (size_t r(0); r < size; ++r) {
+        const double target = tpwgts[r * ncon + c] * total;
+        if (target > 0.0) {
+          imbalance =
+              std::max(imbalance, statistics_.weights[r * ncon + c] / target);
+        } // if
+      } // for
+
+      statistics_.imbalance[c] = imbalance;
+    } // for
+  } // set_statistics
+
+  /*!
+   Send the ids of the local indices of a dCRS to the colors that they
+   have been assigned to, and return the ids that are assigned to the
+   current color.
+   */
+
+  std::set<size_t>
+  primary_coloring(const dcrs_t & dcrs, const std::vector<idx_t> & part) {
 #if 0
     std::cout << "rank " << rank << ": ";
     for(size_t i(0); i<dcrs.size(); ++i) {
-      std::cout << "[" << part[i] << ", " << vtxdist[rank]+i << "] ";
+      std::cout << "[" << part[i] << ", " << id(dcrs, i) << "] ";
     } // for
     std::cout << std::endl;
 #endif
@@ -136,6 +341,12 @@ struct parmetis_colorer_t : public colorer_t {
     // Exchange information with other ranks.
     //------------------------------------------------------------------------//
 
+    int size;
+    int rank;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
     std::vector<idx_t> send_cnts(size, 0);
     std::vector<std::vector<idx_t>> sbuffers;
 
@@ -147,10 +358,10 @@ struct parmetis_colorer_t : public colorer_t {
 
       for (size_t i(0); i < dcrs.size(); ++i) {
         if (part[i] == r) {
-          indices.push_back(vtxdist[rank] + i);
+          indices.push_back(id(dcrs, i));
         } else if (part[i] == rank) {
           // If the index belongs to us, just add it...
-          primary.insert(vtxdist[rank] + i);
+          primary.insert(id(dcrs, i));
         } // if
       } // for
 
@@ -174,7 +385,7 @@ struct parmetis_colorer_t : public colorer_t {
 
     // Do all-to-all to find out where everything belongs.
     std::vector<idx_t> recv_cnts(size);
-    result = MPI_Alltoall(
+    MPI_Alltoall(
         &send_cnts[0], 1, mpi_typetraits__<idx_t>::type(), &recv_cnts[0], 1,
         mpi_typetraits__<idx_t>::type(), MPI_COMM_WORLD);
 
@@ -242,7 +453,61 @@ struct parmetis_colorer_t : public colorer_t {
         "increase the problem size or use fewer ranks");
 
     return primary;
-  } // color
+  } // primary_coloring
+
+  /*!
+   Return the target weights for ParMETIS, i.e., the fraction of each
+   constraint for each color, stored contiguously for each color.
+   */
+
+  std::vector<real_t> target_weights(size_t colors, size_t ncon) const {
+    std::vector<real_t> tpwgts(colors * ncon);
+
+    if (target_weights_.empty()) {
+      for (size_t c(0); c < ncon; ++c) {
+        real_t sum = 0.0;
+        for (size_t i(0); i < colors; ++i) {
+          if (i == (colors - 1)) {
+            tpwgts[i * ncon + c] = 1.0 - sum;
+          } else {
+            tpwgts[i * ncon + c] = 1.0 / colors;
+            sum += tpwgts[i * ncon + c];
+          } // if
+        } // for
+      } // for
+
+      return tpwgts;
+    } // if
+
+    const bool per_constraint = target_weights_.size() == colors * ncon;
+
+    clog_assert(
+        per_constraint || target_weights_.size() == colors,
+        "invalid number of target weights " << target_weights_.size()
+                                            << " for " << colors
+                                            << " colors");
+
+    // Normalize the weights of each constraint.
+    for (size_t c(0); c < ncon; ++c) {
+      double sum(0.0);
+      for (size_t i(0); i < colors; ++i) {
+        sum += target_weights_[per_constraint ? i * ncon + c : i];
+      } // for
+
+      clog_assert(sum > 0.0, "target weights must not all be zero");
+
+      for (size_t i(0); i < colors; ++i) {
+        tpwgts[i * ncon + c] =
+            target_weights_[per_constraint ? i * ncon + c : i] / sum;
+      } // for
+    } // for
+
+    return tpwgts;
+  } // target_weights
+
+  std::vector<double> target_weights_;
+  std::vector<double> imbalance_tolerance_;
+  double redistribution_cost_;
 
 }; // struct parmetis_colorer_t
 
@@ -0,0 +1,410 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <flecsi/coloring/crs.h>
+#include <flecsi/coloring/index_coloring.h>
+#include <flecsi/geometry/point.h>
+
+namespace flecsi {
+namespace coloring {
+
+/*!
+ Compute a reverse Cuthill-McKee ordering of a graph. Each connected
+ component is started from a pseudo-peripheral vertex, and neighbors are
+ visited in order of increasing degree.
+
+ @param graph The (symmetric) adjacency graph.
+
+ @return A vector \em order, such that order[i] is the vertex at position
+         \em i of the new ordering.
+
+ @ingroup coloring
+ */
+
+inline std::vector<size_t>
+reverse_cuthill_mckee(const crs_t & graph) {
+  const size_t n = graph.offsets.empty() ? 0 : graph.size();
+
+  std::vector<size_t> degree(n);
+  for (size_t v(0); v < n; ++v) {
+    degree[v] = graph.offsets[v + 1] - graph.offsets[v];
+  } // for
+
+  // Level-set traversal from root, visiting neighbors by degree. The
+  // vertices are appended to order, and the index of the first vertex of
+  // the last level is returned.
+  std::vector<bool> visited(n, false);
+  std::vector<size_t> neighbors;
+
+  auto traverse = [&](size_t root, std::vector<size_t> & order) {
+    const size_t start = order.size();
+    size_t last_level = start;
+
+    order.push_back(root);
+    visited[root] = true;
+
+    for (size_t head(start), level_end(start + 1); head < order.size();) {
+      const size_t v = order[head++];
+
+      neighbors.clear();
+      for (size_t i(graph.offsets[v]); i < graph.offsets[v + 1]; ++i) {
+        const size_t u = graph.indices[i];
+
+        if (!visited[u]) {
+          visited[u] = true;
+          neighbors.push_back(u);
+        } // if
+      } // for
+
+      std::stable_sort(neighbors.begin(), neighbors.end(),
+        [&degree](size_t a, size_t b) { return degree[a] < degree[b]; });
+      order.insert(order.end(), neighbors.begin(), neighbors.end());
+
+      if (head == level_end && head < order.size()) {
+        last_level = head;
+        level_end = order.size();
+      } // if
+    } // for
+
+    return last_level;
+  }; // traverse
+
+  std::vector<size_t> order;
+  std::vector<size_t> trial;
+  order.reserve(n);
+
+  for (size_t v(0); v < n; ++v) {
+    if (visited[v]) {
+      continue;
+    } // if
+
+    // Find a pseudo-peripheral root: repeatedly restart from a vertex of
+    // minimum degree in the last level while the depth increases.
+    size_t root = v;
+    size_t depth = 0;
+
+    for (size_t iteration(0); iteration < 8; ++iteration) {
+      trial.clear();
+      const size_t last_level = traverse(root, trial);
+
+      for (auto u : trial) {
+        visited[u] = false;
+      } // for
+
+      if (iteration > 0 && trial.size() - last_level >= depth) {
+        break;
+      } // if
+
+      depth = trial.size() - last_level;
+
+      const size_t candidate = *std::min_element(trial.begin() + last_level,
+        trial.end(),
+        [&degree](size_t a, size_t b) { return degree[a] < degree[b]; });
+
+      if (candidate == root) {
+        break;
+      } // if
+
+      root = candidate;
+    } // for
+
+    traverse(root, order);
+  } // for
+
+  std::reverse(order.begin(), order.end());
+
+  return order;
+} // reverse_cuthill_mckee
+
+/*!
+ Return the Morton (Z-order) key of a point within the bounding box
+ [lo, hi]. Each coordinate is quantized to 63 / DIMENSION bits.
+
+ @ingroup coloring
+ */
+
+template<size_t DIMENSION>
+inline uint64_t
+morton_key(
+  const point__<double, DIMENSION> & p,
+  const point__<double, DIMENSION> & lo,
+  const point__<double, DIMENSION> & hi
+)
+{
+  constexpr size_t bits = 63 / DIMENSION;
+  constexpr uint64_t max = (uint64_t(1) << bits) - 1;
+
+  uint64_t q[DIMENSION];
+
+  for (size_t d(0); d < DIMENSION; ++d) {
+    const double extent = hi[d] - lo[d];
+    const double s = extent > 0.0 ? (p[d] - lo[d]) / extent : 0.0;
+
+    q[d] = std::min(max, uint64_t(std::max(0.0, s) * double(max)));
+  } // for
+
+  uint64_t key = 0;
+
+  for (size_t b(bits); b-- > 0;) {
+    for (size_t d(0); d < DIMENSION; ++d) {
+      key = (key << 1) | ((q[d] >> b) & 1);
+    } // for
+  } // for
+
+  return key;
+} // morton_key
+
+/*!
+ Set the local order of an index coloring. The entities of each range
+ (exclusive, shared and ghost) are sorted by \em key, with ties broken
+ by id, so that the ranges themselves are preserved.
+
+ @param coloring The index coloring to order.
+ @param key      A callable object returning the sort key of a mesh id.
+
+ @ingroup coloring
+ */
+
+template<typename KEY>
+void
+order_index_coloring(index_coloring_t & coloring, KEY && key) {
+  using key_t = std::decay_t<decltype(key(size_t()))>;
+
+  std::vector<std::pair<key_t, size_t>> keys;
+
+  coloring.order.clear();
+  coloring.order.reserve(coloring.exclusive.size() + coloring.shared.size() +
+    coloring.ghost.size());
+
+  auto append = [&](const utils::flat_set__<entity_info_t> & entities) {
+    keys.clear();
+
+    for (const auto & e : entities) {
+      keys.emplace_back(key(e.id), e.id);
+    } // for
+
+    std::sort(keys.begin(), keys.end());
+
+    for (const auto & k : keys) {
+      coloring.order.push_back(k.second);
+    } // for
+  }; // append
+
+  append(coloring.exclusive);
+  append(coloring.shared);
+  append(coloring.ghost);
+} // order_index_coloring
+
+/*!
+ Build the adjacency graph of the local cells of a coloring, i.e., the
+ cells are adjacent if they share a vertex. The graph vertices are the
+ positions of the cells in \em ids.
+
+ @tparam DEFINITION A mesh definition type.
+
+ @param md  The mesh definition.
+ @param ids The mesh ids of the cells.
+
+ @ingroup coloring
+ */
+
+template<typename DEFINITION>
+crs_t
+cell_adjacency(const DEFINITION & md, const std::vector<size_t> & ids) {
+  constexpr size_t dimension = DEFINITION::dimension();
+
+  auto cells = md.entities_crs(dimension, 0);
+
+  // Vertex to local cells.
+  std::unordered_map<size_t, std::vector<size_t>> vertex_cells;
+
+  for (size_t c(0); c < ids.size(); ++c) {
+    for (auto v : cells[ids[c]]) {
+      vertex_cells[v].push_back(c);
+    } // for
+  } // for
+
+  crs_t graph;
+  graph.offsets.reserve(ids.size() + 1);
+  graph.offsets.push_back(0);
+
+  std::vector<size_t> neighbors;
+
+  for (size_t c(0); c < ids.size(); ++c) {
+    neighbors.clear();
+
+    for (auto v : cells[ids[c]]) {
+      for (auto n : vertex_cells[v]) {
+        if (n != c) {
+          neighbors.push_back(n);
+        } // if
+      } // for
+    } // for
+
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(
+      std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+    graph.indices.insert(
+      graph.indices.end(), neighbors.begin(), neighbors.end());
+    graph.offsets.push_back(graph.indices.size());
+  } // for
+
+  return graph;
+} // cell_adjacency
+
+/*!
+ Order the local cells of a coloring with reverse Cuthill-McKee on the
+ local cell adjacency graph.
+
+ @tparam DEFINITION A mesh definition type.
+
+ @param md    The mesh definition.
+ @param cells The cell coloring to order.
+
+ @ingroup coloring
+ */
+
+template<typename DEFINITION>
+void
+rcm_order_cells(const DEFINITION & md, index_coloring_t & cells) {
+  std::vector<size_t> ids;
+
+  for (auto range : {&cells.exclusive, &cells.shared, &cells.ghost}) {
+    for (const auto & e : *range) {
+      ids.push_back(e.id);
+    } // for
+  } // for
+
+  auto order = reverse_cuthill_mckee(cell_adjacency(md, ids));
+
+  std::unordered_map<size_t, size_t> rank;
+  for (size_t i(0); i < order.size(); ++i) {
+    rank[ids[order[i]]] = i;
+  } // for
+
+  order_index_coloring(cells, [&rank](size_t id) { return rank.at(id); });
+} // rcm_order_cells
+
+/*!
+ Order the local cells of a coloring along a Morton curve through the
+ cell centroids.
+
+ @tparam DEFINITION A mesh definition type that provides a vertex()
+                    method returning the coordinates of a vertex.
+
+ @param md    The mesh definition.
+ @param cells The cell coloring to order.
+
+ @ingroup coloring
+ */
+
+template<typename DEFINITION>
+void
+morton_order_cells(const DEFINITION & md, index_coloring_t & cells) {
+  constexpr size_t dimension = DEFINITION::dimension();
+  using point_t = point__<double, dimension>;
+
+  auto definitions = md.entities_crs(dimension, 0);
+
+  std::unordered_map<size_t, point_t> centroids;
+  point_t lo, hi;
+
+  for (size_t d(0); d < dimension; ++d) {
+    lo[d] = std::numeric_limits<double>::max();
+    hi[d] = std::numeric_limits<double>::lowest();
+  } // for
+
+  for (auto range : {&cells.exclusive, &cells.shared, &cells.ghost}) {
+    for (const auto & e : *range) {
+      auto vertices = definitions[e.id];
+      point_t c;
+
+      for (size_t d(0); d < dimension; ++d) {
+        c[d] = 0.0;
+      } // for
+
+      for (auto v : vertices) {
+        const auto p = md.vertex(v);
+
+        for (size_t d(0); d < dimension; ++d) {
+          c[d] += p[d] / vertices.size();
+        } // for
+      } // for
+
+      for (size_t d(0); d < dimension; ++d) {
+        lo[d] = std::min(lo[d], c[d]);
+        hi[d] = std::max(hi[d], c[d]);
+      } // for
+
+      centroids[e.id] = c;
+    } // for
+  } // for
+
+  order_index_coloring(cells, [&](size_t id) {
+    return morton_key<dimension>(centroids.at(id), lo, hi);
+  });
+} // morton_order_cells
+
+/*!
+ Order the local vertices of a coloring by first touch from the local
+ order of the cells, so that the vertices of neighboring cells are close
+ in memory. Vertices that do not belong to a local cell are placed at the
+ end of their range.
+
+ @tparam DEFINITION A mesh definition type.
+
+ @param md       The mesh definition.
+ @param cells    The (ordered) cell coloring.
+ @param vertices The vertex coloring to order.
+
+ @ingroup coloring
+ */
+
+template<typename DEFINITION>
+void
+order_vertices_by_cells(
+  const DEFINITION & md,
+  const index_coloring_t & cells,
+  index_coloring_t & vertices
+)
+{
+  auto definitions = md.entities_crs(DEFINITION::dimension(), 0);
+
+  std::unordered_map<size_t, size_t> rank;
+
+  for (auto c : cells.local_ids()) {
+    for (auto v : definitions[c]) {
+      rank.emplace(v, rank.size());
+    } // for
+  } // for
+
+  order_index_coloring(vertices, [&rank](size_t id) {
+    auto it = rank.find(id);
+    return it == rank.end() ? std::numeric_limits<size_t>::max() : it->second;
+  });
+} // order_vertices_by_cells
+
+} // namespace coloring
+} // namespace flecsi
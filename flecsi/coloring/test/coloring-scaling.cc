@@ -0,0 +1,154 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+#include <cinchdevel.h>
+
+#include <cmath>
+#include <cstdlib>
+
+#include <sys/resource.h>
+
+#include <flecsi/coloring/index_coloring.h>
+#include <flecsi/coloring/mpi_communicator.h>
+#include <flecsi/supplemental/coloring/coloring_functions.h>
+
+clog_register_tag(coloring_scaling);
+
+//----------------------------------------------------------------------------//
+// Weak-scaling benchmark for the coloring construction of
+// supplemental/coloring/add_colorings.cc, i.e., color_cells, color_entity
+// for the vertices, and the gather of the coloring information.
+//
+// The mesh is a procedural MxM quadrilateral grid with roughly
+// FLECSI_COLORING_CELLS_PER_RANK cells per rank (default 65536), so no
+// input file is required, and the primary coloring is a block partition
+// of the cell ids, so that ParMETIS is not required. The maximum time
+// and peak resident set size over all ranks are reported for each
+// phase; the peak resident set size only grows.
+//----------------------------------------------------------------------------//
+
+class grid_definition_t : public flecsi::topology::mesh_definition__<2>
+{
+public:
+
+  grid_definition_t(size_t M) : M_(M) {}
+
+  size_t num_entities(size_t dimension) const override {
+    return dimension == 0 ? (M_+1)*(M_+1) : M_*M_;
+  } // num_entities
+
+  std::vector<size_t>
+  entities(size_t from_dim, size_t to_dim, size_t id) const override {
+    const size_t v0 = id%M_ + (id/M_)*(M_+1);
+    const size_t v1 = v0 + M_+1;
+    return { v0, v0+1, v1+1, v1 };
+  } // entities
+
+private:
+
+  size_t M_;
+
+}; // class grid_definition_t
+
+// Return the peak resident set size of this process in megabytes.
+double peak_rss() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss/1024.0;
+} // peak_rss
+
+template<typename F>
+void measure(const char * name, F && f) {
+  MPI_Barrier(MPI_COMM_WORLD);
+  double start = MPI_Wtime();
+
+  f();
+
+  double elapsed = MPI_Wtime() - start;
+  double rss = peak_rss();
+
+  double max_elapsed, max_rss;
+  MPI_Reduce(&elapsed, &max_elapsed, 1, MPI_DOUBLE, MPI_MAX, 0,
+    MPI_COMM_WORLD);
+  MPI_Reduce(&rss, &max_rss, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+  {
+  clog_tag_guard(coloring_scaling);
+  clog_one(info) << name << ": " << max_elapsed << " s, peak rss " <<
+    max_rss << " MB" << std::endl;
+  } // guard
+} // measure
+
+DEVEL(coloring_scaling) {
+  clog_set_output_rank(0);
+
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  const char * env = std::getenv("FLECSI_COLORING_CELLS_PER_RANK");
+  const size_t cells_per_rank = env ? std::atol(env) : 65536;
+
+  const size_t M = std::ceil(std::sqrt(double(cells_per_rank)*size));
+  grid_definition_t gd(M);
+
+  {
+  clog_tag_guard(coloring_scaling);
+  clog_one(info) << "ranks " << size << ", mesh " << M << "x" << M <<
+    std::endl;
+  } // guard
+
+  auto communicator = std::make_shared<flecsi::coloring::mpi_communicator_t>();
+
+  flecsi::coloring::index_coloring_t cells;
+  flecsi::coloring::coloring_info_t cell_color_info;
+
+  std::set<size_t> closure;
+  std::unordered_map<size_t, flecsi::coloring::entity_info_t> remote_info_map;
+  std::unordered_map<size_t, flecsi::coloring::entity_info_t>
+    shared_cells_map;
+  std::unordered_map<size_t, flecsi::utils::flat_set__<size_t>>
+    closure_intersection_map;
+
+  flecsi::coloring::index_coloring_t vertices;
+  flecsi::coloring::coloring_info_t vertex_color_info;
+
+  measure("color_cells", [&]() {
+    const size_t num_cells = gd.num_entities(2);
+    for(size_t c(num_cells*rank/size); c<num_cells*(rank+1)/size; ++c) {
+      cells.primary.insert(c);
+    } // for
+
+    flecsi::execution::color_cells<2>(gd, communicator.get(), closure,
+      remote_info_map, shared_cells_map, closure_intersection_map, cells,
+      cell_color_info);
+  });
+
+  measure("color_entity (vertices)", [&]() {
+    flecsi::execution::color_entity<2, 0>(gd, communicator.get(), closure,
+      remote_info_map, shared_cells_map, closure_intersection_map, vertices,
+      vertex_color_info);
+  });
+
+  measure("gather_coloring_info", [&]() {
+    communicator->gather_coloring_info(cell_color_info);
+    communicator->gather_coloring_info(vertex_color_info);
+  });
+
+  {
+  clog_tag_guard(coloring_scaling);
+  clog_one(info) << "cells " << cells.exclusive.size() << "/" <<
+    cells.shared.size() << "/" << cells.ghost.size() << ", vertices " <<
+    vertices.exclusive.size() << "/" << vertices.shared.size() << "/" <<
+    vertices.ghost.size() << " (exclusive/shared/ghost, rank 0)" <<
+    std::endl;
+  } // guard
+
+} // DEVEL
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
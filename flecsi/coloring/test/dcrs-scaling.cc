@@ -0,0 +1,110 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+#include <cinchdevel.h>
+
+#include <cmath>
+#include <cstdlib>
+
+#include <sys/resource.h>
+
+#include <flecsi/coloring/dcrs_utils.h>
+
+clog_register_tag(dcrs_scaling);
+
+//----------------------------------------------------------------------------//
+// Weak-scaling benchmark for make_dcrs and make_dcrs_distributed.
+//
+// The mesh is a procedural MxM quadrilateral grid with roughly
+// FLECSI_DCRS_CELLS_PER_RANK cells per rank (default 65536), so no input
+// file is required. For each construction, the maximum time and peak
+// resident set size over all ranks are reported. The distributed
+// construction runs first, since the peak resident set size only grows.
+//----------------------------------------------------------------------------//
+
+class grid_definition_t : public flecsi::topology::mesh_definition__<2>
+{
+public:
+
+  grid_definition_t(size_t M) : M_(M) {}
+
+  size_t num_entities(size_t dimension) const override {
+    return dimension == 0 ? (M_+1)*(M_+1) : M_*M_;
+  } // num_entities
+
+  std::vector<size_t>
+  entities(size_t from_dim, size_t to_dim, size_t id) const override {
+    const size_t v0 = id%M_ + (id/M_)*(M_+1);
+    const size_t v1 = v0 + M_+1;
+    return { v0, v0+1, v1+1, v1 };
+  } // entities
+
+private:
+
+  size_t M_;
+
+}; // class grid_definition_t
+
+// Return the peak resident set size of this process in megabytes.
+double peak_rss() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss/1024.0;
+} // peak_rss
+
+template<typename F>
+void measure(const char * name, F && f) {
+  MPI_Barrier(MPI_COMM_WORLD);
+  double start = MPI_Wtime();
+
+  auto dcrs = f();
+
+  double elapsed = MPI_Wtime() - start;
+  double rss = peak_rss();
+
+  double max_elapsed, max_rss;
+  MPI_Reduce(&elapsed, &max_elapsed, 1, MPI_DOUBLE, MPI_MAX, 0,
+    MPI_COMM_WORLD);
+  MPI_Reduce(&rss, &max_rss, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+  {
+  clog_tag_guard(dcrs_scaling);
+  clog_one(info) << name << ": " << max_elapsed << " s, peak rss " <<
+    max_rss << " MB, local rows " << dcrs.size() << std::endl;
+  } // guard
+} // measure
+
+DEVEL(dcrs_scaling) {
+  clog_set_output_rank(0);
+
+  int size;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  const char * env = std::getenv("FLECSI_DCRS_CELLS_PER_RANK");
+  const size_t cells_per_rank = env ? std::atol(env) : 65536;
+
+  const size_t M = std::ceil(std::sqrt(double(cells_per_rank)*size));
+  grid_definition_t gd(M);
+
+  {
+  clog_tag_guard(dcrs_scaling);
+  clog_one(info) << "ranks " << size << ", mesh " << M << "x" << M <<
+    std::endl;
+  } // guard
+
+  measure("make_dcrs_distributed", [&gd]() {
+    return flecsi::coloring::make_dcrs_distributed(gd);
+  });
+
+  measure("make_dcrs", [&gd]() {
+    return flecsi::coloring::make_dcrs(gd);
+  });
+
+} // DEVEL
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
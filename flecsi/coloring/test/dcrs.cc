@@ -59,6 +59,80 @@ TEST(dcrs, simple2d_16x16) {
 
 } // TEST
 
+TEST(dcrs, distributed) {
+
+  for(auto file: {"simple2d-8x8.msh", "simple2d-16x16.msh"}) {
+    flecsi::io::simple_definition_t sd(file);
+
+    // The rendezvous construction must match the global construction.
+    auto dcrs = flecsi::coloring::make_dcrs(sd);
+    auto distributed = flecsi::coloring::make_dcrs_distributed(sd);
+
+    CINCH_ASSERT(EQ, distributed.distribution, dcrs.distribution);
+    CINCH_ASSERT(EQ, distributed.offsets, dcrs.offsets);
+    CINCH_ASSERT(EQ, distributed.indices, dcrs.indices);
+
+    // Neighbors through vertices.
+    auto dcrs0 = flecsi::coloring::make_dcrs<2, 2, 2, 0>(sd);
+    auto distributed0 =
+      flecsi::coloring::make_dcrs_distributed<2, 2, 2, 0>(sd);
+
+    CINCH_ASSERT(EQ, distributed0.offsets, dcrs0.offsets);
+    CINCH_ASSERT(EQ, distributed0.indices, dcrs0.indices);
+
+    // A definition of only this rank's block gives the same result.
+    int size;
+    int rank;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    flecsi::io::simple_definition_t block(file, size, rank);
+    auto from_block = flecsi::coloring::make_dcrs_distributed(block);
+
+    CINCH_ASSERT(EQ, from_block.distribution, dcrs.distribution);
+    CINCH_ASSERT(EQ, from_block.offsets, dcrs.offsets);
+    CINCH_ASSERT(EQ, from_block.indices, dcrs.indices);
+  } // for
+
+} // TEST
+
+TEST(dcrs, alltoallv_rounds) {
+
+  int size;
+  int rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  // Rank r sends r + d + 1 values to rank d.
+  std::vector<size_t> send_counts;
+  std::vector<size_t> send_buffer;
+
+  for(int d(0); d<size; ++d) {
+    send_counts.push_back(rank + d + 1);
+
+    for(size_t i(0); i<send_counts.back(); ++i) {
+      send_buffer.push_back(1000*rank + i);
+    } // for
+  } // for
+
+  // A limit this small splits the exchange into several rounds.
+  for(size_t limit: {size_t(std::numeric_limits<int>::max()), size_t(size)}) {
+    auto received = flecsi::coloring::detail::alltoallv(send_buffer,
+      send_counts, limit);
+
+    std::vector<size_t> expected;
+
+    for(int s(0); s<size; ++s) {
+      for(int i(0); i<s + rank + 1; ++i) {
+        expected.push_back(1000*s + i);
+      } // for
+    } // for
+
+    CINCH_ASSERT(EQ, received, expected);
+  } // for
+
+} // TEST
+
 /*----------------------------------------------------------------------------*
  * Cinch test Macros
  *
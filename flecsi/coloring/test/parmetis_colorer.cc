@@ -0,0 +1,130 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+#include <cinchtest.h>
+#include <mpi.h>
+
+#include <flecsi/coloring/dcrs_utils.h>
+#include <flecsi/coloring/parmetis_colorer.h>
+#include <flecsi/io/simple_definition.h>
+
+// Return the total weight of the given constraint of the primary coloring.
+size_t
+primary_weight(
+    const flecsi::coloring::dcrs_t & dcrs,
+    const std::vector<size_t> & weights,
+    const std::set<size_t> & primary,
+    size_t c) {
+  // Gather the weights of all of the cells.
+  int size;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  std::vector<int> counts(size), displs(size);
+  for (size_t r(0); r < size; ++r) {
+    counts[r] = (dcrs.distribution[r + 1] - dcrs.distribution[r]) *
+                dcrs.num_constraints;
+    displs[r] = dcrs.distribution[r] * dcrs.num_constraints;
+  } // for
+
+  auto type = flecsi::coloring::mpi_typetraits__<size_t>::type();
+
+  std::vector<size_t> all(dcrs.distribution.back() * dcrs.num_constraints);
+  MPI_Allgatherv(
+      &weights[0], weights.size(), type, &all[0], &counts[0], &displs[0], type,
+      MPI_COMM_WORLD);
+
+  size_t weight(0);
+  for (auto i : primary) {
+    weight += all[i * dcrs.num_constraints + c];
+  } // for
+
+  return weight;
+} // primary_weight
+
+TEST(parmetis_colorer, weighted) {
+  flecsi::io::simple_definition_t sd("simple2d-16x16.msh");
+  auto dcrs = flecsi::coloring::make_dcrs(sd);
+
+  int size;
+  int rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  // The cells of the left half are four times as expensive as the
+  // others, and the second constraint counts the cells.
+  dcrs.num_constraints = 2;
+  for (size_t i(0); i < dcrs.size(); ++i) {
+    const size_t cell = dcrs.distribution[rank] + i;
+    dcrs.vertex_weights.push_back(cell % 16 < 8 ? 4 : 1);
+    dcrs.vertex_weights.push_back(1);
+  } // for
+
+  // Edges between expensive cells are expensive to cut.
+  for (size_t i(0); i < dcrs.size(); ++i) {
+    const size_t cell = dcrs.distribution[rank] + i;
+    for (size_t j(dcrs.offsets[i]); j < dcrs.offsets[i + 1]; ++j) {
+      const bool expensive = cell % 16 < 8 && dcrs.indices[j] % 16 < 8;
+      dcrs.edge_weights.push_back(expensive ? 2 : 1);
+    } // for
+  } // for
+
+  flecsi::coloring::parmetis_colorer_t colorer;
+  auto primary = colorer.color(dcrs);
+  auto & statistics = colorer.statistics();
+
+  ASSERT_EQ(statistics.weights.size(), 2 * size);
+  ASSERT_EQ(statistics.imbalance.size(), 2);
+
+  // The statistics agree with the coloring.
+  for (size_t c(0); c < 2; ++c) {
+    ASSERT_EQ(
+        statistics.weights[rank * 2 + c],
+        primary_weight(dcrs, dcrs.vertex_weights, primary, c));
+
+    size_t total(0);
+    for (size_t r(0); r < size; ++r) {
+      total += statistics.weights[r * 2 + c];
+    } // for
+
+    ASSERT_EQ(total, c == 0 ? 16 * 8 * 5 : 16 * 16);
+    ASSERT_GE(statistics.imbalance[c], 1.0);
+    ASSERT_LT(statistics.imbalance[c], 1.25);
+  } // for
+
+  if (size > 1) {
+    ASSERT_GT(statistics.edgecut, 0);
+  } // if
+} // TEST
+
+TEST(parmetis_colorer, target_weights) {
+  flecsi::io::simple_definition_t sd("simple2d-16x16.msh");
+  auto dcrs = flecsi::coloring::make_dcrs(sd);
+
+  int size;
+  int rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  // The first color should receive twice as much as the others.
+  std::vector<double> target_weights(size, 1.0);
+  target_weights[0] = 2.0;
+
+  flecsi::coloring::parmetis_colorer_t colorer(target_weights);
+  auto primary = colorer.color(dcrs);
+  auto & statistics = colorer.statistics();
+
+  ASSERT_EQ(statistics.weights.size(), size);
+  ASSERT_EQ(statistics.weights[rank], primary.size());
+  ASSERT_LT(statistics.imbalance[0], 1.25);
+
+  if (size > 1) {
+    ASSERT_GT(statistics.weights[0], statistics.weights[1]);
+  } // if
+} // TEST
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
@@ -0,0 +1,165 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+#include <cinchtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include <flecsi/coloring/reorder_utils.h>
+#include <flecsi/io/simple_definition.h>
+
+using namespace flecsi;
+using namespace flecsi::coloring;
+
+// The maximum distance between adjacent graph vertices in the given order.
+size_t
+bandwidth(const crs_t & graph, const std::vector<size_t> & order) {
+  std::vector<size_t> position(order.size());
+  for(size_t i(0); i < order.size(); ++i) {
+    position[order[i]] = i;
+  } // for
+
+  size_t b(0);
+  for(size_t v(0); v < graph.size(); ++v) {
+    for(size_t i(graph.offsets[v]); i < graph.offsets[v + 1]; ++i) {
+      const size_t u = graph.indices[i];
+      b = std::max(b, position[v] > position[u] ? position[v] - position[u]
+                                                : position[u] - position[v]);
+    } // for
+  } // for
+
+  return b;
+} // bandwidth
+
+// Cells 0-199 exclusive, 200-219 shared, and 220-255 ghost.
+index_coloring_t
+make_coloring(size_t n) {
+  index_coloring_t coloring;
+
+  for(size_t i(0); i < n; ++i) {
+    entity_info_t e(i, 0, 0, {});
+
+    if(i < 200) {
+      coloring.exclusive.insert(e);
+    }
+    else if(i < 220) {
+      coloring.shared.insert(e);
+    }
+    else {
+      coloring.ghost.insert(e);
+    } // if
+  } // for
+
+  return coloring;
+} // make_coloring
+
+// Check that the local order permutes the entities within their ranges.
+void
+check_ranges(const index_coloring_t & coloring) {
+  auto ids = coloring.local_ids();
+  ASSERT_EQ(ids.size(), 256);
+
+  std::sort(ids.begin(), ids.begin() + 200);
+  std::sort(ids.begin() + 200, ids.begin() + 220);
+  std::sort(ids.begin() + 220, ids.end());
+
+  for(size_t i(0); i < ids.size(); ++i) {
+    ASSERT_EQ(ids[i], i);
+  } // for
+
+  auto offsets = coloring.local_offsets();
+  const auto order = coloring.local_ids();
+
+  ASSERT_EQ(offsets.at(order[0]), 0);
+  ASSERT_EQ(offsets.at(order[200]), 0);
+  ASSERT_EQ(offsets.at(order[221]), 1);
+} // check_ranges
+
+TEST(reorder_utils, reverse_cuthill_mckee) {
+  // A path graph with shuffled labels.
+  const std::vector<size_t> path = {3, 7, 0, 5, 1, 9, 2, 8, 4, 6};
+
+  std::vector<std::vector<size_t>> neighbors(path.size());
+  for(size_t i(1); i < path.size(); ++i) {
+    neighbors[path[i - 1]].push_back(path[i]);
+    neighbors[path[i]].push_back(path[i - 1]);
+  } // for
+
+  crs_t graph;
+  graph.offsets.push_back(0);
+  for(auto & n : neighbors) {
+    graph.indices.insert(graph.indices.end(), n.begin(), n.end());
+    graph.offsets.push_back(graph.indices.size());
+  } // for
+
+  std::vector<size_t> identity(path.size());
+  std::iota(identity.begin(), identity.end(), 0);
+
+  auto order = reverse_cuthill_mckee(graph);
+  ASSERT_EQ(order.size(), path.size());
+  ASSERT_GT(bandwidth(graph, identity), 1);
+  ASSERT_EQ(bandwidth(graph, order), 1);
+} // TEST
+
+TEST(reorder_utils, rcm_order_cells) {
+  io::simple_definition_t sd("simple2d-16x16.msh");
+
+  auto cells = make_coloring(sd.num_entities(2));
+  rcm_order_cells(sd, cells);
+  check_ranges(cells);
+
+  // The level sets of a structured grid are at most two rows wide, so the
+  // bandwidth of the reordered exclusive cells is bounded by two rows,
+  // while that of a shuffled order is not.
+  std::vector<size_t> ids(200);
+  std::iota(ids.begin(), ids.end(), 0);
+
+  auto graph = cell_adjacency(sd, ids);
+  std::vector<size_t> order(cells.order.begin(), cells.order.begin() + 200);
+
+  std::vector<size_t> shuffled(ids);
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+
+  ASSERT_LE(bandwidth(graph, order), 2 * 16);
+  ASSERT_GT(bandwidth(graph, shuffled), 4 * 16);
+} // TEST
+
+TEST(reorder_utils, morton_order) {
+  io::simple_definition_t sd("simple2d-16x16.msh");
+
+  auto cells = make_coloring(sd.num_entities(2));
+  morton_order_cells(sd, cells);
+  check_ranges(cells);
+
+  // The first four cells of a Morton order on a structured grid are the
+  // corner block of 2x2 cells.
+  std::vector<size_t> block(cells.order.begin(), cells.order.begin() + 4);
+  std::sort(block.begin(), block.end());
+  ASSERT_EQ(block, std::vector<size_t>({0, 1, 16, 17}));
+
+  // Vertices by first touch.
+  index_coloring_t vertices;
+  for(size_t v(0); v < sd.num_entities(0); ++v) {
+    vertices.exclusive.insert(entity_info_t(v, 0, 0, {}));
+  } // for
+
+  order_vertices_by_cells(sd, cells, vertices);
+
+  auto first = sd.entities(2, 0, cells.order[0]);
+  std::vector<size_t> expected(first.begin(), first.end());
+
+  // Ties are not possible, so the first vertices are exactly the vertices
+  // of the first cell in definition order.
+  std::vector<size_t> actual(
+    vertices.order.begin(), vertices.order.begin() + expected.size());
+  ASSERT_EQ(actual, expected);
+} // TEST
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
@@ -0,0 +1,100 @@
+/*~--------------------------------------------------------------------------~*
+ *  @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+ * /@@/////  /@@          @@////@@ @@////// /@@
+ * /@@       /@@  @@@@@  @@    // /@@       /@@
+ * /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+ * /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+ * /@@       /@@/@@//// //@@    @@       /@@/@@
+ * /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+ * //       ///  //////   //////  ////////  //
+ *
+ * Copyright (c) 2016 Los Alamos National Laboratory, LLC
+ * All rights reserved
+ *~--------------------------------------------------------------------------~*/
+
+// user includes
+#include <flecsi/concurrency/thread_pool.h>
+
+// system includes
+#include <atomic>
+#include <cinchtest.h>
+
+using flecsi::thread_pool;
+using flecsi::virtual_semaphore;
+using flecsi::wait_group;
+
+// Recursive fork/join: each level spawns one branch and computes the other
+// on the calling thread, so waits are nested inside worker tasks.
+size_t
+fib(thread_pool & pool, size_t n) {
+  if(n < 10) {
+    return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+  }
+
+  size_t a, b;
+  wait_group wg;
+
+  pool.spawn(wg, [&]() { a = fib(pool, n - 1); });
+  b = fib(pool, n - 2);
+  pool.wait(wg);
+
+  return a + b;
+} // fib
+
+//=============================================================================
+//! \brief Test queue() with semaphore counting, as used before spawn().
+//=============================================================================
+
+TEST(thread_pool, queue) {
+  thread_pool pool;
+  pool.start(4);
+
+  const int n = 10000;
+  std::atomic<int> sum(0);
+  virtual_semaphore sem(1 - n);
+
+  for(int i = 0; i < n; ++i) {
+    pool.queue([&](int x) { sum += x; sem.release(); }, i);
+  } // for
+
+  sem.acquire();
+
+  ASSERT_EQ(sum, n * (n - 1) / 2);
+} // TEST
+
+//=============================================================================
+//! \brief Test nested fork/join.
+//=============================================================================
+
+TEST(thread_pool, fork_join) {
+  thread_pool pool;
+  pool.start(4);
+
+  ASSERT_EQ(fib(pool, 25), 75025);
+} // TEST
+
+//=============================================================================
+//! \brief Test spawning more tasks than the deques can hold.
+//=============================================================================
+
+TEST(thread_pool, overflow) {
+  thread_pool pool;
+  pool.start(2);
+
+  const size_t n = 4 * thread_pool::deque_capacity;
+  std::atomic<size_t> count(0);
+  wait_group wg;
+
+  for(size_t i = 0; i < n; ++i) {
+    pool.spawn(wg, [&]() { ++count; });
+  } // for
+
+  pool.wait(wg);
+
+  ASSERT_EQ(count, n);
+} // TEST
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
@@ -10,27 +10,79 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cassert>
 #include <condition_variable>
-#include <functional>
+#include <cstddef>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <flecsi/concurrency/virtual_semaphore.h>
 
 namespace flecsi {
 
+//------------------------------------------------------------------------//
+//! A wait group counts the outstanding tasks of a fork/join region. Tasks
+//! are added with thread_pool::spawn and waited for with thread_pool::wait.
+//!
+//! @ingroup concurrency
+//------------------------------------------------------------------------//
+class wait_group {
+public:
+  wait_group() : count_(0) {}
+
+  wait_group & operator=(const wait_group &) = delete;
+
+  wait_group(const wait_group &) = delete;
+
+  //---------------------------------------------------------------------//
+  //! Add n outstanding tasks.
+  //---------------------------------------------------------------------//
+  void add(size_t n = 1) {
+    count_.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  //---------------------------------------------------------------------//
+  //! Mark one task as done.
+  //---------------------------------------------------------------------//
+  void done() {
+    count_.fetch_sub(1, std::memory_order_release);
+  }
+
+  //---------------------------------------------------------------------//
+  //! Return true if there are no outstanding tasks.
+  //---------------------------------------------------------------------//
+  bool idle() const {
+    return count_.load(std::memory_order_acquire) == 0;
+  }
+
+private:
+  std::atomic<size_t> count_;
+};
+
 //------------------------------------------------------------------------//
 //! This class provides a thread pool mechanism by which callable objects
 //! and associated arguments can be executed by a pool of worker threads.
 //!
+//! Each worker owns a bounded deque of tasks. Workers push and pop their
+//! own tasks at the back (LIFO, for locality of nested fork/join work),
+//! and steal from the front of other workers' deques when they run out.
+//! Tasks are stored inline in the deque slots, so queueing a task does
+//! not allocate.
+//!
 //! @ingroup concurrency
 //------------------------------------------------------------------------//
 class thread_pool {
 public:
-  //! signature of internally queued function
-  using function_t = std::function<void(void)>;
+  //! maximum size of a queued callable object (including its arguments)
+  static constexpr size_t task_storage = 128;
+
+  //! number of task slots per worker deque
+  static constexpr size_t deque_capacity = 4096;
 
   //---------------------------------------------------------------------//
   //! Constructor
@@ -46,24 +98,35 @@ public:
     join();
   }
 
+  thread_pool & operator=(const thread_pool &) = delete;
+
+  thread_pool(const thread_pool &) = delete;
+
   //---------------------------------------------------------------------//
   //! Internal run method. Do not call directly.
   //---------------------------------------------------------------------//
-  void run_() {
+  void run_(size_t worker) {
+    this_worker_() = {this, worker};
+
+    task_t task;
+
     for (;;) {
-      sem_.acquire();
+      if (next_task_(worker, task)) {
+        task();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      sleepers_.fetch_add(1);
+
+      cond_.wait(lock, [this] { return done_ || pending_.load() > 0; });
 
-      mutex_.lock();
+      sleepers_.fetch_sub(1);
 
       if (done_) {
-        mutex_.unlock();
         return;
       }
-
-      auto f = queue_.front();
-      queue_.pop();
-      mutex_.unlock();
-      f();
     }
   }
 
@@ -72,10 +135,42 @@ public:
   //---------------------------------------------------------------------//
   template<typename FT, typename... ARGS>
   void queue(FT f, ARGS... args) {
-    mutex_.lock();
-    queue_.emplace(std::bind(f, std::forward<ARGS>(args)...));
-    mutex_.unlock();
-    sem_.release();
+    push_([f, args...]() mutable { f(args...); });
+  }
+
+  //---------------------------------------------------------------------//
+  //! Spawn a callable object as part of the fork/join region tracked by
+  //! wg. Use wait() to join the region.
+  //---------------------------------------------------------------------//
+  template<typename FT>
+  void spawn(wait_group & wg, FT && f) {
+    wg.add();
+
+    push_([&wg, f]() mutable {
+      f();
+      wg.done();
+    });
+  }
+
+  //---------------------------------------------------------------------//
+  //! Wait for all tasks spawned in wg. The calling thread executes queued
+  //! tasks while waiting, so nested fork/join regions do not block
+  //! workers, and this can also be called from outside the pool.
+  //---------------------------------------------------------------------//
+  void wait(wait_group & wg) {
+    const auto & w = this_worker_();
+    const size_t worker = w.pool == this ? w.index : num_threads();
+
+    task_t task;
+
+    while (!wg.idle()) {
+      if (next_task_(worker, task)) {
+        task();
+      }
+      else {
+        std::this_thread::yield();
+      }
+    }
   }
 
   //---------------------------------------------------------------------//
@@ -87,8 +182,14 @@ public:
   void start(size_t num_threads) {
     assert(threads_.empty() && "thread pool already started");
 
+    // Deques must exist before any worker can steal from them.
+    deques_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+      deques_.emplace_back(new deque_t);
+    }
+
     for (size_t i = 0; i < num_threads; ++i) {
-      auto t = new std::thread(&thread_pool::run_, this);
+      auto t = new std::thread(&thread_pool::run_, this, i);
       threads_.push_back(t);
     }
   }
@@ -101,8 +202,12 @@ public:
       return;
     }
 
-    done_ = true;
-    sem_.interrupt();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+
+    cond_.notify_all();
 
     for (auto t : threads_) {
       t->join();
@@ -118,10 +223,208 @@ public:
   }
 
 private:
-  std::mutex mutex_;
-  std::queue<function_t> queue_;
+  //---------------------------------------------------------------------//
+  // A type-erased callable object with inline storage.
+  //---------------------------------------------------------------------//
+  class task_t {
+  public:
+    task_t() {}
+
+    ~task_t() {
+      reset();
+    }
+
+    task_t & operator=(const task_t &) = delete;
+
+    task_t(const task_t &) = delete;
+
+    template<typename F>
+    void set(F && f) {
+      using function_t = typename std::decay<F>::type;
+
+      static_assert(
+          sizeof(function_t) <= task_storage &&
+              alignof(function_t) <= alignof(std::max_align_t),
+          "callable object is too large for thread_pool task storage");
+
+      reset();
+      new (&storage_) function_t(std::forward<F>(f));
+
+      call_ = [](void * p) { (*static_cast<function_t *>(p))(); };
+      move_ = [](void * from, void * to) {
+        auto f = static_cast<function_t *>(from);
+        new (to) function_t(std::move(*f));
+        f->~function_t();
+      };
+      destroy_ = [](void * p) { static_cast<function_t *>(p)->~function_t(); };
+    }
+
+    // Move the callable object into t, leaving this task empty.
+    void move_to(task_t & t) {
+      t.reset();
+      move_(&storage_, &t.storage_);
+      t.call_ = call_;
+      t.move_ = move_;
+      t.destroy_ = destroy_;
+      call_ = nullptr;
+    }
+
+    void operator()() {
+      call_(&storage_);
+      reset();
+    }
+
+    void reset() {
+      if (call_) {
+        destroy_(&storage_);
+        call_ = nullptr;
+      }
+    }
+
+  private:
+    typename std::aligned_storage<task_storage,
+        alignof(std::max_align_t)>::type storage_;
+    void (*call_)(void *) = nullptr;
+    void (*move_)(void *, void *) = nullptr;
+    void (*destroy_)(void *) = nullptr;
+  };
+
+  //---------------------------------------------------------------------//
+  // A bounded deque of tasks. Each deque has its own lock, so contention
+  // is limited to a worker and the occasional thief.
+  //---------------------------------------------------------------------//
+  struct deque_t {
+    std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+    size_t front_ = 0;
+    size_t back_ = 0;
+    task_t tasks_[deque_capacity];
+
+    void lock() {
+      while (lock_.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+    }
+
+    void unlock() {
+      lock_.clear(std::memory_order_release);
+    }
+
+    template<typename F>
+    bool push_back(F && f) {
+      lock();
+
+      if (back_ - front_ == deque_capacity) {
+        unlock();
+        return false;
+      }
+
+      tasks_[back_++ % deque_capacity].set(std::forward<F>(f));
+      unlock();
+
+      return true;
+    }
+
+    bool pop_back(task_t & t) {
+      lock();
+
+      if (back_ == front_) {
+        unlock();
+        return false;
+      }
+
+      tasks_[--back_ % deque_capacity].move_to(t);
+      unlock();
+
+      return true;
+    }
+
+    bool pop_front(task_t & t) {
+      lock();
+
+      if (back_ == front_) {
+        unlock();
+        return false;
+      }
+
+      tasks_[front_++ % deque_capacity].move_to(t);
+      unlock();
+
+      return true;
+    }
+  };
+
+  struct worker_t {
+    thread_pool * pool;
+    size_t index;
+  };
+
+  // The pool and worker index of the calling thread.
+  static worker_t & this_worker_() {
+    static thread_local worker_t w = {nullptr, 0};
+    return w;
+  }
+
+  //---------------------------------------------------------------------//
+  // Push a task to the deque of the calling worker. Tasks queued from
+  // outside the pool are distributed round-robin. If the deque is full,
+  // the task is executed immediately. The pending count is only a hint
+  // for sleeping workers, and may briefly go negative when a task is
+  // stolen before it is counted.
+  //---------------------------------------------------------------------//
+  template<typename F>
+  void push_(F && f) {
+    assert(!deques_.empty() && "thread pool not started");
+
+    const auto & w = this_worker_();
+    const size_t worker = w.pool == this
+        ? w.index
+        : next_deque_.fetch_add(1, std::memory_order_relaxed) % deques_.size();
+
+    if (!deques_[worker]->push_back(f)) {
+      f();
+      return;
+    }
+
+    pending_.fetch_add(1);
+
+    if (sleepers_.load() > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cond_.notify_one();
+    }
+  }
+
+  //---------------------------------------------------------------------//
+  // Pop a task from the deque of worker, or steal one from another
+  // worker. Pass worker == num_threads() for threads outside the pool.
+  //---------------------------------------------------------------------//
+  bool next_task_(size_t worker, task_t & t) {
+    const size_t n = deques_.size();
+
+    if (worker < n && deques_[worker]->pop_back(t)) {
+      pending_.fetch_sub(1);
+      return true;
+    }
+
+    for (size_t i = 1; i <= n; ++i) {
+      const size_t victim = (worker + i) % n;
+
+      if (victim != worker && deques_[victim]->pop_front(t)) {
+        pending_.fetch_sub(1);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  std::vector<std::unique_ptr<deque_t>> deques_;
   std::vector<std::thread *> threads_;
-  virtual_semaphore sem_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::atomic<std::ptrdiff_t> pending_{0};
+  std::atomic<size_t> sleepers_{0};
+  std::atomic<size_t> next_deque_{0};
   std::atomic_bool done_;
 };
 
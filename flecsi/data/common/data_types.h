@@ -15,7 +15,14 @@
 
 /*! @file */
 
+#include <algorithm>
 #include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 #include <flecsi/utils/offset.h>
 
@@ -42,6 +49,306 @@ struct sparse_entry_value__ {
   T value;
 };
 
+/*!
+  Registering a sparse (or ragged) field with the data type
+  sparse_soa__<T, ENTRY> selects the structure-of-arrays layout: the entry
+  indices and the values of the field are stored in separate arrays, and
+  the entry indices are stored as ENTRY, which may be narrower than the
+  64-bit index of sparse_entry_value__ when the range of entries is small.
+  Handles, accessors and mutators of the field are instantiated with the
+  same data type, and refer to values of type T, e.g.,
+
+  \code
+  using material_t = data::sparse_soa__<double, uint16_t>;
+
+  flecsi_register_field(mesh_t, hydro, material, material_t, sparse, 1, 0);
+
+  void task(sparse_accessor<material_t, rw, rw, ro> material);
+  \endcode
+
+  (The alias is needed, since the field registration and handle macros do
+  not accept a template argument list.)
+ */
+
+template<typename T, typename ENTRY = uint32_t>
+struct sparse_soa__ {
+  static_assert(
+      std::is_unsigned<ENTRY>::value,
+      "sparse entry index type must be an unsigned integer");
+};
+
+/*!
+  The type of the values of a field registered with data type T.
+ */
+
+template<typename T>
+struct sparse_value_type__ {
+  using type = T;
+};
+
+template<typename T, typename ENTRY>
+struct sparse_value_type__<sparse_soa__<T, ENTRY>> {
+  using type = T;
+};
+
+/*!
+  A pointer-like view of the entries of a sparse field, which hides the
+  layout of the storage: for a data type T, the entries are stored as an
+  array of sparse_entry_value__<T>, and for sparse_soa__<T, ENTRY>, as
+  separate arrays of entry indices and values. Positions k are relative to
+  the start of the view.
+ */
+
+template<typename T>
+class sparse_entries__
+{
+public:
+  using value_t = T;
+  using entry_value_t = sparse_entry_value__<T>;
+  using index_t = typename entry_value_t::index_t;
+
+  //! The number of bytes per entry in the entry and value arrays.
+  static constexpr size_t entry_bytes = sizeof(entry_value_t);
+  static constexpr size_t value_bytes = 0;
+
+  sparse_entries__() {}
+
+  sparse_entries__(void * entries, void * values)
+      : entries_(static_cast<entry_value_t *>(entries)) {}
+
+  index_t entry(size_t k) const {
+    return entries_[k].entry;
+  }
+
+  value_t & value(size_t k) const {
+    return entries_[k].value;
+  }
+
+  void set(size_t k, size_t entry, const value_t & value) const {
+    entries_[k].entry = entry;
+    entries_[k].value = value;
+  }
+
+  //! Return the position of the first entry not less than entry in the
+  //! sorted range [start, end).
+  size_t lower_bound(size_t start, size_t end, size_t entry) const {
+    return std::lower_bound(
+               entries_ + start, entries_ + end, entry,
+               [](const entry_value_t & ev, size_t e) {
+                 return ev.entry < e;
+               }) -
+           entries_;
+  }
+
+  //! Copy n entries from src (which may overlap) to the start of the view.
+  void copy(const sparse_entries__ & src, size_t n) const {
+    std::memmove(entries_, src.entries_, n * sizeof(entry_value_t));
+  }
+
+  //! Pack n entries into buf, and return the number of bytes written.
+  size_t pack(uint8_t * buf, size_t n) const {
+    std::memcpy(buf, entries_, n * sizeof(entry_value_t));
+    return n * sizeof(entry_value_t);
+  }
+
+  //! Unpack n entries from buf, and return the number of bytes read.
+  size_t unpack(const uint8_t * buf, size_t n) const {
+    std::memcpy(entries_, buf, n * sizeof(entry_value_t));
+    return n * sizeof(entry_value_t);
+  }
+
+  sparse_entries__ operator+(size_t k) const {
+    sparse_entries__ e(*this);
+    e.entries_ += k;
+    return e;
+  }
+
+  size_t operator-(const sparse_entries__ & e) const {
+    return entries_ - e.entries_;
+  }
+
+private:
+  entry_value_t * entries_ = nullptr;
+}; // class sparse_entries__
+
+template<typename T, typename ENTRY>
+class sparse_entries__<sparse_soa__<T, ENTRY>>
+{
+public:
+  using value_t = T;
+  using entry_value_t = sparse_entry_value__<T>;
+  using index_t = ENTRY;
+
+  static constexpr size_t entry_bytes = sizeof(ENTRY);
+  static constexpr size_t value_bytes = sizeof(T);
+
+  sparse_entries__() {}
+
+  sparse_entries__(void * entries, void * values)
+      : entries_(static_cast<ENTRY *>(entries)),
+        values_(static_cast<T *>(values)) {}
+
+  index_t entry(size_t k) const {
+    return entries_[k];
+  }
+
+  value_t & value(size_t k) const {
+    return values_[k];
+  }
+
+  void set(size_t k, size_t entry, const value_t & value) const {
+    assert(
+        entry <= std::numeric_limits<ENTRY>::max() &&
+        "sparse entry exceeds the range of the entry index type");
+    entries_[k] = ENTRY(entry);
+    values_[k] = value;
+  }
+
+  size_t lower_bound(size_t start, size_t end, size_t entry) const {
+    return std::lower_bound(
+               entries_ + start, entries_ + end, entry,
+               [](ENTRY e1, size_t e2) { return e1 < e2; }) -
+           entries_;
+  }
+
+  void copy(const sparse_entries__ & src, size_t n) const {
+    std::memmove(entries_, src.entries_, n * sizeof(ENTRY));
+    std::memmove(values_, src.values_, n * sizeof(T));
+  }
+
+  // The entry indices of the n entries, followed by their values.
+  size_t pack(uint8_t * buf, size_t n) const {
+    std::memcpy(buf, entries_, n * sizeof(ENTRY));
+    std::memcpy(buf + n * sizeof(ENTRY), values_, n * sizeof(T));
+    return n * (sizeof(ENTRY) + sizeof(T));
+  }
+
+  size_t unpack(const uint8_t * buf, size_t n) const {
+    std::memcpy(entries_, buf, n * sizeof(ENTRY));
+    std::memcpy(values_, buf + n * sizeof(ENTRY), n * sizeof(T));
+    return n * (sizeof(ENTRY) + sizeof(T));
+  }
+
+  sparse_entries__ operator+(size_t k) const {
+    sparse_entries__ e(*this);
+    e.entries_ += k;
+    e.values_ += k;
+    return e;
+  }
+
+  size_t operator-(const sparse_entries__ & e) const {
+    return entries_ - e.entries_;
+  }
+
+private:
+  ENTRY * entries_ = nullptr;
+  T * values_ = nullptr;
+}; // class sparse_entries__
+
+/*!
+  The transpose of the structure of a sparse field: the distinct entries
+  used over all indices, in ascending order, and for each of them, the
+  indices that have the entry, in ascending order (compressed sparse
+  columns). It is built on first use and cached with the field data, until
+  a mutator commit or a ghost update changes the structure of the field;
+  writes through an accessor change values only, and leave it valid.
+ */
+
+class sparse_transpose_t
+{
+public:
+  bool valid() const {
+    return valid_;
+  }
+
+  void invalidate() {
+    valid_ = false;
+  }
+
+  //! The distinct entries, in ascending order.
+  const std::vector<size_t> & entries() const {
+    return entries_;
+  }
+
+  //! The position of entry in entries(), or entries().size() if unused.
+  size_t find(size_t entry) const {
+    auto itr = std::lower_bound(entries_.begin(), entries_.end(), entry);
+    return itr != entries_.end() && *itr == entry ? itr - entries_.begin()
+                                                  : entries_.size();
+  }
+
+  //! The indices that have the entry at position p of entries().
+  const size_t * begin(size_t p) const {
+    return indices_.data() + starts_[p];
+  }
+
+  const size_t * end(size_t p) const {
+    return indices_.data() + starts_[p + 1];
+  }
+
+  /*!
+    Build the transpose of num_indices indices with offsets into entries.
+   */
+  template<typename OFFSET, typename ENTRIES>
+  void build(const OFFSET * offsets, size_t num_indices,
+    const ENTRIES & entries) {
+    entries_.clear();
+
+    size_t nnz = 0;
+    for (size_t index = 0; index < num_indices; ++index) {
+      nnz += offsets[index].count();
+    }
+
+    // The distinct entries.
+    entries_.reserve(nnz);
+    for (size_t index = 0; index < num_indices; ++index) {
+      for (size_t k = offsets[index].start(); k < offsets[index].end(); ++k) {
+        entries_.push_back(entries.entry(k));
+      }
+    }
+
+    std::sort(entries_.begin(), entries_.end());
+    entries_.erase(
+        std::unique(entries_.begin(), entries_.end()), entries_.end());
+    entries_.shrink_to_fit();
+
+    // Count the indices per entry, and scatter them: indices are visited
+    // in ascending order, so each column is sorted.
+    std::vector<size_t> positions(nnz);
+    starts_.assign(entries_.size() + 1, 0);
+
+    size_t n = 0;
+    for (size_t index = 0; index < num_indices; ++index) {
+      for (size_t k = offsets[index].start(); k < offsets[index].end(); ++k) {
+        positions[n] = find(entries.entry(k));
+        ++starts_[positions[n++] + 1];
+      }
+    }
+
+    for (size_t p = 0; p < entries_.size(); ++p) {
+      starts_[p + 1] += starts_[p];
+    }
+
+    indices_.resize(nnz);
+    std::vector<size_t> cursor(starts_.begin(), starts_.end() - 1);
+
+    n = 0;
+    for (size_t index = 0; index < num_indices; ++index) {
+      for (size_t c = 0; c < offsets[index].count(); ++c) {
+        indices_[cursor[positions[n++]]++] = index;
+      }
+    }
+
+    valid_ = true;
+  } // build
+
+private:
+  bool valid_ = false;
+  std::vector<size_t> entries_;
+  std::vector<size_t> starts_;
+  std::vector<size_t> indices_;
+}; // class sparse_transpose_t
+
 // Generic bitfield type
 using bitset_t = std::bitset<8>;
 
@@ -19,6 +19,7 @@
 #include <string>
 #include <tuple>
 
+#include <flecsi/data/common/data_types.h>
 #include <flecsi/data/data_constants.h>
 #include <flecsi/data/storage.h>
 #include <flecsi/execution/context.h>
@@ -61,7 +62,8 @@ struct field_registration_wrapper__ {
         typeid(typename DATA_CLIENT_TYPE::type_identifier_t).hash_code();
 
     fi.storage_class = STORAGE_CLASS;
-    fi.size = sizeof(DATA_TYPE);
+    // the size of a value, also for structure-of-arrays sparse fields
+    fi.size = sizeof(typename sparse_value_type__<DATA_TYPE>::type);
     fi.namespace_hash = NAMESPACE_HASH;
     fi.name_hash = NAME_HASH;
     fi.versions = VERSIONS;
@@ -0,0 +1,72 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <cstddef>
+#include <limits>
+
+namespace flecsi {
+namespace data {
+
+/*!
+  A data handle resolved by a storage class get_handle() method. There is
+  one instance for each handle type and field, which are known at compile
+  time, so that after the first call, get_handle() returns a copy of the
+  resolved handle instead of looking up the field, its coloring and its
+  data in the context. The handle is valid while the handle generation of
+  the context is unchanged (see context__::handle_generation()).
+
+  @tparam HANDLE           The handle type.
+  @tparam DATA_CLIENT_TYPE The data client type.
+  @tparam NAMESPACE        The namespace key.
+  @tparam NAME             The field name.
+  @tparam VERSION          The field version.
+ */
+
+template<
+    typename HANDLE,
+    typename DATA_CLIENT_TYPE,
+    size_t NAMESPACE,
+    size_t NAME,
+    size_t VERSION>
+struct resolved_handle__ {
+  static constexpr size_t invalid = std::numeric_limits<size_t>::max();
+
+  bool valid(size_t generation) const {
+    return generation_ == generation;
+  }
+
+  void set(const HANDLE & handle, size_t generation) {
+    handle_ = handle;
+    generation_ = generation;
+  }
+
+  const HANDLE & handle() const {
+    return handle_;
+  }
+
+  static resolved_handle__ & instance() {
+    static resolved_handle__ r;
+    return r;
+  }
+
+private:
+  HANDLE handle_;
+  size_t generation_ = invalid;
+}; // struct resolved_handle__
+
+} // namespace data
+} // namespace flecsi
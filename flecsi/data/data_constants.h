@@ -15,6 +15,14 @@
 
 /*! @file */
 
+#include <cstddef>
+
+#include <flecsi-config.h>
+
+#if !defined(FLECSI_FIELD_ALIGNMENT)
+  #define FLECSI_FIELD_ALIGNMENT 64
+#endif
+
 namespace flecsi {
 namespace data {
 
@@ -35,5 +43,20 @@ enum storage_label_type_t : size_t {
   subspace
 }; // enum storage_label_type_t
 
+//----------------------------------------------------------------------------//
+//! The alignment in bytes of the storage of dense field data. The MPI
+//! runtime aligns each field to FLECSI_FIELD_ALIGNMENT bytes; other runtimes
+//! only guarantee the alignment of the data type.
+//----------------------------------------------------------------------------//
+
+#if FLECSI_RUNTIME_MODEL == FLECSI_RUNTIME_MODEL_mpi
+constexpr size_t field_alignment = FLECSI_FIELD_ALIGNMENT;
+#else
+constexpr size_t field_alignment = 1;
+#endif
+
+static_assert((field_alignment & (field_alignment - 1)) == 0,
+  "field alignment must be a power of two");
+
 } // namespace data
 } // namespace flecsi
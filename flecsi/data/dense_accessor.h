@@ -113,6 +113,38 @@ struct accessor__<
     return const_cast<accessor__ &>(*this)(index);
   }
 
+  //! The alignment in bytes of the data of the variable.
+  static constexpr size_t alignment =
+      data::field_alignment > alignof(T) ? data::field_alignment : alignof(T);
+
+  /*!
+   \brief Return a pointer to the data of the variable, i.e., its
+          exclusive, shared and ghost data, in this order, aligned to
+          \ref alignment bytes, so that the compiler can vectorize loops
+          over it.
+   */
+
+  T * data() {
+#ifndef MAPPER_COMPACTION
+#ifndef COMPACTED_STORAGE_SORT
+    T * d = handle.combined_data;
+#else
+    T * d = handle.combined_data_sort;
+#endif
+#else
+    T * d = handle.combined_data;
+#endif
+#if defined(__GNUC__)
+    return static_cast<T *>(__builtin_assume_aligned(d, alignment));
+#else
+    return d;
+#endif
+  }
+
+  const T * data() const {
+    return const_cast<accessor__ &>(*this).data();
+  }
+
   /*!
    \brief Return the index space size of the data variable
           referenced by this handle.
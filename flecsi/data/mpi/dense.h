@@ -30,6 +30,7 @@
 
 #include <flecsi/data/common/data_types.h>
 #include <flecsi/data/common/privilege.h>
+#include <flecsi/data/common/resolved_handle.h>
 #include <flecsi/data/data_client.h>
 #include <flecsi/data/dense_data_handle.h>
 #include <flecsi/execution/context.h>
@@ -150,10 +151,18 @@ struct storage_class__<dense>
     const data_client_t & data_client
   )
   {
-    handle_t<DATA_TYPE, 0, 0, 0> h;
-
     auto& context = execution::context_t::instance();
 
+    // After the first call, the handle is a copy of the resolved one.
+    auto& resolved = resolved_handle__<handle_t<DATA_TYPE, 0, 0, 0>,
+      DATA_CLIENT_TYPE, NAMESPACE, NAME, VERSION>::instance();
+
+    if (resolved.valid(context.handle_generation())) {
+      return resolved.handle();
+    }
+
+    handle_t<DATA_TYPE, 0, 0, 0> h;
+
     using client_type = typename DATA_CLIENT_TYPE::type_identifier_t;
 
     // get field_info for this data handle
@@ -170,12 +179,20 @@ struct storage_class__<dense>
     auto& registered_field_data = context.registered_field_data();
     auto fieldDataIter = registered_field_data.find(field_info.fid);
     if (fieldDataIter == registered_field_data.end()) {
-      size_t size = field_info.size * (color_info.exclusive +
-                                       color_info.shared +
-                                       color_info.ghost);
+      const size_t count = color_info.exclusive + color_info.shared +
+                           color_info.ghost;
+      size_t size = field_info.size * count;
       // TODO: deal with VERSION
       context.register_field_data(field_info.fid,
-                                  size);
+                                  size,
+                                  count);
+    }
+
+    // The metadata are dropped when the data are migrated to a new
+    // coloring (see mpi_context_policy_t::migrate_field_data).
+    auto& registered_field_metadata = context.registered_field_metadata();
+    if (registered_field_metadata.find(field_info.fid) ==
+      registered_field_metadata.end()) {
       context.register_field_metadata<DATA_TYPE>(field_info.fid,
                                                  color_info,
                                                  index_coloring);
@@ -202,6 +219,8 @@ struct storage_class__<dense>
     hb.ghost_data = hb.ghost_buf = hb.shared_data + hb.shared_size;
     hb.combined_size += color_info.ghost;
 
+    resolved.set(h, context.handle_generation());
+
     return h;
   }
 
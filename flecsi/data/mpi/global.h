@@ -25,6 +25,7 @@
 //----------------------------------------------------------------------------//
 
 #include <flecsi/data/common/privilege.h>
+#include <flecsi/data/common/resolved_handle.h>
 #include <flecsi/data/data_client.h>
 #include <flecsi/data/global_data_handle.h>
 #include <flecsi/data/storage.h>
@@ -160,9 +161,20 @@ struct storage_class__<global> {
   static handle_t<DATA_TYPE, 0>
   get_handle(const data_client_handle__<DATA_CLIENT_TYPE, PERMISSIONS> &
                  client_handle) {
-    handle_t<DATA_TYPE, 0> h;
     auto & context = execution::context_t::instance();
 
+    // After the first call, the handle is a copy of the resolved one.
+    auto & resolved = resolved_handle__<handle_t<DATA_TYPE, 0>,
+        DATA_CLIENT_TYPE, NAMESPACE, NAME, VERSION>::instance();
+
+    if (resolved.valid(context.handle_generation())) {
+      handle_t<DATA_TYPE, 0> h = resolved.handle();
+      h.state = context.execution_state();
+      return h;
+    }
+
+    handle_t<DATA_TYPE, 0> h;
+
     auto & field_info = context.get_field_info_from_name(
         typeid(typename DATA_CLIENT_TYPE::type_identifier_t).hash_code(),
         utils::hash::field_hash<NAMESPACE, NAME>(VERSION));
@@ -185,6 +197,8 @@ struct storage_class__<global> {
     h.global = true;
     h.state = context.execution_state();
 
+    resolved.set(h, context.handle_generation());
+
     return h;
   }
 
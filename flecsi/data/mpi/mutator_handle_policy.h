@@ -37,6 +37,12 @@ struct mpi_mutator_handle_policy_t
   // an entry is entry ID and data type value, this buffer is sized according
   // to the size print entry times total number of entries
   std::vector<uint8_t>* entries;
+  // the values, if they are stored separately from the entry IDs
+  std::vector<uint8_t>* values;
+  // the back buffers, into which the commit merges, with the same sizes
+  std::vector<offset_t>* back_offsets;
+  std::vector<uint8_t>* back_entries;
+  std::vector<uint8_t>* back_values;
   // the reserve includes the current number of allocated exclusive
   // entries plus those unused
   size_t* reserve;
@@ -46,6 +52,8 @@ struct mpi_mutator_handle_policy_t
   // the current number of actually used exclusive entries within the
   // reserve buffer
   size_t* num_exclusive_entries;
+  // the cached transpose of the field, which the commit invalidates
+  data::sparse_transpose_t* transpose;
 }; // class mpi_mutator_handle_policy_t
 
 } // namespace flecsi
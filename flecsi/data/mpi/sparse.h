@@ -17,6 +17,7 @@
 
 #include <flecsi/data/common/data_types.h>
 #include <flecsi/data/common/privilege.h>
+#include <flecsi/data/common/resolved_handle.h>
 #include <flecsi/data/data_client.h>
 #include <flecsi/data/mutator_handle.h>
 #include <flecsi/data/sparse_data_handle.h>
@@ -74,6 +75,8 @@ struct sparse_handle__ : public sparse_data_handle__<T, EP, SP, GP>
   // Constructors.
   //--------------------------------------------------------------------------//
 
+  sparse_handle__() {}
+
   sparse_handle__(
     size_t num_exclusive,
     size_t num_shared,
@@ -136,6 +139,15 @@ struct storage_class__<sparse>
 
     auto& context = execution::context_t::instance();
 
+    // After the first call, the handle is a copy of the resolved one; the
+    // task prolog updates it from the field data, which mutators change.
+    auto& resolved = resolved_handle__<handle__<DATA_TYPE, 0, 0, 0>,
+      DATA_CLIENT_TYPE, NAMESPACE, NAME, VERSION>::instance();
+
+    if (resolved.valid(context.handle_generation())) {
+      return resolved.handle();
+    }
+
     using client_type = typename DATA_CLIENT_TYPE::type_identifier_t;
 
     // get field_info for this data handle
@@ -150,7 +162,6 @@ struct storage_class__<sparse>
     if (fieldDataIter == registered_sparse_field_data.end()) {
       // get color_info for this field.
       auto& color_info = (context.coloring_info(field_info.index_space)).at(context.color());
-      auto &index_coloring = context.coloring(field_info.index_space);
 
       auto& im = context.sparse_index_space_info_map();
       auto iitr = im.find(field_info.index_space);
@@ -163,12 +174,23 @@ struct storage_class__<sparse>
       const size_t max_entries_per_index = iitr->second.max_entries_per_index;
       const size_t reserve_chunk = iitr->second.reserve_chunk;
 
+      using entries_t = sparse_entries__<DATA_TYPE>;
+
       // TODO: deal with VERSION
-      context.register_sparse_field_data(field_info.fid, field_info.size,
-        color_info, max_entries_per_index, reserve_chunk);
+      context.register_sparse_field_data(field_info.fid,
+        entries_t::entry_bytes, entries_t::value_bytes, color_info,
+        max_entries_per_index, reserve_chunk);
+    }
 
-      context.register_sparse_field_metadata<DATA_TYPE>(
-        field_info.fid, color_info, index_coloring);
+    // The metadata are dropped when the data are migrated to a new
+    // coloring (see mpi_context_policy_t::migrate_sparse_field_data).
+    auto& registered_sparse_field_metadata =
+      context.registered_sparse_field_metadata();
+    if (registered_sparse_field_metadata.find(field_info.fid) ==
+      registered_sparse_field_metadata.end()) {
+      context.register_sparse_field_metadata<DATA_TYPE>(field_info.fid,
+        context.coloring_info(field_info.index_space).at(context.color()),
+        context.coloring(field_info.index_space));
     }
 
     auto& fd = registered_sparse_field_data[field_info.fid];
@@ -183,13 +205,16 @@ struct storage_class__<sparse>
     hb.data_client_hash = field_info.data_client_hash;
 
     hb.entries =
-      reinterpret_cast<sparse_entry_value__<DATA_TYPE>*>(&fd.entries[0]);
+      sparse_entries__<DATA_TYPE>(fd.entries.data(), fd.values.data());
 
     hb.offsets = &fd.offsets[0];
+    hb.transpose = &fd.transpose;
     hb.max_entries_per_index = fd.max_entries_per_index;
     hb.reserve = fd.reserve;
     hb.num_exclusive_entries = fd.num_exclusive_entries;
 
+    resolved.set(h, context.handle_generation());
+
     return h;
   }
 
@@ -224,7 +249,6 @@ struct storage_class__<sparse>
 
       // get color_info for this field.
       auto& color_info = (context.coloring_info(field_info.index_space)).at(context.color());
-      auto &index_coloring = context.coloring(field_info.index_space);
 
       auto& im = context.sparse_index_space_info_map();
       auto iitr = im.find(field_info.index_space);
@@ -237,12 +261,23 @@ struct storage_class__<sparse>
       const size_t max_entries_per_index = iitr->second.max_entries_per_index;
       const size_t reserve_chunk = iitr->second.reserve_chunk;
 
+      using entries_t = sparse_entries__<DATA_TYPE>;
+
       // TODO: deal with VERSION
-      context.register_sparse_field_data(field_info.fid, field_info.size,
-        color_info, max_entries_per_index, reserve_chunk);
+      context.register_sparse_field_data(field_info.fid,
+        entries_t::entry_bytes, entries_t::value_bytes, color_info,
+        max_entries_per_index, reserve_chunk);
+    }
 
-      context.register_sparse_field_metadata<DATA_TYPE>(
-        field_info.fid, color_info, index_coloring);
+    // The metadata are dropped when the data are migrated to a new
+    // coloring (see mpi_context_policy_t::migrate_sparse_field_data).
+    auto& registered_sparse_field_metadata =
+      context.registered_sparse_field_metadata();
+    if (registered_sparse_field_metadata.find(field_info.fid) ==
+      registered_sparse_field_metadata.end()) {
+      context.register_sparse_field_metadata<DATA_TYPE>(field_info.fid,
+        context.coloring_info(field_info.index_space).at(context.color()),
+        context.coloring(field_info.index_space));
     }
 
     auto& fd = registered_sparse_field_data[field_info.fid];
@@ -256,10 +291,22 @@ struct storage_class__<sparse>
 
     h.offsets = &fd.offsets;
     h.entries = &fd.entries;
+    h.values = &fd.values;
+    h.back_offsets = &fd.back_offsets;
+    h.back_entries = &fd.back_entries;
+    h.back_values = &fd.back_values;
+    h.transpose = &fd.transpose;
     h.reserve = &fd.reserve;
     h.reserve_chunk = fd.reserve_chunk;
     h.num_exclusive_entries = &fd.num_exclusive_entries;
-    h.num_exclusive_insertions = new size_t(0);
+
+    using insertions_t = typename mutator_handle__<DATA_TYPE>::insertions_t;
+
+    if (!fd.mutator_insertions) {
+      fd.mutator_insertions = std::make_shared<insertions_t>();
+    }
+
+    h.insertions_ = static_cast<insertions_t *>(fd.mutator_insertions.get());
 
     return h;
   }
@@ -19,8 +19,10 @@
 #include <cstring>
 #include <limits>
 #include <map>
+#include <utility>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #include <flecsi/data/common/data_types.h>
 
@@ -29,22 +31,24 @@ namespace flecsi {
 //----------------------------------------------------------------------------//
 //! This class is used to implement the mutator for sparse data. It contains
 //! methods which implement commit functionality to pack the mutator's
-//! temporary slots and spare (overflow) map into the final commit buffer.
+//! temporary slots and overflow buffer into the final commit buffer.
 //! This class implements functionality for both normal sparse data and the
-//! ragged sparse data type.
+//! ragged sparse data type. The slots and the overflow always hold
+//! sparse_entry_value__ pairs; only the committed data is stored in the
+//! layout of T (see data::sparse_soa__).
 //----------------------------------------------------------------------------//
 
 template<typename T, typename MUTATOR_POLICY>
 class mutator_handle_base__ : public MUTATOR_POLICY {
 public:
-  using entry_value_t = data::sparse_entry_value__<T>;
+  using entries_t = data::sparse_entries__<T>;
+  using value_t = typename entries_t::value_t;
+  using entry_value_t = typename entries_t::entry_value_t;
 
   using offset_t = data::sparse_data_offset_t;
 
   using index_t = uint64_t;
 
-  size_t * num_exclusive_insertions;
-
   struct partition_info_t {
     size_t count[3];
     size_t start[3];
@@ -53,7 +57,13 @@ public:
 
   struct commit_info_t {
     offset_t * offsets;
-    entry_value_t * entries[3];
+    entries_t entries[3];
+
+    // The back buffers, with the same layout as offsets and entries: the
+    // commit merges the existing entries and the insertions into them, and
+    // the caller then swaps the front and back buffers.
+    offset_t * back_offsets;
+    entries_t back_entries;
   };
 
   //--------------------------------------------------------------------------//
@@ -87,280 +97,160 @@ public:
 
   ~mutator_handle_base__() {}
 
+  //--------------------------------------------------------------------------//
+  //! Attach the mutator to the storage for its insertions, which the
+  //! runtime keeps across commits (see insertions_t).
+  //--------------------------------------------------------------------------//
+
   void init() {
-    offsets_ = new offset_t[num_entries_];
-    entries_ = new entry_value_t[num_entries_ * num_slots_];
-    spare_map_ = new spare_map_t;
+    assert(insertions_ && "no storage for the mutator insertions");
+
+    insertions_->offsets.resize(num_entries_);
+    insertions_->entries.resize(num_entries_ * num_slots_);
+
+    offsets_ = insertions_->offsets.data();
+    entries_ = insertions_->entries.data();
+    overflow_ = &insertions_->overflow;
   }
 
-  void commit(commit_info_t * ci) {
+  //--------------------------------------------------------------------------//
+  //! Merge the changes into the back buffers. Before anything is written
+  //! to them, grow is called with the number of exclusive entries after
+  //! the commit: it must make room for them in the front and back buffers,
+  //! and update ci if the buffers move.
+  //--------------------------------------------------------------------------//
+
+  template<typename GROW>
+  void commit(commit_info_t * ci, GROW && grow) {
     if (erase_set_) {
-      commit_<true>(ci);
+      commit_<true>(ci, grow);
     } else {
       if (ragged_changes_map_) {
-        raggedCommit_(ci);
+        raggedCommit_(ci, grow);
       } else {
-        commit_<false>(ci);
+        commit_<false>(ci, grow);
       }
     }
   } // operator ()
 
-  template<bool ERASE>
-  void commit_(commit_info_t * ci) {
-    assert(offsets_ && "uninitialized mutator");
-    ci_ = *ci;
-
-    size_t num_exclusive_entries = ci->entries[1] - ci->entries[0];
-
-    entry_value_t * entries = ci->entries[0];
-    offset_t * offsets = ci->offsets;
-
-    entry_value_t * cbuf = new entry_value_t[num_exclusive_entries];
-
-    entry_value_t * cptr = cbuf;
-    entry_value_t * eptr = entries;
-
-    size_t offset = 0;
+  //--------------------------------------------------------------------------//
+  //! Merge the existing entries, the slots and the overflow of each index
+  //! into the back buffers. The merged exclusive entries are packed in
+  //! index order, at offsets given by a prefix sum over the merged counts;
+  //! the shared and ghost indices keep their fixed offsets. The rows are
+  //! independent, and are merged concurrently with OpenMP.
+  //--------------------------------------------------------------------------//
 
-    for (size_t i = 0; i < num_exclusive_; ++i) {
-      const offset_t & oi = offsets_[i];
-      offset_t & coi = offsets[i];
+  template<bool ERASE, typename GROW>
+  void commit_(commit_info_t * ci, GROW & grow) {
+    assert(offsets_ && "uninitialized mutator");
 
-      entry_value_t * sptr = entries_ + i * num_slots_;
+    sort_overflow_();
 
-      size_t num_existing = coi.count();
-      size_t used_slots = oi.count();
+    const offset_t * offsets = ci->offsets;
+    offset_t * back_offsets = ci->back_offsets;
 
-      size_t num_merged =
-          merge<ERASE>(i, eptr, num_existing, sptr, used_slots, cptr);
+    entries_t entries = ci->entries[0];
 
-      eptr += num_existing;
-      coi.set_offset(offset);
+    const long num_exclusive = num_exclusive_;
+    const long num_entries = num_entries_;
 
-      if (num_merged > 0) {
-        cptr += num_merged;
-        coi.set_count(num_merged);
-        offset += num_merged;
-      }
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < num_exclusive; ++i) {
+      back_offsets[i].set_count(
+          merge<ERASE>(i, entries + offsets[i].start(), offsets[i].count(),
+              count_t()));
     }
 
-    assert(cptr - cbuf <= num_exclusive_entries);
-    std::memcpy(entries, cbuf, sizeof(entry_value_t) * (cptr - cbuf));
-    delete[] cbuf;
-
-    size_t start = num_exclusive_;
-    size_t end = start + pi_.count[1] + pi_.count[2];
-
-    cbuf = new entry_value_t[max_entries_per_index_];
-
-    for (size_t i = start; i < end; ++i) {
-      const offset_t & oi = offsets_[i];
-      offset_t & coi = offsets[i];
-
-      entry_value_t * eptr = entries + coi.start();
+    size_t offset = 0;
 
-      entry_value_t * sptr = entries_ + i * num_slots_;
+    for (long i = 0; i < num_exclusive; ++i) {
+      back_offsets[i].set_offset(offset);
+      offset += back_offsets[i].count();
+    }
 
-      size_t num_existing = coi.count();
+    grow(offset);
 
-      size_t used_slots = oi.count();
+    ci_ = *ci;
+    entries = ci->entries[0];
+    entries_t back = ci->back_entries;
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < num_entries; ++i) {
+      const offset_t & oi = offsets[i];
+
+      if (i < num_exclusive) {
+        merge<ERASE>(i, entries + oi.start(), oi.count(),
+            back + back_offsets[i].start());
+      } else {
+        back_offsets[i] = oi;
 
-      size_t num_merged =
-          merge<ERASE>(i, eptr, num_existing, sptr, used_slots, cbuf);
+        size_t num_merged =
+            merge<ERASE>(i, entries + oi.start(), oi.count(), back + oi.start());
 
-      if (num_merged > 0) {
-        assert(num_merged <= max_entries_per_index_);
-        std::memcpy(eptr, cbuf, sizeof(entry_value_t) * num_merged);
-        coi.set_count(num_merged);
+        assert(num_merged <= max_entries_per_index_ &&
+               "sparse data: exceeded max_entries_per_index in shared/ghost");
+        back_offsets[i].set_count(num_merged);
       }
     }
 
-    delete[] cbuf;
-
-    delete[] entries_;
-    entries_ = nullptr;
-
-    delete[] offsets_;
-    offsets_ = nullptr;
-
-    delete spare_map_;
-    spare_map_ = nullptr;
-
-    if (erase_set_) {
-      delete erase_set_;
-      erase_set_ = nullptr;
-    }
+    release_();
   }
 
-  void raggedCommit_(commit_info_t * ci) {
-    assert(offsets_ && "uninitialized mutator");
-
-    size_t num_exclusive_entries = ci->entries[1] - ci->entries[0];
+  //--------------------------------------------------------------------------//
+  //! The ragged version of commit_(): the size of each index is known from
+  //! its changes, so only the prefix sum precedes the concurrent merge.
+  //--------------------------------------------------------------------------//
 
-    entry_value_t * entries = ci->entries[0];
-    offset_t * offsets = ci->offsets;
+  template<typename GROW>
+  void raggedCommit_(commit_info_t * ci, GROW & grow) {
+    assert(offsets_ && "uninitialized mutator");
 
-    for (auto & itr : *ragged_changes_map_) {
-      num_exclusive_entries +=
-          int64_t(itr.second.size) - int64_t(offsets[itr.first].count());
-    }
+    sort_overflow_();
 
-    entry_value_t * cbuf = new entry_value_t[num_exclusive_entries];
+    const offset_t * offsets = ci->offsets;
+    offset_t * back_offsets = ci->back_offsets;
 
-    entry_value_t * cptr = cbuf;
-    entry_value_t * eptr = entries;
+    const long num_exclusive = num_exclusive_;
+    const long num_entries = num_entries_;
 
     size_t offset = 0;
 
-    for (size_t index = 0; index < num_exclusive_; ++index) {
-      const offset_t & oi = offsets_[index];
-      offset_t & coi = offsets[index];
-
-      entry_value_t * sptr = entries_ + index * num_slots_;
-
-      size_t num_existing = coi.count();
-      size_t used_slots = oi.count();
-
-      auto citr = ragged_changes_map_->find(index);
-
-      ragged_changes_t * changes;
-
-      if (citr != ragged_changes_map_->end()) {
-        changes = &citr->second;
-        apply_raggged_changes(changes, cptr, eptr, num_existing);
-      } else {
-        changes = nullptr;
-        std::memcpy(cptr, eptr, sizeof(entry_value_t) * num_existing);
-      }
-
-      for (size_t j = 0; j < used_slots; ++j) {
-        size_t k = sptr[j].entry;
-        cptr[k].entry = k;
-        cptr[k].value = sptr[j].value;
-      }
-
-      auto p = spare_map_->equal_range(index);
-      auto itr = p.first;
-      auto itr_end = p.second;
-      while (itr != itr_end) {
-        size_t k = itr->second.entry;
-        cptr[k].entry = k;
-        cptr[k].value = itr->second.value;
-        ++itr;
-      }
-
-      coi.set_offset(offset);
-
-      if (changes) {
-        size_t resize = changes->size;
-
-        if (changes->push_values) {
-          std::vector<T> & values = *changes->push_values;
-          size_t ri = resize - values.size();
-          for (auto & vi : values) {
-            cptr[ri].entry = ri;
-            cptr[ri++].value = vi;
-          }
-        }
-
-        coi.set_count(resize);
-        offset += resize;
-        cptr += resize;
-      } else {
-        offset += num_existing;
-        cptr += num_existing;
-      }
-
-      eptr += num_existing;
+    for (long i = 0; i < num_exclusive; ++i) {
+      back_offsets[i].set_offset(offset);
+      back_offsets[i].set_count(ragged_size_(i, offsets[i].count()));
+      offset += back_offsets[i].count();
     }
 
-    std::memcpy(entries, cbuf, sizeof(entry_value_t) * (cptr - cbuf));
-    delete[] cbuf;
-
-    size_t start = num_exclusive_;
-    size_t end = start + pi_.count[1] + pi_.count[2];
-
-    cbuf = new entry_value_t[max_entries_per_index_];
-
-    for (size_t index = start; index < end; ++index) {
-      entry_value_t * eptr = ci->entries[1] + max_entries_per_index_ * index;
-
-      const offset_t & oi = offsets_[index];
-      offset_t & coi = offsets[index];
+    grow(offset);
 
-      entry_value_t * sptr = entries_ + index * num_slots_;
-
-      size_t num_existing = coi.count();
-
-      size_t used_slots = oi.count();
-
-      auto citr = ragged_changes_map_->find(index);
-
-      ragged_changes_t * changes;
-
-      if (citr != ragged_changes_map_->end()) {
-        changes = &citr->second;
-        apply_raggged_changes(changes, cbuf, eptr, num_existing);
-      } else {
-        changes = nullptr;
-        std::memcpy(cbuf, eptr, sizeof(entry_value_t) * num_existing);
-      }
-
-      for (size_t j = 0; j < used_slots; ++j) {
-        size_t k = sptr[j].entry;
-        cbuf[k].entry = k;
-        cbuf[k].value = sptr[j].value;
-      }
-
-      auto p = spare_map_->equal_range(index);
-      auto itr = p.first;
-      auto itr_end = p.second;
-      while (itr != itr_end) {
-        size_t k = itr->second.entry;
-        cbuf[k].entry = k;
-        cbuf[k].value = itr->second.value;
-        ++itr;
-      }
-
-      size_t size;
-
-      if (changes) {
-        size = changes->size;
+    ci_ = *ci;
+    entries_t entries = ci->entries[0];
+    entries_t back = ci->back_entries;
 
-        assert(
-            size <= max_entries_per_index_ &&
-            "ragged data: exceeded max_entries_per_index in shared/ghost");
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < num_entries; ++i) {
+      const offset_t & oi = offsets[i];
 
-        if (changes->push_values) {
-          std::vector<T> & values = *changes->push_values;
-          size_t ri = size - values.size();
-          for (auto & vi : values) {
-            cptr[ri].entry = ri;
-            cptr[ri++].value = vi;
-          }
-        }
+      if (i >= num_exclusive) {
+        back_offsets[i] = oi;
+        back_offsets[i].set_count(ragged_size_(i, oi.count()));
 
-        coi.set_count(size);
-      } else {
-        size = num_existing;
+        assert(back_offsets[i].count() <= max_entries_per_index_ &&
+               "ragged data: exceeded max_entries_per_index in shared/ghost");
       }
 
-      std::memcpy(eptr, cbuf, sizeof(entry_value_t) * size);
+      ragged_merge_(i, entries + oi.start(), oi.count(),
+          back + back_offsets[i].start());
     }
 
-    delete[] cbuf;
-
-    delete[] entries_;
-    entries_ = nullptr;
-
-    delete[] offsets_;
-    offsets_ = nullptr;
-
-    delete spare_map_;
-    spare_map_ = nullptr;
-
-    delete ragged_changes_map_;
-    ragged_changes_map_ = nullptr;
+    release_();
   }
 
   size_t num_exclusive() const {
@@ -390,6 +280,17 @@ public:
   struct ragged_changes_t {
     ragged_changes_t(size_t size) : size(size) {}
 
+    // The changes own their containers, and are moved into the map.
+    ragged_changes_t(ragged_changes_t && c)
+        : size(c.size), erase_set(c.erase_set), push_values(c.push_values),
+          insert_values(c.insert_values) {
+      c.erase_set = nullptr;
+      c.push_values = nullptr;
+      c.insert_values = nullptr;
+    }
+
+    ragged_changes_t(const ragged_changes_t &) = delete;
+
     ~ragged_changes_t() {
       if (erase_set) {
         delete erase_set;
@@ -406,26 +307,38 @@ public:
 
     size_t size;
     std::set<size_t> * erase_set = nullptr;
-    std::vector<T> * push_values = nullptr;
-    std::map<size_t, T> * insert_values = nullptr;
+    std::vector<value_t> * push_values = nullptr;
+    std::map<size_t, value_t> * insert_values = nullptr;
 
     void init_erase_set() {
       erase_set = new std::set<size_t>;
     }
 
     void init_push_values() {
-      push_values = new std::vector<T>;
+      push_values = new std::vector<value_t>;
     }
 
     void init_insert_values() {
-      insert_values = new std::map<size_t, T>;
+      insert_values = new std::map<size_t, value_t>;
     }
   };
 
-  using spare_map_t = std::multimap<size_t, entry_value_t>;
+  // Insertions beyond the slots of an index, in insertion order, until
+  // the commit sorts them by index and entry.
+  using overflow_entry_t = std::pair<size_t, entry_value_t>;
+  using overflow_t = std::vector<overflow_entry_t>;
   using erase_set_t = std::set<std::pair<size_t, size_t>>;
   using ragged_changes_map_t = std::unordered_map<size_t, ragged_changes_t>;
 
+  // The slots of each index, their counts, and the overflow. The runtime
+  // keeps them with the back buffers, so that they are allocated once and
+  // cleared by each commit.
+  struct insertions_t {
+    std::vector<offset_t> offsets;
+    std::vector<entry_value_t> entries;
+    overflow_t overflow;
+  };
+
   partition_info_t pi_;
   size_t num_exclusive_;
   size_t max_entries_per_index_;
@@ -433,91 +346,254 @@ public:
   size_t num_entries_;
   offset_t * offsets_ = nullptr;
   entry_value_t * entries_ = nullptr;
-  spare_map_t * spare_map_ = nullptr;
+  overflow_t * overflow_ = nullptr;
+  insertions_t * insertions_ = nullptr;
   erase_set_t * erase_set_ = nullptr;
   ragged_changes_map_t * ragged_changes_map_ = nullptr;
   commit_info_t ci_;
 
   //--------------------------------------------------------------------------//
-  //! This is a helper method to commit() to merge both the slots buffer
-  //! overflow/spare map, an existing buffer, into the destination buffer,
-  //! giving precedence first to the spare map, then slots, then existing.
+  //! A destination for merge() that only counts the merged entries.
+  //--------------------------------------------------------------------------//
+
+  struct count_t {
+    void set(size_t, size_t, const value_t &) const {}
+  };
+
+  //--------------------------------------------------------------------------//
+  //! Sort the overflow by index and entry, keeping the last insertion of
+  //! an entry that was inserted more than once, and record the start of
+  //! the overflow of each index in the (otherwise unused) offsets of the
+  //! slots.
+  //--------------------------------------------------------------------------//
+
+  void sort_overflow_() {
+    overflow_t & o = *overflow_;
+
+    auto less = [](const overflow_entry_t & e1, const overflow_entry_t & e2) {
+      return e1.first < e2.first ||
+             (e1.first == e2.first && e1.second.entry < e2.second.entry);
+    };
+
+    // Insertions usually come in index order.
+    if (!std::is_sorted(o.begin(), o.end(), less)) {
+      std::stable_sort(o.begin(), o.end(), less);
+    }
+
+    size_t n = 0;
+
+    for (size_t i = 0; i < o.size(); ++i) {
+      if (n > 0 && o[n - 1].first == o[i].first &&
+          o[n - 1].second.entry == o[i].second.entry) {
+        o[n - 1] = o[i];
+      } else {
+        o[n++] = o[i];
+      }
+    }
+
+    o.resize(n);
+
+    size_t k = 0;
+
+    for (size_t index = 0; index < num_entries_; ++index) {
+      offsets_[index].set_offset(k);
+
+      while (k < n && o[k].first == index) {
+        ++k;
+      }
+    }
+  }
+
+  //--------------------------------------------------------------------------//
+  //! The sorted overflow entries of an index.
+  //--------------------------------------------------------------------------//
+
+  std::pair<const overflow_entry_t *, const overflow_entry_t *>
+  overflow_range_(size_t index) const {
+    const overflow_t & o = *overflow_;
+
+    const size_t end =
+        index + 1 < num_entries_ ? offsets_[index + 1].start() : o.size();
+
+    return {o.data() + offsets_[index].start(), o.data() + end};
+  }
+
+  //--------------------------------------------------------------------------//
+  //! Clear the insertions, keeping their storage for the next mutator, and
+  //! free the changes.
   //--------------------------------------------------------------------------//
 
-  template<bool ERASE>
+  void release_() {
+    std::fill(offsets_, offsets_ + num_entries_, offset_t());
+    offsets_ = nullptr;
+    entries_ = nullptr;
+
+    overflow_->clear();
+    overflow_ = nullptr;
+
+    if (erase_set_) {
+      delete erase_set_;
+      erase_set_ = nullptr;
+    }
+
+    if (ragged_changes_map_) {
+      delete ragged_changes_map_;
+      ragged_changes_map_ = nullptr;
+    }
+  }
+
+  //--------------------------------------------------------------------------//
+  //! This is a helper method to commit() to merge the overflow, the slots
+  //! and the existing entries of an index into the destination, giving
+  //! precedence first to the overflow, then slots, then existing. It
+  //! returns the number of merged entries.
+  //--------------------------------------------------------------------------//
+
+  template<bool ERASE, typename DEST>
   size_t merge(
       size_t index,
-      entry_value_t * existing,
+      entries_t existing,
       size_t num_existing,
-      entry_value_t * slots,
-      size_t num_slots,
-      entry_value_t * dest) {
+      const DEST & dest) const {
 
     constexpr size_t end = std::numeric_limits<size_t>::max();
-    entry_value_t * existing_end = existing + num_existing;
-    entry_value_t * slots_end = slots + num_slots;
 
-    entry_value_t * dest_start = dest;
+    const entry_value_t * slots = entries_ + index * num_slots_;
+    const entry_value_t * slots_end = slots + offsets_[index].count();
+
+    size_t ei = 0;
+    size_t di = 0;
 
-    auto p = spare_map_->equal_range(index);
+    auto p = overflow_range_(index);
     auto itr = p.first;
 
     size_t spare_entry = itr != p.second ? itr->second.entry : end;
     size_t slot_entry = slots < slots_end ? slots->entry : end;
-    size_t existing_entry = existing < existing_end ? existing->entry : end;
+    size_t existing_entry = ei < num_existing ? existing.entry(ei) : end;
+
+    // An existing entry is replaced by an insertion of the same entry.
+    auto skip_existing = [&](size_t entry) {
+      if (existing_entry == entry) {
+        existing_entry = ++ei < num_existing ? existing.entry(ei) : end;
+      }
+    };
 
     for (;;) {
       if (spare_entry < end && spare_entry <= slot_entry &&
           spare_entry <= existing_entry) {
 
-        dest->entry = spare_entry;
-        dest->value = itr->second.value;
-        ++dest;
+        dest.set(di++, spare_entry, itr->second.value);
 
         while (slot_entry == spare_entry) {
           slot_entry = ++slots < slots_end ? slots->entry : end;
         }
 
-        while (existing_entry == slot_entry ||
-               (ERASE && erase_set_->find(std::make_pair(
-                             index, existing_entry)) != erase_set_->end())) {
-          existing_entry = ++existing < existing_end ? existing->entry : end;
-        }
+        skip_existing(spare_entry);
 
         spare_entry = ++itr != p.second ? itr->second.entry : end;
       } else if (slot_entry < end && slot_entry <= existing_entry) {
-        dest->entry = slot_entry;
-        dest->value = slots->value;
-        ++dest;
-
-        while (existing_entry == slot_entry ||
-               (ERASE && erase_set_->find(std::make_pair(
-                             index, existing_entry)) != erase_set_->end())) {
-          existing_entry = ++existing < existing_end ? existing->entry : end;
-        }
+        dest.set(di++, slot_entry, slots->value);
+
+        skip_existing(slot_entry);
 
         slot_entry = ++slots < slots_end ? slots->entry : end;
       } else if (existing_entry < end) {
-        dest->entry = existing_entry;
-        dest->value = existing->value;
-        ++dest;
+        if (ERASE && erase_set_->find(std::make_pair(index, existing_entry)) !=
+                         erase_set_->end()) {
+          existing_entry = ++ei < num_existing ? existing.entry(ei) : end;
+          continue;
+        }
+
+        dest.set(di++, existing_entry, existing.value(ei));
 
-        existing_entry = ++existing < existing_end ? existing->entry : end;
+        existing_entry = ++ei < num_existing ? existing.entry(ei) : end;
       } else {
         break;
       }
     }
 
-    return dest - dest_start;
+    return di;
+  }
+
+  //--------------------------------------------------------------------------//
+  //! The size of a ragged index with num_existing entries after the commit.
+  //--------------------------------------------------------------------------//
+
+  size_t ragged_size_(size_t index, size_t num_existing) const {
+    auto citr = ragged_changes_map_->find(index);
+    return citr != ragged_changes_map_->end() ? citr->second.size
+                                              : num_existing;
+  }
+
+  //--------------------------------------------------------------------------//
+  //! The ragged version of merge(): apply the resizes, erasures and
+  //! insertions of the index to its existing entries, then write the slots,
+  //! the overflow, and the values pushed back. Nothing is written beyond
+  //! the new size of the index, which is where the next index starts.
+  //--------------------------------------------------------------------------//
+
+  void ragged_merge_(
+      size_t index,
+      entries_t existing,
+      size_t num_existing,
+      entries_t dest) const {
+    auto citr = ragged_changes_map_->find(index);
+
+    const ragged_changes_t * changes =
+        citr != ragged_changes_map_->end() ? &citr->second : nullptr;
+
+    const size_t size = changes ? changes->size : num_existing;
+
+    if (changes) {
+      apply_raggged_changes(changes, dest, existing, num_existing);
+    } else {
+      dest.copy(existing, num_existing);
+    }
+
+    const entry_value_t * slots = entries_ + index * num_slots_;
+
+    for (size_t j = 0; j < offsets_[index].count(); ++j) {
+      size_t k = slots[j].entry;
+      if (k < size) {
+        dest.set(k, k, slots[j].value);
+      }
+    }
+
+    auto p = overflow_range_(index);
+
+    for (auto itr = p.first; itr != p.second; ++itr) {
+      size_t k = itr->second.entry;
+      if (k < size) {
+        dest.set(k, k, itr->second.value);
+      }
+    }
+
+    if (changes && changes->push_values) {
+      const std::vector<value_t> & values = *changes->push_values;
+      size_t ri = size - values.size();
+      for (auto & vi : values) {
+        dest.set(ri, ri, vi);
+        ++ri;
+      }
+    }
   }
 
   void apply_raggged_changes(
-      ragged_changes_t * changes,
-      entry_value_t * cptr,
-      entry_value_t * eptr,
-      size_t num_existing) {
+      const ragged_changes_t * changes,
+      entries_t cptr,
+      entries_t eptr,
+      size_t num_existing) const {
+    const size_t size = changes->size;
+
     size_t ri = 0;
 
+    auto put = [&](const value_t & value) {
+      if (ri < size) {
+        cptr.set(ri, ri, value);
+        ++ri;
+      }
+    };
+
     if (changes->insert_values && changes->erase_set) {
       auto iitr = changes->insert_values->begin();
       auto iitr_end = changes->insert_values->end();
@@ -527,15 +603,14 @@ public:
 
       for (size_t j = 0; j < num_existing; ++j) {
         if (iitr != iitr_end && iitr->first == j) {
-          std::memcpy(&cptr[ri], &iitr->second, sizeof(iitr->second));
-          ++ri;
+          put(iitr->second);
           ++iitr;
         }
 
         if (eitr != eitr_end && *eitr == j) {
           ++eitr;
         } else {
-          cptr[ri++] = eptr[j];
+          put(eptr.value(j));
         }
       }
     } else if (changes->insert_values) {
@@ -544,11 +619,11 @@ public:
 
       for (size_t j = 0; j < num_existing; ++j) {
         if (iitr != iitr_end && iitr->first == j) {
-          cptr[ri++].value = iitr->second;
+          put(iitr->second);
           ++iitr;
         }
 
-        cptr[ri++] = eptr[j];
+        put(eptr.value(j));
       }
     } else if (changes->erase_set) {
       auto eitr = changes->erase_set->begin();
@@ -558,13 +633,11 @@ public:
         if (eitr != eitr_end && *eitr == j) {
           ++eitr;
         } else {
-          cptr[ri++] = eptr[j];
+          put(eptr.value(j));
         }
       }
     } else {
-      for (size_t j = 0; j < num_existing; ++j) {
-        cptr[ri++] = eptr[j];
-      }
+      cptr.copy(eptr, std::min(num_existing, size));
     }
   }
 };
@@ -71,6 +71,7 @@ struct accessor__<
       GHOST_PERMISSIONS>;
 
   using offset_t = typename base_t::offset_t;
+  using value_type = typename base_t::value_type;
 
   //--------------------------------------------------------------------------//
   //! Copy constructor.
@@ -78,12 +79,12 @@ struct accessor__<
 
   accessor__(const sparse_data_handle__<T, 0, 0, 0> & h) : base_t(h) {}
 
-  T & operator()(size_t index, size_t ragged_index) {
+  value_type & operator()(size_t index, size_t ragged_index) {
     const offset_t & offset = base_t::handle.offsets[index];
     assert(
         ragged_index < offset.count() && "ragged accessor: index out of range");
 
-    return (base_t::handle.entries + offset.start() + ragged_index)->value;
+    return base_t::handle.entries.value(offset.start() + ragged_index);
   } // operator ()
 };
 
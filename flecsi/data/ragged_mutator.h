@@ -54,6 +54,7 @@ struct mutator__<data::ragged, T> : public mutator__<data::sparse, T>,
 
   using handle_t = typename base_t::handle_t;
   using offset_t = typename base_t::offset_t;
+  using value_t = typename base_t::value_t;
   using entry_value_t = typename base_t::entry_value_t;
   using erase_set_t = typename base_t::erase_set_t;
   using ragged_changes_t = typename mutator_handle__<T>::ragged_changes_t;
@@ -69,7 +70,7 @@ struct mutator__<data::ragged, T> : public mutator__<data::sparse, T>,
     base_t::h_.ragged_changes_map_ = new ragged_changes_map_t;
   }
 
-  T & operator()(size_t index, size_t ragged_index) {
+  value_t & operator()(size_t index, size_t ragged_index) {
     assert(base_t::h_.offsets_ && "uninitialized ragged_mutator");
     assert(index < base_t::h_.num_entries_);
 
@@ -78,12 +79,8 @@ struct mutator__<data::ragged, T> : public mutator__<data::sparse, T>,
     size_t n = offset.count();
 
     if (n >= base_t::h_.num_slots_) {
-      if (index < base_t::h_.num_exclusive_) {
-        (*base_t::h_.num_exclusive_insertions)++;
-      }
-
-      return base_t::h_.spare_map_->emplace(index, entry_value_t(ragged_index))
-          ->second.value;
+      base_t::h_.overflow_->emplace_back(index, entry_value_t(ragged_index));
+      return base_t::h_.overflow_->back().second.value;
     } // if
 
     entry_value_t * start = base_t::h_.entries_ + index * base_t::h_.num_slots_;
@@ -108,10 +105,6 @@ struct mutator__<data::ragged, T> : public mutator__<data::sparse, T>,
 
     itr->entry = ragged_index;
 
-    if (index < base_t::h_.num_exclusive_) {
-      (*base_t::h_.num_exclusive_insertions)++;
-    }
-
     offset.set_count(n + 1);
 
     return itr->value;
@@ -159,7 +152,7 @@ struct mutator__<data::ragged, T> : public mutator__<data::sparse, T>,
     }
   }
 
-  void push_back(size_t index, const T & value) {
+  void push_back(size_t index, const value_t & value) {
     assert(index < base_t::h_.num_entries_);
 
     auto itr = base_t::h_.ragged_changes_map_->find(index);
@@ -182,7 +175,7 @@ struct mutator__<data::ragged, T> : public mutator__<data::sparse, T>,
   }
 
   // insert BEFORE ragged index
-  void insert(size_t index, size_t ragged_index, const T & value) {
+  void insert(size_t index, size_t ragged_index, const value_t & value) {
     assert(index < base_t::h_.num_entries_);
 
     auto itr = base_t::h_.ragged_changes_map_->find(index);
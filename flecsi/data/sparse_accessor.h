@@ -15,8 +15,6 @@
 
 /*! @file */
 
-#include <unordered_set>
-
 #include <cinchlog.h>
 
 #include <flecsi/data/sparse_data_handle.h>
@@ -76,7 +74,8 @@ struct accessor__<
       GHOST_PERMISSIONS>;
 
   using offset_t = typename handle_t::offset_t;
-  using entry_value_t = typename handle_t::entry_value_t;
+  using entries_t = typename handle_t::entries_t;
+  using value_type = typename handle_t::value_type;
 
   using index_space_t =
       topology::index_space__<topology::simple_entry__<size_t>, true>;
@@ -88,47 +87,29 @@ struct accessor__<
   accessor__(const sparse_data_handle__<T, 0, 0, 0> & h)
       : handle(reinterpret_cast<const handle_t &>(h)) {}
 
-  T & operator()(size_t index, size_t entry) {
+  value_type & operator()(size_t index, size_t entry) {
     assert(index < handle.num_total_ && "sparse accessor: index out of bounds");
 
     const offset_t & oi = handle.offsets[index];
 
-    entry_value_t * start = handle.entries + oi.start();
-    entry_value_t * end = start + oi.count();
-
-    entry_value_t * itr = std::lower_bound(
-        start, end, entry_value_t(entry),
-        [](const entry_value_t & k1, const entry_value_t & k2) -> bool {
-          return k1.entry < k2.entry;
-        });
+    const size_t k = handle.entries.lower_bound(oi.start(), oi.end(), entry);
 
-    assert(itr != end && "sparse accessor: unmapped entry");
+    assert(k != oi.end() && "sparse accessor: unmapped entry");
 
-    return itr->value;
+    return handle.entries.value(k);
   } // operator ()
 
   //-------------------------------------------------------------------------//
-  //! Return all entries used over all indices.
+  //! Return all entries used over all indices, in ascending order.
   //-------------------------------------------------------------------------//
   index_space_t entries() const {
-    size_t id = 0;
-    index_space_t is;
-    std::unordered_set<size_t> found;
-
-    for (size_t index = 0; index < handle.num_total_; ++index) {
-      const offset_t & oi = handle.offsets[index];
+    const data::sparse_transpose_t & t = transpose();
 
-      entry_value_t * itr = handle.entries + oi.start();
-      entry_value_t * end = itr + oi.count();
+    index_space_t is;
 
-      while (itr != end) {
-        size_t entry = itr->entry;
-        if (found.find(entry) == found.end()) {
-          is.push_back({id++, entry});
-          found.insert(entry);
-        }
-        ++itr;
-      }
+    size_t id = 0;
+    for (size_t entry : t.entries()) {
+      is.push_back({id++, entry});
     }
 
     return is;
@@ -143,15 +124,11 @@ struct accessor__<
 
     const offset_t & oi = handle.offsets[index];
 
-    entry_value_t * itr = handle.entries + oi.start();
-    entry_value_t * end = itr + oi.count();
-
     index_space_t is;
 
     size_t id = 0;
-    while (itr != end) {
-      is.push_back({id++, itr->entry});
-      ++itr;
+    for (size_t k = oi.start(); k < oi.end(); ++k) {
+      is.push_back({id++, size_t(handle.entries.entry(k))});
     }
 
     return is;
@@ -176,30 +153,42 @@ struct accessor__<
   }
 
   //-------------------------------------------------------------------------//
-  //! Return all indices allocated for a given entry.
+  //! Return all indices allocated for a given entry, in ascending order.
   //-------------------------------------------------------------------------//
   index_space_t indices(size_t entry) const {
+    const data::sparse_transpose_t & t = transpose();
+
     index_space_t is;
     size_t id = 0;
 
-    for (size_t index = 0; index < handle.num_total_; ++index) {
-      const offset_t & oi = handle.offsets[index];
-
-      entry_value_t * start = handle.entries + oi.start();
-      entry_value_t * end = start + oi.count();
+    const size_t p = t.find(entry);
 
-      if (std::binary_search(
-              start, end, entry_value_t(entry),
-              [](const auto & k1, const auto & k2) -> bool {
-                return k1.entry < k2.entry;
-              })) {
-        is.push_back({id++, index});
+    if (p != t.entries().size()) {
+      for (auto index = t.begin(p); index != t.end(p); ++index) {
+        is.push_back({id++, *index});
       }
     }
 
     return is;
   }
 
+  //-------------------------------------------------------------------------//
+  //! Return the transpose of the field, which maps each entry to the
+  //! indices that have it. It is built on the first call, and kept with
+  //! the field data until the next mutator commit; runtimes that do not
+  //! keep one build it once per accessor.
+  //-------------------------------------------------------------------------//
+  const data::sparse_transpose_t & transpose() const {
+    data::sparse_transpose_t & t =
+        handle.transpose ? *handle.transpose : transpose_;
+
+    if (!t.valid()) {
+      t.build(handle.offsets, handle.num_total_, handle.entries);
+    }
+
+    return t;
+  }
+
   void dump() const {
     for (size_t i = 0; i < handle.num_total_; ++i) {
       const offset_t & offset = handle.offsets[i];
@@ -207,8 +196,8 @@ struct accessor__<
       // std::cout << "offset: " << offset.start() << std::endl;
       for (size_t j = 0; j < offset.count(); ++j) {
         size_t k = offset.start() + j;
-        std::cout << "  " << handle.entries[k].entry << " = "
-                  << handle.entries[k].value << std::endl;
+        std::cout << "  " << size_t(handle.entries.entry(k)) << " = "
+                  << handle.entries.value(k) << std::endl;
       }
     }
   }
@@ -222,6 +211,9 @@ struct accessor__<
   }
 
   handle_t handle;
+
+private:
+  mutable data::sparse_transpose_t transpose_;
 };
 
 template<
@@ -30,20 +30,27 @@ struct sparse_data_handle_base__ : public DATA_POLICY,
                                    public dense_data_handle_base_t {
 
   using offset_t = data::sparse_data_offset_t;
-  using entry_value_t = data::sparse_entry_value__<T>;
+  using entries_t = data::sparse_entries__<T>;
+  using entry_value_t = typename entries_t::entry_value_t;
 
   /*!
     Capture the underlying data type.
    */
-  using value_type = T;
+  using value_type = typename entries_t::value_t;
 
   size_t index_space;
   size_t data_client_hash;
   size_t max_entries_per_index;
 
-  entry_value_t * entries = nullptr;
+  entries_t entries;
   offset_t * offsets = nullptr;
 
+  /*!
+    The cached transpose of the field, if the runtime keeps one with the
+    field data (see sparse_accessor::indices(entry)).
+   */
+  data::sparse_transpose_t * transpose = nullptr;
+
   //--------------------------------------------------------------------------//
   //! Default constructor.
   //--------------------------------------------------------------------------//
@@ -66,7 +73,8 @@ struct sparse_data_handle_base__ : public DATA_POLICY,
       : DATA_POLICY(b), index_space(b.index_space),
         data_client_hash(b.data_client_hash),
         max_entries_per_index(b.max_entries_per_index), entries(b.entries),
-        offsets(b.offsets), num_exclusive_(b.num_exclusive_),
+        offsets(b.offsets), transpose(b.transpose),
+        num_exclusive_(b.num_exclusive_),
         num_shared_(b.num_shared_), num_ghost_(b.num_ghost_),
         num_total_(b.num_total_) {}
 
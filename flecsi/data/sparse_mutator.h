@@ -33,7 +33,7 @@ struct sparse_mutator_base_t {};
 //----------------------------------------------------------------------------//
 //! The mutator type captures information about permissions
 //! and specifies a data policy. The sparse mutator uses a temporary slots
-//! buffer and overflow "spare" map for insertions which are then commited
+//! buffer and overflow buffer for insertions which are then commited
 //! to the persistent sparse data buffer by the sparse handle's commit method.
 //! A mutator is instantiated with a fixed number of slots which for optimal
 //! performance should roughly approximate the expected number of entry
@@ -51,6 +51,7 @@ struct mutator__<data::sparse, T> : public mutator__<data::base, T>,
                                     public sparse_mutator_base_t {
   using handle_t = mutator_handle__<T>;
   using offset_t = typename handle_t::offset_t;
+  using value_t = typename handle_t::value_t;
   using entry_value_t = typename handle_t::entry_value_t;
   using erase_set_t = typename handle_t::erase_set_t;
 
@@ -60,7 +61,7 @@ struct mutator__<data::sparse, T> : public mutator__<data::base, T>,
 
   mutator__(const mutator_handle__<T> & h) : h_(h) {}
 
-  T & operator()(size_t index, size_t entry) {
+  value_t & operator()(size_t index, size_t entry) {
     assert(h_.offsets_ && "uninitialized mutator");
     assert(index < h_.num_entries_);
 
@@ -84,13 +85,11 @@ struct mutator__<data::sparse, T> : public mutator__<data::base, T>,
     }
     
     // if we neet to add the entry, but we've exceeded the number of available
-    // slots, dump it into the extra storage
+    // slots, dump it into the overflow buffer, which is sorted at commit
+    // (as for the slots, the reference is valid until the next insertion)
     if (n >= h_.num_slots_) {
-      if (index < h_.num_exclusive_) {
-        (*h_.num_exclusive_insertions)++;
-      }
-
-      return h_.spare_map_->emplace(index, entry_value_t(entry))->second.value;
+      h_.overflow_->emplace_back(index, entry_value_t(entry));
+      return h_.overflow_->back().second.value;
     } // if
 
 
@@ -102,10 +101,6 @@ struct mutator__<data::sparse, T> : public mutator__<data::base, T>,
 
     itr->entry = entry;
 
-    if (index < h_.num_exclusive_) {
-      (*h_.num_exclusive_insertions)++;
-    }
-
     offset.set_count(n + 1);
 
     return itr->value;
@@ -139,12 +134,11 @@ struct mutator__<data::sparse, T> : public mutator__<data::base, T>,
                     << std::endl;
         }
 
-        auto p = h_.spare_map_->equal_range(i);
-        auto itr = p.first;
-        while (itr != p.second) {
-          std::cout << "    +" << itr->second.entry << " = "
-                    << itr->second.value << std::endl;
-          ++itr;
+        for (auto & o : *h_.overflow_) {
+          if (o.first == i) {
+            std::cout << "    +" << o.second.entry << " = " << o.second.value
+                      << std::endl;
+          }
         }
       }
     }
@@ -231,6 +231,8 @@ struct context__ : public CONTEXT_POLICY {
   void add_index_map(size_t index_space, std::map<size_t, size_t> & index_map) {
     index_map_[index_space] = index_map;
 
+    // The map may replace the map of a previous coloring.
+    reverse_index_map_[index_space].clear();
     for (auto i : index_map) {
       reverse_index_map_[index_space][i.second] = i.first;
     } // for
@@ -535,8 +537,34 @@ struct context__ : public CONTEXT_POLICY {
 
     colorings_[index_space] = coloring;
     coloring_info_[index_space] = coloring_info;
+
+    invalidate_handles();
   } // add_coloring
 
+  /*!
+    Replace an index coloring, e.g., after the index space has been
+    repartitioned. The field data of the index space must be migrated to
+    the new coloring by the runtime (see execution/mpi/runtime_driver.h).
+
+    @param index_space The map key.
+    @param coloring The index coloring that replaces the existing one.
+    @param coloring The index coloring information of all colors.
+   */
+
+  void replace_coloring(
+      size_t index_space,
+      index_coloring_t & coloring,
+      std::unordered_map<size_t, coloring_info_t> & coloring_info) {
+    clog_assert(
+        colorings_.find(index_space) != colorings_.end(),
+        "color index does not exist");
+
+    colorings_[index_space] = coloring;
+    coloring_info_[index_space] = coloring_info;
+
+    invalidate_handles();
+  } // replace_coloring
+
   /*!
     Return the index coloring referenced by key.
 
@@ -609,6 +637,18 @@ struct context__ : public CONTEXT_POLICY {
         adjacency_info.index_space, std::move(adjacency_info));
   } // add_adjacency
 
+  /*!
+    Remove an adjacency, e.g., because the coloring of one of its index
+    spaces has been replaced, so that it can be added again with the
+    sizes of the new coloring.
+
+    @param index_space The index space id of the adjacency.
+   */
+
+  void remove_adjacency(size_t index_space) {
+    adjacency_info_.erase(index_space);
+  } // remove_adjacency
+
   /*!
     Return the set of registered adjacencies.
 
@@ -771,6 +811,25 @@ struct context__ : public CONTEXT_POLICY {
     return execution_state_;
   } // execution_state
 
+  /*!
+    Return the generation of the colorings and the field data. Handles that
+    are resolved once and cached (see data::resolved_handle__) are valid
+    as long as it does not change.
+   */
+
+  size_t handle_generation() const {
+    return handle_generation_;
+  } // handle_generation
+
+  /*!
+    Invalidate the cached handles, e.g., after a change to a coloring, or to
+    the storage of the field data.
+   */
+
+  void invalidate_handles() {
+    ++handle_generation_;
+  } // invalidate_handles
+
 private:
 
   // Default constructor
@@ -964,6 +1023,12 @@ private:
 
   size_t execution_state_ = SPECIALIZATION_TLT_INIT;
 
+  //--------------------------------------------------------------------------//
+  // Generation of cached handles
+  //--------------------------------------------------------------------------//
+
+  size_t handle_generation_ = 0;
+
 }; // class context__
 
 } // namespace execution
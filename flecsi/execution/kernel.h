@@ -17,6 +17,10 @@
   @file
  */
 
+#include <algorithm>
+#include <vector>
+
+#include <flecsi/concurrency/thread_pool.h>
 #include <flecsi/topology/index_space.h>
 
 namespace flecsi {
@@ -107,5 +111,258 @@ reduce_each__(
   } // for
 } // reduce_each__
 
+//----------------------------------------------------------------------------//
+// Execution policies for the fine-grained, data-parallel interface.
+//
+// The parallel policies split the iteration range into fixed chunks of
+// (at most) grain indices. Reductions keep one partial result per chunk and
+// join the partials in chunk order, so the result of a reduction depends
+// only on the grain, and not on the policy or the number of threads.
+//----------------------------------------------------------------------------//
+
+//! Default number of indices per chunk.
+constexpr size_t default_kernel_grain = 4096;
+
+//----------------------------------------------------------------------------//
+//! Execute kernels on the calling thread.
+//!
+//! @ingroup execution
+//----------------------------------------------------------------------------//
+
+struct serial_execution_t {
+  serial_execution_t(size_t grain = default_kernel_grain) : grain(grain) {}
+
+  size_t grain;
+}; // struct serial_execution_t
+
+//----------------------------------------------------------------------------//
+//! Execute kernels on a thread pool. The calling thread participates in the
+//! execution, so this may be used from within pool tasks.
+//!
+//! @ingroup execution
+//----------------------------------------------------------------------------//
+
+struct thread_pool_execution_t {
+  thread_pool_execution_t(
+      thread_pool & pool,
+      size_t grain = default_kernel_grain)
+      : pool(pool), grain(grain) {}
+
+  thread_pool & pool;
+  size_t grain;
+}; // struct thread_pool_execution_t
+
+//----------------------------------------------------------------------------//
+//! Execute kernels with OpenMP. If FleCSI is not compiled with OpenMP
+//! support, kernels are executed on the calling thread.
+//!
+//! @ingroup execution
+//----------------------------------------------------------------------------//
+
+struct openmp_execution_t {
+  openmp_execution_t(size_t grain = default_kernel_grain) : grain(grain) {}
+
+  size_t grain;
+}; // struct openmp_execution_t
+
+//----------------------------------------------------------------------------//
+//! Apply f to each chunk id in [0, chunks).
+//----------------------------------------------------------------------------//
+
+template<typename F>
+inline void
+for_each_chunk__(const serial_execution_t &, size_t chunks, F && f) {
+  for (size_t c(0); c < chunks; ++c) {
+    f(c);
+  } // for
+} // for_each_chunk__
+
+template<typename F>
+inline void
+for_each_chunk__(
+    const thread_pool_execution_t & policy,
+    size_t chunks,
+    F && f) {
+  if (chunks == 1 || policy.pool.num_threads() == 0) {
+    for_each_chunk__(serial_execution_t(), chunks, f);
+    return;
+  } // if
+
+  wait_group wg;
+
+  for (size_t c(0); c < chunks; ++c) {
+    policy.pool.spawn(wg, [&f, c]() { f(c); });
+  } // for
+
+  policy.pool.wait(wg);
+} // for_each_chunk__
+
+template<typename F>
+inline void
+for_each_chunk__(const openmp_execution_t &, size_t chunks, F && f) {
+#if defined(_OPENMP)
+  const long n = static_cast<long>(chunks);
+
+#pragma omp parallel for schedule(static)
+  for (long c = 0; c < n; ++c) {
+    f(static_cast<size_t>(c));
+  } // for
+#else
+  for_each_chunk__(serial_execution_t(), chunks, f);
+#endif
+} // for_each_chunk__
+
+//----------------------------------------------------------------------------//
+//! Apply a calleable object to each offset in [begin, end) with an execution
+//! policy. This is the policy form of a plain loop over offsets, e.g., over
+//! the exclusive or shared offsets of a dense accessor.
+//!
+//! @tparam POLICY   The execution policy type, i.e., serial_execution_t,
+//!                  thread_pool_execution_t, or openmp_execution_t.
+//!
+//! @param policy    The execution policy.
+//! @param begin     The first offset.
+//! @param end       One past the last offset.
+//! @param function  The calleable object instance, invoked as
+//!                  function(offset). The object is invoked concurrently for
+//!                  different offsets.
+//!
+//! @ingroup execution
+//----------------------------------------------------------------------------//
+
+template<typename POLICY, typename FUNCTION>
+inline void
+for_each_offset__(
+    const POLICY & policy,
+    size_t begin,
+    size_t end,
+    FUNCTION && function) {
+  if (begin >= end) {
+    return;
+  } // if
+
+  const size_t grain = std::max(policy.grain, size_t(1));
+  const size_t chunks = (end - begin + grain - 1) / grain;
+
+  for_each_chunk__(policy, chunks, [&](size_t c) {
+    const size_t cend = std::min(begin + (c + 1) * grain, end);
+
+    for (size_t i(begin + c * grain); i < cend; ++i) {
+      function(i);
+    } // for
+  });
+} // for_each_offset__
+
+//----------------------------------------------------------------------------//
+//! Abstraction function for fine-grained, data-parallel interface with an
+//! execution policy.
+//!
+//! @tparam POLICY      The execution policy type, i.e., serial_execution_t,
+//!                     thread_pool_execution_t, or openmp_execution_t.
+//!
+//! @param policy       The execution policy.
+//! @param index_space  The index space over which to execute the calleable
+//!                     object.
+//! @param function     The calleable object instance. The object is invoked
+//!                     concurrently for different indices.
+//!
+//! @ingroup execution
+//----------------------------------------------------------------------------//
+
+template<
+    typename POLICY,
+    typename ENTITY_TYPE,
+    bool STORAGE,
+    bool OWNED,
+    bool SORTED,
+    typename PREDICATE,
+    typename FUNCTION>
+inline void
+for_each__(
+    const POLICY & policy,
+    flecsi::topology::
+        index_space__<ENTITY_TYPE, STORAGE, OWNED, SORTED, PREDICATE> &
+            index_space,
+    FUNCTION && function) {
+  for_each_offset__(policy, index_space.begin_offset(),
+      index_space.end_offset(), [&](size_t i) {
+        function(std::forward<ENTITY_TYPE>(index_space.get_offset(i)));
+      });
+} // for_each__
+
+//----------------------------------------------------------------------------//
+//! Abstraction function for fine-grained, data-parallel reductions with an
+//! execution policy. Each chunk of the index space is reduced into its own
+//! partial result, which starts from identity. The partial results are then
+//! joined into reduction in chunk order, so the result is deterministic.
+//!
+//! @tparam POLICY      The execution policy type, i.e., serial_execution_t,
+//!                     thread_pool_execution_t, or openmp_execution_t.
+//! @tparam JOIN        The calleable object type used to combine partial
+//!                     results, i.e., join(REDUCTION &, const REDUCTION &).
+//!
+//! @param policy       The execution policy.
+//! @param index_space  The index space over which to execute the calleable
+//!                     object.
+//! @param reduction    The reduction variable.
+//! @param function     The calleable object instance, invoked as
+//!                     function(entity, partial).
+//! @param join         The calleable object used to join a partial result
+//!                     into the reduction variable.
+//! @param identity     The identity of the reduction operation.
+//!
+//! @ingroup execution
+//----------------------------------------------------------------------------//
+
+template<
+    typename POLICY,
+    typename ENTITY_TYPE,
+    bool STORAGE,
+    bool OWNED,
+    bool SORTED,
+    typename PREDICATE,
+    typename FUNCTION,
+    typename REDUCTION,
+    typename JOIN>
+inline void
+reduce_each__(
+    const POLICY & policy,
+    flecsi::topology::
+        index_space__<ENTITY_TYPE, STORAGE, OWNED, SORTED, PREDICATE> &
+            index_space,
+    REDUCTION & reduction,
+    FUNCTION && function,
+    JOIN && join,
+    const REDUCTION & identity = REDUCTION()) {
+  const size_t begin = index_space.begin_offset();
+  const size_t end = index_space.end_offset();
+
+  if (begin >= end) {
+    return;
+  } // if
+
+  const size_t grain = std::max(policy.grain, size_t(1));
+  const size_t chunks = (end - begin + grain - 1) / grain;
+
+  std::vector<REDUCTION> partials(chunks, identity);
+
+  for_each_chunk__(policy, chunks, [&](size_t c) {
+    const size_t cend = std::min(begin + (c + 1) * grain, end);
+
+    // Reduce into a local to avoid false sharing between the partials.
+    REDUCTION partial(identity);
+
+    for (size_t i(begin + c * grain); i < cend; ++i) {
+      function(std::forward<ENTITY_TYPE>(index_space.get_offset(i)), partial);
+    } // for
+
+    partials[c] = partial;
+  });
+
+  for (const auto & partial : partials) {
+    join(reduction, partial);
+  } // for
+} // reduce_each__
+
 } // namespace execution
 } // namespace flecsi
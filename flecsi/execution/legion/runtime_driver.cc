@@ -1103,6 +1103,9 @@ spmd_task(
   // Currently, this is Exclusive - Shared - Ghost.
 
   for(auto is: context_.coloring_map()) {
+    clog_assert(is.second.order.empty(),
+      "reordered colorings are not supported by the legion runtime");
+
     std::map<size_t, size_t> _map;
     size_t counter(0);
 
@@ -31,9 +31,19 @@ mpi_context_policy_t::initialize(
 {
   MPI_Comm_rank(MPI_COMM_WORLD, &color_);
   MPI_Comm_size(MPI_COMM_WORLD, &colors_);
+  MPI_Comm_dup(MPI_COMM_WORLD, &ghost_comm_);
+  MPI_Comm_dup(MPI_COMM_WORLD, &migrate_comm_);
 
   runtime_driver(argc, argv);
 
+  // Ghost updates are completed lazily, and the ranks may have taken
+  // different task paths, so any epochs that are still open are completed
+  // before MPI is finalized.
+  complete_ghost_updates();
+
+  MPI_Comm_free(&ghost_comm_);
+  MPI_Comm_free(&migrate_comm_);
+
   return 0;
 } // mpi_context_policy_t::initialize
 
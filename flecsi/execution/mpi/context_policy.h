@@ -15,9 +15,15 @@
 
 /*! @file */
 
+#include <algorithm>
+#include <cstring>
 #include <unordered_map>
 #include <map>
+#include <memory>
 #include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include <cinchlog.h>
 #include <flecsi-config.h>
@@ -32,6 +38,7 @@
 #include <flecsi/execution/common/launch.h>
 #include <flecsi/execution/common/processor.h>
 #include <flecsi/execution/mpi/runtime_driver.h>
+#include <flecsi/execution/mpi/field_arena.h>
 #include <flecsi/execution/mpi/future.h>
 #include <flecsi/runtime/types.h>
 #include <flecsi/utils/common.h>
@@ -60,14 +67,16 @@ struct mpi_context_policy_t
     sparse_field_data_t(){}
 
     sparse_field_data_t(
-      size_t type_size,
+      size_t entry_bytes,
+      size_t value_bytes,
       size_t num_exclusive,
       size_t num_shared,
       size_t num_ghost,
       size_t max_entries_per_index,
       size_t reserve_chunk
     )
-    : type_size(type_size),
+    : entry_bytes(entry_bytes),
+    value_bytes(value_bytes),
     num_exclusive(num_exclusive),
     num_shared(num_shared),
     num_ghost(num_ghost),
@@ -76,6 +85,7 @@ struct mpi_context_policy_t
     reserve_chunk(reserve_chunk),
     reserve(reserve_chunk),
     offsets(num_total),
+    back_offsets(num_total),
     num_exclusive_entries(0){
 
       size_t n = num_total - num_exclusive;
@@ -85,13 +95,21 @@ struct mpi_context_policy_t
           reserve + i * max_entries_per_index);
       }
 
-      size_t entry_value_size = sizeof(size_t) + type_size;
+      const size_t capacity =
+        reserve + (num_shared + num_ghost) * max_entries_per_index;
 
-      entries.resize(entry_value_size * (reserve + ((num_shared + num_ghost) *
-        max_entries_per_index)));
+      entries.resize(entry_bytes * capacity);
+      values.resize(value_bytes * capacity);
+
+      back_entries.resize(entries.size());
+      back_values.resize(values.size());
     }
 
-    size_t type_size;
+    // bytes per entry in the entries and values buffers: entry/value pairs
+    // are stored in entries, unless the field has the structure-of-arrays
+    // layout (see data::sparse_soa__)
+    size_t entry_bytes;
+    size_t value_bytes;
 
     // total # of exclusive, shared, ghost entries
     size_t num_exclusive = 0;
@@ -106,6 +124,23 @@ struct mpi_context_policy_t
 
     std::vector<offset_t> offsets;
     std::vector<uint8_t> entries;
+    std::vector<uint8_t> values;
+
+    // the back buffers of offsets, entries and values: a mutator commit
+    // merges into them, and then swaps them with the buffers above, so that
+    // commits do not allocate unless the reserve grows
+    std::vector<offset_t> back_offsets;
+    std::vector<uint8_t> back_entries;
+    std::vector<uint8_t> back_values;
+
+    // the entry to indices map, built by the first accessor that needs it,
+    // and invalidated by mutator commits and sparse ghost updates
+    data::sparse_transpose_t transpose;
+
+    // the slots and the overflow of the mutators of the field, typed by the
+    // data type (see mutator_handle_base__::insertions_t), kept across
+    // commits like the back buffers
+    std::shared_ptr<void> mutator_insertions;
   };
 
   /*!
@@ -233,26 +268,31 @@ struct mpi_context_policy_t
     std::map<int, MPI_Datatype> target_types;
 
     MPI_Win win;
+
+    // True while the access epoch (the gets of the ghost data) or the
+    // exposure epoch (the peers' gets of the shared data) of a ghost
+    // update on win has been started by a writing task and not yet
+    // completed.
+    bool ghost_access_pending = false;
+    bool ghost_exposure_pending = false;
   };
 
   /*!
-   Field metadata is used maintain MPI information and data types for
-   MPI windows/one-sided communication to perform ghost copies.
+   Sparse field metadata is used to maintain the communication pattern and
+   the pack buffers for the ghost exchange of sparse and ragged fields.
    */
   struct sparse_field_metadata_t{
-    MPI_Group shared_users_grp;
-    MPI_Group ghost_owners_grp;
+    // Offsets into the shared region of the indices needed by each shared
+    // user, in the order of the user's ghost indices.
+    std::map<int, std::vector<size_t>> shared_indices;
 
-    std::map<int, std::vector<int>> compact_origin_lengs;
-    std::map<int, std::vector<int>> compact_origin_disps;
+    // Offsets into the ghost region of the indices owned by each ghost
+    // owner.
+    std::map<int, std::vector<size_t>> ghost_indices;
 
-    std::map<int, std::vector<int>> compact_target_lengs;
-    std::map<int, std::vector<int>> compact_target_disps;
-
-    std::map<int, MPI_Datatype> origin_types;
-    std::map<int, MPI_Datatype> target_types;
-
-    MPI_Win win;
+    // Pack buffers, reused across updates.
+    std::map<int, std::vector<uint8_t>> send_buffers;
+    std::vector<uint8_t> recv_buffer;
   };
 
   /*!
@@ -308,9 +348,9 @@ struct mpi_context_policy_t
   }
 
   /*!
-   Create MPI datatypes use for ghost copy by inspecting shared regions,
-   and ghost owners, to compute origin and target lengths and displacements
-   for MPI windows.
+   Compute the communication pattern for the ghost exchange of a sparse
+   field. Shared and ghost indices are both listed in entity id order, so
+   the shared indices sent to a user arrive in the order of its ghosts.
    */
   template <typename T>
   void register_sparse_field_metadata(
@@ -321,53 +361,19 @@ struct mpi_context_policy_t
   {
     sparse_field_metadata_t metadata;
 
-    register_field_metadata_<T>(metadata, fid, coloring_info, index_coloring,
-      metadata.compact_origin_lengs, metadata.compact_origin_disps,
-      metadata.compact_target_lengs, metadata.compact_target_disps);
-
-    // Each shared and ghost cells element is an array of max_entries_per_index
-    // of entry_value_t
-    MPI_Datatype shared_ghost_type;
-    MPI_Type_contiguous(sizeof(data::sparse_entry_value__<T>) * 5,
-                        MPI_BYTE, &shared_ghost_type);
-    MPI_Type_commit(&shared_ghost_type);
-    for (auto ghost_owner : coloring_info.ghost_owners) {
-      MPI_Datatype origin_type;
-      MPI_Datatype target_type;
-
-      MPI_Type_indexed(metadata.compact_origin_lengs[ghost_owner].size(),
-                       metadata.compact_origin_lengs[ghost_owner].data(),
-                       metadata.compact_origin_disps[ghost_owner].data(),
-                       //flecsi::coloring::mpi_typetraits__<T>::type(),
-                       shared_ghost_type,
-                       &origin_type);
-      MPI_Type_commit(&origin_type);
-      metadata.origin_types.insert({ghost_owner, origin_type});
+    for (const auto& shared : index_coloring.shared) {
+      for (auto peer : shared.shared) {
+        metadata.shared_indices[peer].push_back(shared.offset);
+      }
+    }
 
-      MPI_Type_indexed(metadata.compact_target_lengs[ghost_owner].size(),
-                       metadata.compact_target_lengs[ghost_owner].data(),
-                       metadata.compact_target_disps[ghost_owner].data(),
-                       //flecsi::coloring::mpi_typetraits__<T>::type(),
-                       shared_ghost_type,
-                       &target_type);
-      MPI_Type_commit(&target_type);
-      metadata.target_types.insert({ghost_owner, target_type});
+    const auto local_offsets = index_coloring.local_offsets();
+    for (const auto& ghost : index_coloring.ghost) {
+      metadata.ghost_indices[ghost.rank].push_back(
+        local_offsets.at(ghost.id));
     }
 
-    // create the initial MPI Window for the shared cells. The window should
-    // be updated in the tuple walker when the number of entries in exclusive
-    // part changes.
-    auto entry_value_size = (sizeof(size_t) + sizeof(T));
-    auto data = sparse_field_data[fid].entries.data();
-    auto shared_data = data + sparse_field_data[fid].reserve *
-                                sparse_field_data[fid].max_entries_per_index *
-                                entry_value_size;
-    MPI_Win_create_dynamic(MPI_INFO_NULL, MPI_COMM_WORLD, &metadata.win);
-
-//    MPI_Win_create(shared_data, coloring_info.shared * entry_value_size,
-//                   entry_value_size, MPI_INFO_NULL, MPI_COMM_WORLD,
-//                   &metadata.win);
-    sparse_field_metadata.insert({fid, metadata});
+    sparse_field_metadata.insert({fid, std::move(metadata)});
   }
 
   /*!
@@ -420,10 +426,13 @@ struct mpi_context_policy_t
       target_disps.insert({ghost_owner, {}});
     }
 
-    int origin_index = 0;
+    // The ghosts are visited in id order, which is the order of the shared
+    // entities on the owner. The origin displacements are the positions in
+    // the local order, which may have been permuted.
+    const auto local_offsets = index_coloring.local_offsets();
     for (const auto& ghost : index_coloring.ghost) {
       origin_lens[ghost.rank].push_back(1);
-      origin_disps[ghost.rank].push_back(origin_index++);
+      origin_disps[ghost.rank].push_back(local_offsets.at(ghost.id));
       target_lens[ghost.rank].push_back(1);
       target_disps[ghost.rank].push_back(ghost.offset);
     }
@@ -536,17 +545,173 @@ struct mpi_context_policy_t
     return field_metadata;
   };
 
+  /*!
+   Complete the access epoch of the outstanding ghost update of a dense
+   field, if any, so that the ghost region can be read. This only waits
+   for this rank's gets, not for the peers that read its shared region,
+   and the exposure epoch is closed as well if the peers are done.
+
+   Ghost updates are started without blocking by the epilog of a task that
+   writes the field, and are only completed when a later task needs the
+   ghost region (or is about to overwrite the shared region that peers are
+   reading). This allows the communication to overlap with the tasks in
+   between.
+   */
+  void complete_ghost_access(field_metadata_t & metadata) {
+    if (metadata.ghost_access_pending) {
+      MPI_Win_complete(metadata.win);
+      metadata.ghost_access_pending = false;
+    } // if
+
+    if (metadata.ghost_exposure_pending) {
+      int done;
+      MPI_Win_test(metadata.win, &done);
+      metadata.ghost_exposure_pending = !done;
+    } // if
+  } // complete_ghost_access
+
+  /*!
+   Complete both epochs of the outstanding ghost update of a dense field,
+   if any. This is required before the shared region is overwritten and
+   before a new epoch is opened on the window.
+   */
+  void complete_ghost_update(field_metadata_t & metadata) {
+    complete_ghost_access(metadata);
+
+    if (metadata.ghost_exposure_pending) {
+      MPI_Win_wait(metadata.win);
+      metadata.ghost_exposure_pending = false;
+    } // if
+  } // complete_ghost_update
+
+  /*!
+   Update the ghost indices of a sparse (or ragged) field. Only the live
+   entries are sent: for each neighbor, the shared indices it needs are
+   packed into a single message as a count followed by that many entry
+   values, and the message is unpacked into the ghost region on receipt.
+   Message sizes are variable, so receives are sized by probing.
+
+   @param fid      The field id.
+   @param offsets  The offsets of the field (exclusive, shared, ghost).
+   @param entries  The entries of the field.
+   */
+  template<typename T>
+  void update_sparse_ghosts(
+    field_id_t fid,
+    data::sparse_data_offset_t * offsets,
+    data::sparse_entries__<T> entries
+  )
+  {
+    using entries_t = data::sparse_entries__<T>;
+
+    constexpr size_t entry_size =
+      entries_t::entry_bytes + entries_t::value_bytes;
+
+    constexpr int tag = 0;
+
+    auto & fd = sparse_field_data.at(fid);
+    auto & metadata = sparse_field_metadata.at(fid);
+
+    const auto shared_offsets = offsets + fd.num_exclusive;
+    const auto ghost_offsets = offsets + fd.num_exclusive + fd.num_shared;
+
+    std::vector<MPI_Request> requests;
+    requests.reserve(metadata.shared_indices.size());
+
+    for (const auto & si : metadata.shared_indices) {
+      auto & buffer = metadata.send_buffers[si.first];
+
+      size_t bytes = 0;
+      for (auto i : si.second) {
+        bytes += sizeof(uint32_t) + shared_offsets[i].count() * entry_size;
+      } // for
+
+      buffer.resize(bytes);
+
+      uint8_t * p = buffer.data();
+      for (auto i : si.second) {
+        const uint32_t count = shared_offsets[i].count();
+
+        std::memcpy(p, &count, sizeof(uint32_t));
+        p += sizeof(uint32_t);
+        p += (entries + shared_offsets[i].start()).pack(p, count);
+      } // for
+
+      requests.emplace_back();
+      MPI_Isend(buffer.data(), bytes, MPI_BYTE, si.first, tag,
+        ghost_comm_, &requests.back());
+    } // for
+
+    auto & buffer = metadata.recv_buffer;
+
+    for (const auto & gi : metadata.ghost_indices) {
+      MPI_Status status;
+      MPI_Probe(gi.first, tag, ghost_comm_, &status);
+
+      int bytes;
+      MPI_Get_count(&status, MPI_BYTE, &bytes);
+      buffer.resize(bytes);
+
+      MPI_Recv(buffer.data(), bytes, MPI_BYTE, gi.first, tag,
+        ghost_comm_, MPI_STATUS_IGNORE);
+
+      const uint8_t * p = buffer.data();
+      for (auto i : gi.second) {
+        uint32_t count;
+        std::memcpy(&count, p, sizeof(uint32_t));
+
+        clog_assert(count <= fd.max_entries_per_index,
+          "ghost entry count exceeds max_entries_per_index");
+
+        p += sizeof(uint32_t);
+        p += (entries + ghost_offsets[i].start()).unpack(p, count);
+        ghost_offsets[i].set_count(count);
+      } // for
+    } // for
+
+    // the ghost entries have been replaced, so the cached transpose no
+    // longer matches the structure of the field
+    if (!metadata.ghost_indices.empty()) {
+      fd.transpose.invalidate();
+    } // if
+
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+  } // update_sparse_ghosts
+
+  /*!
+   Complete all outstanding dense ghost updates. All access epochs are
+   completed before any exposure epoch is waited for. Completing an access
+   epoch does not depend on the peers' completions, so this does not
+   deadlock whichever updates are still pending on each rank, i.e., it
+   does not rely on the ranks having taken the same task path.
+   */
+  void complete_ghost_updates() {
+    for (auto & fm : field_metadata) {
+      complete_ghost_access(fm.second);
+    } // for
+
+    for (auto & fm : field_metadata) {
+      complete_ghost_update(fm.second);
+    } // for
+  } // complete_ghost_updates
+
   /*!
    Register new field data, i.e. allocate a new buffer for the specified field
-   ID.
+   ID. The buffer is aligned, and first touched by the threads that compute
+   on its entities (see field_arena_t).
+
+   @param size  The size of the buffer in bytes.
+   @param count The number of entities of the field, whose data are
+                first touched in parallel.
    */
   void register_field_data(field_id_t fid,
-                           size_t size) {
+                           size_t size,
+                           size_t count = 1) {
     // TODO: VERSIONS
-    field_data.insert({fid, std::vector<uint8_t>(size)});
+    field_data.emplace(fid, field_arena_t::allocate(size, count));
   }
 
-  std::map<field_id_t, std::vector<uint8_t>>&
+  std::map<field_id_t, field_buffer_t>&
   registered_field_data()
   {
     return field_data;
@@ -555,12 +720,17 @@ struct mpi_context_policy_t
   /*!
    Register new sparse field data, i.e. allocate a new buffer for the
    specified field ID. Sparse data consists of a buffer of offsets
-   (start + length) and entry id / value pairs and associated metadata about
-   this field. 
+   (start + length) and entry id / value pairs (or separate buffers of
+   entry ids and values) and associated metadata about this field.
+
+   @param entry_bytes The number of bytes per entry in the entries buffer.
+   @param value_bytes The number of bytes per entry in the values buffer,
+                      zero if the values are stored with the entry ids.
    */
   void register_sparse_field_data(
     field_id_t fid,
-    size_t type_size,
+    size_t entry_bytes,
+    size_t value_bytes,
     const coloring_info_t& coloring_info,
     size_t max_entries_per_index,
     size_t reserve_chunk
@@ -568,7 +738,8 @@ struct mpi_context_policy_t
   {
     // TODO: VERSIONS
     sparse_field_data.emplace(
-      fid, sparse_field_data_t(type_size, coloring_info.exclusive,
+      fid, sparse_field_data_t(entry_bytes, value_bytes,
+                               coloring_info.exclusive,
                                coloring_info.shared, coloring_info.ghost,
                                max_entries_per_index, reserve_chunk));
   }
@@ -584,6 +755,349 @@ struct mpi_context_policy_t
     return sparse_field_metadata;
   };
 
+  //--------------------------------------------------------------------------//
+  // Migration interface.
+  //--------------------------------------------------------------------------//
+
+  /*!
+   The plan to migrate the data of an index space to a new coloring (see
+   migrate_colorings). Positions are positions in the local order
+   (exclusive, shared, ghost) of the old coloring for the sent and copied
+   data, and of the new coloring for the received and copied data. The
+   data are sent and received in entity id order.
+   */
+  struct migration_plan_t {
+    // Old positions of the entities sent to each color.
+    std::map<int, std::vector<size_t>> sends;
+
+    // New positions of the entities received from each color.
+    std::map<int, std::vector<size_t>> recvs;
+
+    // Old and new positions of the entities that stay on this color.
+    std::vector<std::pair<size_t, size_t>> copies;
+
+    // The sizes of the new coloring.
+    size_t num_exclusive = 0;
+    size_t num_shared = 0;
+    size_t num_ghost = 0;
+  };
+
+  /*!
+   Migrate the data of a dense field to a new coloring. The data are moved
+   to a new buffer, and the ghost copy metadata of the field are dropped,
+   to be registered again for the new coloring by the next handle to the
+   field. Fields without data are skipped. This is collective: all colors
+   must migrate the same fields in the same order.
+
+   @param fid   The field id.
+   @param bytes The number of bytes per entity.
+   @param plan  The migration plan of the index space of the field.
+   */
+  void migrate_field_data(
+    field_id_t fid,
+    size_t bytes,
+    const migration_plan_t & plan
+  )
+  {
+    auto itr = field_data.find(fid);
+    if (itr == field_data.end()) {
+      return;
+    } // if
+
+    constexpr int tag = 78;
+
+    const uint8_t * data = itr->second.data();
+    const size_t count = plan.num_exclusive + plan.num_shared +
+      plan.num_ghost;
+    field_buffer_t buffer = field_arena_t::allocate(bytes * count, count);
+
+    std::vector<MPI_Request> requests;
+    requests.reserve(plan.sends.size() + plan.recvs.size());
+
+    std::map<int, std::vector<uint8_t>> recv_buffers;
+    for (const auto & r : plan.recvs) {
+      auto & rb = recv_buffers[r.first];
+      rb.resize(r.second.size() * bytes);
+
+      requests.emplace_back();
+      MPI_Irecv(rb.data(), rb.size(), MPI_BYTE, r.first, tag,
+        migrate_comm_, &requests.back());
+    } // for
+
+    std::map<int, std::vector<uint8_t>> send_buffers;
+    for (const auto & s : plan.sends) {
+      auto & sb = send_buffers[s.first];
+      sb.resize(s.second.size() * bytes);
+
+      uint8_t * p = sb.data();
+      for (auto i : s.second) {
+        std::memcpy(p, data + i * bytes, bytes);
+        p += bytes;
+      } // for
+
+      requests.emplace_back();
+      MPI_Isend(sb.data(), sb.size(), MPI_BYTE, s.first, tag,
+        migrate_comm_, &requests.back());
+    } // for
+
+    for (const auto & c : plan.copies) {
+      std::memcpy(buffer.data() + c.second * bytes, data + c.first * bytes,
+        bytes);
+    } // for
+
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+    for (const auto & r : plan.recvs) {
+      const uint8_t * p = recv_buffers[r.first].data();
+      for (auto i : r.second) {
+        std::memcpy(buffer.data() + i * bytes, p, bytes);
+        p += bytes;
+      } // for
+    } // for
+
+    itr->second = std::move(buffer);
+
+    auto mitr = field_metadata.find(fid);
+    if (mitr != field_metadata.end()) {
+      free_field_metadata(mitr->second);
+      field_metadata.erase(mitr);
+    } // if
+  } // migrate_field_data
+
+  /*!
+   Migrate the data of a sparse (or ragged) field to a new coloring. The
+   entries of each index are packed as a count followed by the entries
+   and the values, as for the ghost updates. The exclusive entries of the
+   new data are compacted at the start of the reserve, which grows as in
+   the commit of a mutator if needed, and the communication pattern of
+   the field is dropped, to be registered again by the next handle to the
+   field. Fields without data are skipped.
+
+   @param fid  The field id.
+   @param plan The migration plan of the index space of the field.
+   */
+  void migrate_sparse_field_data(
+    field_id_t fid,
+    const migration_plan_t & plan
+  )
+  {
+    auto itr = sparse_field_data.find(fid);
+    if (itr == sparse_field_data.end()) {
+      return;
+    } // if
+
+    constexpr int tag = 79;
+
+    const auto & fd = itr->second;
+
+    auto pack = [&fd](std::vector<uint8_t> & buffer, size_t i) {
+      const auto & oi = fd.offsets[i];
+      const uint32_t count = oi.count();
+
+      const uint8_t * c = reinterpret_cast<const uint8_t *>(&count);
+      buffer.insert(buffer.end(), c, c + sizeof(uint32_t));
+
+      const uint8_t * e = fd.entries.data() + oi.start() * fd.entry_bytes;
+      buffer.insert(buffer.end(), e, e + count * fd.entry_bytes);
+
+      if (fd.value_bytes > 0) {
+        const uint8_t * v = fd.values.data() + oi.start() * fd.value_bytes;
+        buffer.insert(buffer.end(), v, v + count * fd.value_bytes);
+      } // if
+    };
+
+    const size_t entry_size = fd.entry_bytes + fd.value_bytes;
+
+    std::vector<MPI_Request> requests;
+    requests.reserve(plan.sends.size());
+
+    std::map<int, std::vector<uint8_t>> send_buffers;
+    for (const auto & s : plan.sends) {
+      auto & sb = send_buffers[s.first];
+      for (auto i : s.second) {
+        pack(sb, i);
+      } // for
+
+      requests.emplace_back();
+      MPI_Isend(sb.data(), sb.size(), MPI_BYTE, s.first, tag,
+        migrate_comm_, &requests.back());
+    } // for
+
+    // The packed data of each new index, which are received from other
+    // colors, or copied.
+    const size_t num_total = plan.num_exclusive + plan.num_shared +
+      plan.num_ghost;
+    std::vector<const uint8_t *> packed(num_total, nullptr);
+
+    std::vector<uint8_t> copy_buffer;
+    std::vector<size_t> copy_offsets;
+    for (const auto & c : plan.copies) {
+      copy_offsets.push_back(copy_buffer.size());
+      pack(copy_buffer, c.first);
+    } // for
+
+    for (size_t i(0); i < plan.copies.size(); ++i) {
+      packed[plan.copies[i].second] = copy_buffer.data() + copy_offsets[i];
+    } // for
+
+    // Message sizes are variable, so receives are sized by probing.
+    std::map<int, std::vector<uint8_t>> recv_buffers;
+    for (const auto & r : plan.recvs) {
+      MPI_Status status;
+      MPI_Probe(r.first, tag, migrate_comm_, &status);
+
+      int bytes;
+      MPI_Get_count(&status, MPI_BYTE, &bytes);
+
+      auto & rb = recv_buffers[r.first];
+      rb.resize(bytes);
+
+      MPI_Recv(rb.data(), bytes, MPI_BYTE, r.first, tag, migrate_comm_,
+        MPI_STATUS_IGNORE);
+
+      const uint8_t * p = rb.data();
+      for (auto i : r.second) {
+        uint32_t count;
+        std::memcpy(&count, p, sizeof(uint32_t));
+
+        packed[i] = p;
+        p += sizeof(uint32_t) + count * entry_size;
+      } // for
+    } // for
+
+    auto packed_count = [&packed](size_t i) {
+      uint32_t count;
+      std::memcpy(&count, packed[i], sizeof(uint32_t));
+      return count;
+    };
+
+    // The exclusive entries are compacted at the start of the reserve.
+    size_t exclusive_entries = 0;
+    for (size_t i(0); i < plan.num_exclusive; ++i) {
+      clog_assert(packed[i], "no data for exclusive index " << i);
+      exclusive_entries += packed_count(i);
+    } // for
+
+    size_t reserve = fd.reserve_chunk;
+    if (exclusive_entries > reserve) {
+      reserve += std::max(fd.reserve_chunk, exclusive_entries - reserve);
+    } // if
+
+    sparse_field_data_t migrated(fd.entry_bytes, fd.value_bytes,
+      plan.num_exclusive, plan.num_shared, plan.num_ghost,
+      fd.max_entries_per_index, reserve);
+    migrated.reserve_chunk = fd.reserve_chunk;
+
+    size_t start = 0;
+    for (size_t i(0); i < num_total; ++i) {
+      clog_assert(packed[i], "no data for index " << i);
+
+      const uint32_t n = packed_count(i);
+      auto & oi = migrated.offsets[i];
+
+      if (i < plan.num_exclusive) {
+        oi.set_offset(start);
+        start += n;
+      }
+      else {
+        clog_assert(n <= fd.max_entries_per_index,
+          "entry count exceeds max_entries_per_index");
+      } // if
+
+      oi.set_count(n);
+
+      const uint8_t * p = packed[i] + sizeof(uint32_t);
+      std::memcpy(migrated.entries.data() + oi.start() * fd.entry_bytes, p,
+        n * fd.entry_bytes);
+
+      if (fd.value_bytes > 0) {
+        p += n * fd.entry_bytes;
+        std::memcpy(migrated.values.data() + oi.start() * fd.value_bytes, p,
+          n * fd.value_bytes);
+      } // if
+    } // for
+
+    migrated.num_exclusive_entries = start;
+
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+    itr->second = std::move(migrated);
+    sparse_field_metadata.erase(fid);
+  } // migrate_sparse_field_data
+
+  /*!
+   Free the MPI window, datatypes and groups of the ghost copy metadata of
+   a dense field. Freeing the window is collective.
+   */
+  void free_field_metadata(field_metadata_t & metadata) {
+    complete_ghost_update(metadata);
+
+    MPI_Win_free(&metadata.win);
+
+    for (auto & t : metadata.origin_types) {
+      MPI_Type_free(&t.second);
+    } // for
+
+    for (auto & t : metadata.target_types) {
+      MPI_Type_free(&t.second);
+    } // for
+
+    MPI_Group_free(&metadata.shared_users_grp);
+    MPI_Group_free(&metadata.ghost_owners_grp);
+  } // free_field_metadata
+
+  /*!
+   The storage of the topology of a data client, reconstructed from its
+   field data by the prolog of a read-only task, and reused by later
+   read-only tasks. The storage is valid while the handle generation of the
+   context is unchanged, and until a task writes to the client.
+   */
+  struct topology_storage_t
+  {
+    std::shared_ptr<void> storage;
+    size_t generation = 0;
+  }; // struct topology_storage_t
+
+  /*!
+   Return the cached topology storage of the data client identified by its
+   type, namespace and name hashes (see data_client_handle_base__).
+   */
+  topology_storage_t &
+  topology_storage(
+    size_t type_hash,
+    size_t namespace_hash,
+    size_t name_hash
+  )
+  {
+    return topology_storage_[std::make_tuple(type_hash, namespace_hash,
+      name_hash)];
+  } // topology_storage
+
+  /*!
+   Drop the cached topology storage of a data client, after a task has
+   written to it.
+   */
+  void
+  invalidate_topology_storage(
+    size_t type_hash,
+    size_t namespace_hash,
+    size_t name_hash
+  )
+  {
+    topology_storage_.erase(std::make_tuple(type_hash, namespace_hash,
+      name_hash));
+  } // invalidate_topology_storage
+
+  /*!
+   Drop the cached topology storage of all data clients, e.g., after the
+   colorings have been replaced.
+   */
+  void
+  invalidate_topology_storage()
+  {
+    topology_storage_.clear();
+  } // invalidate_topology_storage
+
   /*!
     return <double> max reduction
    */
@@ -677,6 +1191,15 @@ private:
   int color_ = 0;
   int colors_ = 0;
 
+  // The communicator of the point-to-point sparse ghost exchanges. It is
+  // a duplicate of MPI_COMM_WORLD, so that these messages cannot match
+  // receives posted by other code, e.g., a coloring tool.
+  MPI_Comm ghost_comm_ = MPI_COMM_NULL;
+
+  // The communicator of the field data migration to a new coloring, a
+  // duplicate of MPI_COMM_WORLD for the same reason.
+  MPI_Comm migrate_comm_ = MPI_COMM_NULL;
+
   // Define the map type using the task_hash_t hash function.
 //  std::unordered_map<
 //    task_hash_t::key_t, // key
@@ -691,7 +1214,7 @@ private:
 //    task_info_t
 //  > task_registry_;
 
-  std::map<field_id_t, std::vector<uint8_t>> field_data;
+  std::map<field_id_t, field_buffer_t> field_data;
   std::map<field_id_t, field_metadata_t> field_metadata;
 
   std::map<size_t, index_space_data_t> index_space_data_map_;
@@ -700,6 +1223,9 @@ private:
   std::map<field_id_t, sparse_field_data_t> sparse_field_data;
   std::map<field_id_t, sparse_field_metadata_t> sparse_field_metadata;
 
+  std::map<std::tuple<size_t, size_t, size_t>, topology_storage_t>
+    topology_storage_;
+
   double min_reduction_;
   double max_reduction_;
 
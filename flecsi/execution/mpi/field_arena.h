@@ -0,0 +1,181 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include <flecsi-config.h>
+
+#if defined(FLECSI_ENABLE_HUGE_PAGES) && defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include <flecsi/data/data_constants.h>
+
+namespace flecsi {
+namespace execution {
+
+/*!
+ The storage of the data of a field: a zero-initialized buffer, aligned to
+ data::field_alignment bytes. The exclusive, shared and ghost regions of
+ the field are stored contiguously, in this order, so that the combined
+ data of a handle is a single array.
+
+ @ingroup mpi-execution
+ */
+
+class field_buffer_t
+{
+public:
+
+  field_buffer_t() {}
+
+  field_buffer_t(uint8_t * data, size_t size)
+    : data_(data), size_(size) {}
+
+  field_buffer_t(const field_buffer_t &) = delete;
+  field_buffer_t & operator = (const field_buffer_t &) = delete;
+
+  field_buffer_t(field_buffer_t && b)
+    : data_(b.data_), size_(b.size_)
+  {
+    b.data_ = nullptr;
+    b.size_ = 0;
+  }
+
+  field_buffer_t & operator = (field_buffer_t && b)
+  {
+    std::swap(data_, b.data_);
+    std::swap(size_, b.size_);
+    return *this;
+  }
+
+  ~field_buffer_t()
+  {
+    std::free(data_);
+  }
+
+  uint8_t * data() { return data_; }
+  const uint8_t * data() const { return data_; }
+
+  //! The size of the buffer in bytes.
+  size_t size() const { return size_; }
+
+private:
+
+  uint8_t * data_ = nullptr;
+  size_t size_ = 0;
+
+}; // class field_buffer_t
+
+/*!
+ Allocator of field buffers. Buffers are aligned to data::field_alignment
+ bytes, and, when FleCSI is configured with ENABLE_HUGE_PAGES, buffers of
+ at least one huge page are aligned to huge pages, and backed by
+ transparent huge pages where the kernel supports them.
+
+ A buffer is zeroed by the threads that will compute on it: its entities
+ are visited with the static OpenMP schedule of the loops of
+ execution/kernel.h, so that each page is first touched, and placed, on
+ the NUMA node of the thread that owns its entities.
+
+ @ingroup mpi-execution
+ */
+
+struct field_arena_t
+{
+  static constexpr size_t alignment = data::field_alignment;
+  static constexpr size_t huge_page_size = size_t(2) << 20;
+
+  /*!
+   Allocate a buffer of size bytes for the data of count entities.
+   */
+
+  static
+  field_buffer_t
+  allocate(
+    size_t size,
+    size_t count = 1
+  )
+  {
+    size_t align = alignment;
+
+#if defined(FLECSI_ENABLE_HUGE_PAGES)
+    if(size >= huge_page_size) {
+      align = huge_page_size;
+    } // if
+#endif
+
+    // Round the size up to whole alignment units, so that the end of the
+    // buffer is aligned too. The buffer is never empty.
+    const size_t bytes =
+      std::max(size_t(1), (size + align - 1) / align) * align;
+
+    void * p = nullptr;
+    if(posix_memalign(&p, align, bytes) != 0) {
+      throw std::bad_alloc();
+    } // if
+
+    uint8_t * data = static_cast<uint8_t *>(p);
+
+#if defined(FLECSI_ENABLE_HUGE_PAGES) && defined(__linux__) && \
+  defined(MADV_HUGEPAGE)
+    if(align == huge_page_size) {
+      madvise(data, bytes, MADV_HUGEPAGE);
+    } // if
+#endif
+
+    first_touch(data, size, count);
+    std::memset(data + size, 0, bytes - size);
+
+    return field_buffer_t(data, size);
+  } // allocate
+
+private:
+
+  static
+  void
+  first_touch(
+    uint8_t * data,
+    size_t size,
+    size_t count
+  )
+  {
+    if(count == 0 || size % count != 0) {
+      std::memset(data, 0, size);
+      return;
+    } // if
+
+    const size_t bytes = size / count;
+
+#if defined(_OPENMP)
+    #pragma omp parallel for schedule(static)
+#endif
+    for(long i = 0; i < long(count); ++i) {
+      std::memset(data + i * bytes, 0, bytes);
+    } // for
+  } // first_touch
+
+}; // struct field_arena_t
+
+} // namespace execution
+} // namespace flecsi
+
@@ -16,8 +16,11 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <set>
 
+#include <flecsi/coloring/mpi_communicator.h>
 #include <flecsi/data/data.h>
+#include <flecsi/utils/hash.h>
 
 clog_register_tag(runtime_driver);
 
@@ -28,22 +31,17 @@ namespace execution {
 // Implementation of FleCSI runtime driver task.
 //----------------------------------------------------------------------------//
 
+/*!
+ Set the offsets of the shared entities of an index coloring to their
+ offsets in the shared range of the local order, and the offsets of the
+ ghost entities to the offsets of the shared entities on their owners.
+ */
+
 void
-remap_shared_entities()
+remap_shared_entities(flecsi::coloring::index_coloring_t & index_coloring)
 {
   // TODO: Is this superseded by index_map/reverse_index_map?
-  auto& flecsi_context = context_t::instance();
-  const int my_color = flecsi_context.color();
-
-  for (auto& coloring_info_pair : flecsi_context.coloring_info_map()) {
-    auto index_space = coloring_info_pair.first;
-    auto &coloring_info = coloring_info_pair.second;
-
-    auto &my_coloring_info = flecsi_context.coloring_info(index_space).at(
-      my_color);
-    auto &index_coloring = flecsi_context.coloring(index_space);
-
-    std::set<flecsi::coloring::entity_info_t> new_shared;
+  flecsi::utils::flat_set__<flecsi::coloring::entity_info_t> new_shared;
 
 //    for (auto& shared : index_coloring.shared) {
 //      clog_rank(warn, 0) << "myrank: " << my_color
@@ -53,28 +51,34 @@ remap_shared_entities()
 //                         << ", index: " << index << std::endl;
 //     }
 
-    // FIXME: does this cause deadlock?
-    size_t index = 0;
-    for (auto& shared : index_coloring.shared) {
-      for (auto peer : shared.shared) {
-        MPI_Send(&index, 1, MPI_UNSIGNED_LONG_LONG, peer, 77, MPI_COMM_WORLD);
-      }
-      new_shared.insert(
-        flecsi::coloring::entity_info_t(shared.id, shared.rank, index, shared.shared));
-      index++;
+  // The offsets are positions in the local order, which may differ from
+  // the id order if the coloring has been reordered. The messages are
+  // still sent in id order, which matches the order of the ghosts of
+  // the receiving peers.
+  const auto local_offsets = index_coloring.local_offsets();
+
+  // FIXME: does this cause deadlock?
+  size_t index = 0;
+  for (auto& shared : index_coloring.shared) {
+    index = local_offsets.at(shared.id);
+    for (auto peer : shared.shared) {
+      MPI_Send(&index, 1, MPI_UNSIGNED_LONG_LONG, peer, 77, MPI_COMM_WORLD);
     }
-    context_t::instance().coloring(index_space).shared.swap(new_shared);
+    new_shared.insert(
+      flecsi::coloring::entity_info_t(shared.id, shared.rank, index, shared.shared));
+  }
+  index_coloring.shared.swap(new_shared);
 
 
-    MPI_Status status;
-    std::set<flecsi::coloring::entity_info_t> new_ghost;
+  MPI_Status status;
+  flecsi::utils::flat_set__<flecsi::coloring::entity_info_t> new_ghost;
 
-    for (auto ghost : index_coloring.ghost) {
-      MPI_Recv(&index, 1, MPI_UNSIGNED_LONG_LONG,
-               ghost.rank, 77, MPI_COMM_WORLD, &status);
-      new_ghost.insert(
-        flecsi::coloring::entity_info_t(ghost.id, ghost.rank, index, {}));
-    }
+  for (auto ghost : index_coloring.ghost) {
+    MPI_Recv(&index, 1, MPI_UNSIGNED_LONG_LONG,
+             ghost.rank, 77, MPI_COMM_WORLD, &status);
+    new_ghost.insert(
+      flecsi::coloring::entity_info_t(ghost.id, ghost.rank, index, {}));
+  }
 //    for (auto ghost : index_coloring.ghost) {
 //      clog_rank(warn, 1) << "myrank: " << my_color
 //                         << " old ghost id: " << ghost.id
@@ -89,10 +93,196 @@ remap_shared_entities()
 //                         << ", offset: " << ghost.offset
 //                         << std::endl;
 //    }
-    context_t::instance().coloring(index_space).ghost.swap(new_ghost);
+  index_coloring.ghost.swap(new_ghost);
+}
+
+void
+remap_shared_entities()
+{
+  auto& flecsi_context = context_t::instance();
+
+  for (auto& coloring_info_pair : flecsi_context.coloring_info_map()) {
+    remap_shared_entities(flecsi_context.coloring(coloring_info_pair.first));
   }
 }
 
+/*!
+ Setup the maps from mesh to compacted (local) index space and vice versa
+ of an index space.
+
+ This depends on the ordering of the BLIS data structure setup.
+ Currently, this is Exclusive - Shared - Ghost. The entities may be
+ permuted within each range (see index_coloring_t::order).
+ */
+
+void
+add_index_map(size_t index_space)
+{
+  auto& flecsi_context = context_t::instance();
+
+  std::map<size_t, size_t> _map;
+  size_t counter(0);
+
+  for(auto id: flecsi_context.coloring(index_space).local_ids()) {
+    _map[counter++] = id;
+  } // for
+
+  flecsi_context.add_index_map(index_space, _map);
+} // add_index_map
+
+/*!
+ Compute the plan to migrate the data of an index space from its current
+ coloring to a new coloring. The owners of the entities of the new
+ coloring, including its ghosts, are found with the directory of
+ mpi_communicator_t::get_primary_info, where each color registers the
+ exclusive and shared entities of its current coloring.
+ */
+
+mpi_context_policy_t::migration_plan_t
+make_migration_plan(
+  size_t index_space,
+  const flecsi::coloring::index_coloring_t & coloring,
+  const flecsi::coloring::coloring_info_t & coloring_info
+)
+{
+  auto& flecsi_context = context_t::instance();
+
+  const auto & current = flecsi_context.coloring(index_space);
+  const auto & old_positions = flecsi_context.reverse_index_map(index_space);
+
+  std::vector<size_t> primary_ids;
+  primary_ids.reserve(current.exclusive.size() + current.shared.size());
+
+  for(auto & e: current.exclusive) {
+    primary_ids.push_back(e.id);
+  } // for
+
+  for(auto & s: current.shared) {
+    primary_ids.push_back(s.id);
+  } // for
+
+  const flecsi::utils::flat_set__<size_t> primary(std::move(primary_ids));
+
+  const auto new_ids = coloring.local_ids();
+  std::vector<size_t> request_ids(new_ids);
+  const flecsi::utils::flat_set__<size_t> requests(std::move(request_ids));
+
+  flecsi::coloring::mpi_communicator_t communicator;
+  auto info = communicator.get_primary_info(primary, requests);
+
+  mpi_context_policy_t::migration_plan_t plan;
+  plan.num_exclusive = coloring_info.exclusive;
+  plan.num_shared = coloring_info.shared;
+  plan.num_ghost = coloring_info.ghost;
+
+  clog_assert(new_ids.size() ==
+    plan.num_exclusive + plan.num_shared + plan.num_ghost,
+    "invalid coloring information for index space " << index_space);
+
+  // The sends are in id order, since the primary set is sorted.
+  for(size_t i(0); i < primary.size(); ++i) {
+    for(auto r: info.first[i]) {
+      plan.sends[r].push_back(old_positions.at(primary[i]));
+    } // for
+  } // for
+
+  std::unordered_map<size_t, size_t> new_positions;
+  new_positions.reserve(new_ids.size());
+
+  for(size_t i(0); i < new_ids.size(); ++i) {
+    new_positions[new_ids[i]] = i;
+
+    if(primary.count(new_ids[i])) {
+      plan.copies.emplace_back(old_positions.at(new_ids[i]), i);
+    } // if
+  } // for
+
+  // The remote entities are sorted by id, too.
+  for(auto & e: info.second) {
+    plan.recvs[e.rank].push_back(new_positions.at(e.id));
+  } // for
+
+  return plan;
+} // make_migration_plan
+
+void
+migrate_colorings(
+  std::map<size_t, flecsi::coloring::index_coloring_t> & colorings,
+  std::map<size_t, std::unordered_map<size_t,
+    flecsi::coloring::coloring_info_t>> & coloring_info
+)
+{
+  auto& flecsi_context = context_t::instance();
+  const size_t color = flecsi_context.color();
+
+  // The shared data of the current colorings must be complete.
+  flecsi_context.complete_ghost_updates();
+
+  std::map<size_t, mpi_context_policy_t::migration_plan_t> plans;
+
+  for(auto & c: colorings) {
+    remap_shared_entities(c.second);
+
+    plans.emplace(c.first, make_migration_plan(c.first, c.second,
+      coloring_info.at(c.first).at(color)));
+  } // for
+
+  // The adjacencies from or to the new colorings.
+  std::set<size_t> adjacencies;
+
+  for(auto & ai: flecsi_context.adjacency_info()) {
+    if(colorings.count(ai.second.from_index_space) ||
+      colorings.count(ai.second.to_index_space)) {
+      adjacencies.insert(ai.first);
+    } // if
+  } // for
+
+  // The fields are visited in registration order, which is the same on
+  // all colors, since freeing the ghost copy windows is collective.
+  for(auto & fi: flecsi_context.registered_fields()) {
+
+    // The topology of the data clients is rebuilt by a task that writes
+    // to them.
+    if(utils::hash::is_internal(fi.key)) {
+      if(colorings.count(fi.index_space) ||
+        adjacencies.count(fi.index_space)) {
+        flecsi_context.registered_field_data().erase(fi.fid);
+      } // if
+
+      continue;
+    } // if
+
+    auto plan = plans.find(fi.index_space);
+    if(plan == plans.end()) {
+      continue;
+    } // if
+
+    switch(fi.storage_class) {
+      case data::dense:
+        flecsi_context.migrate_field_data(fi.fid, fi.size, plan->second);
+        break;
+      case data::sparse:
+      case data::ragged:
+        flecsi_context.migrate_sparse_field_data(fi.fid, plan->second);
+        break;
+      default:
+        break;
+    } // switch
+  } // for
+
+  for(auto a: adjacencies) {
+    flecsi_context.remove_adjacency(a);
+  } // for
+
+  for(auto & c: colorings) {
+    flecsi_context.replace_coloring(c.first, c.second,
+      coloring_info.at(c.first));
+    add_index_map(c.first);
+  } // for
+
+  flecsi_context.invalidate_topology_storage();
+} // migrate_colorings
+
 void
 runtime_driver(
   int argc,
@@ -151,28 +341,8 @@ runtime_driver(
 
   remap_shared_entities();
 
-  // Setup maps from mesh to compacted (local) index space and vice versa
-  //
-  // This depends on the ordering of the BLIS data structure setup.
-  // Currently, this is Exclusive - Shared - Ghost.
-
-  for(auto is: flecsi_context.coloring_map()) {
-    std::map<size_t, size_t> _map;
-    size_t counter(0);
-
-    for(auto index: is.second.exclusive) {
-      _map[counter++] = index.id;
-    } // for
-
-    for(auto index: is.second.shared) {
-      _map[counter++] = index.id;
-    } // for
-
-    for(auto index: is.second.ghost) {
-      _map[counter++] = index.id;
-    } // for
-
-    flecsi_context.add_index_map(is.first, _map);
+  for(auto & is: flecsi_context.coloring_map()) {
+    add_index_map(is.first);
   } // for
 
   flecsi_context.advance_state();
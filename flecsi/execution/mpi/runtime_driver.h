@@ -15,6 +15,11 @@
 
 /*! @file */
 
+#include <map>
+#include <unordered_map>
+
+#include <flecsi/coloring/coloring_types.h>
+#include <flecsi/coloring/index_coloring.h>
 
 namespace flecsi {
 namespace execution {
@@ -55,5 +60,35 @@ void driver(int argc, char ** argv);
 
 void runtime_driver(int argc, char ** argv);
 
+/*!
+ Replace the colorings of index spaces during a run, e.g., after they have
+ been repartitioned to balance the load, and migrate the field data of the
+ index spaces to the new colorings. This is called by an MPI task on all
+ colors.
+
+ The data of the dense, sparse and ragged fields, including their ghosts,
+ are moved to the new owners, and their ghost copy metadata are registered
+ again for the new colorings. The topology of the data clients, i.e., the
+ internal fields of the index spaces and of the adjacencies from or to
+ them, is dropped, and must be rebuilt by a task that writes to the data
+ clients, after the adjacencies have been added again with the sizes of
+ the new colorings (see context_t::add_adjacency). Index subspaces are not
+ migrated. Handles to the data clients and fields that were obtained
+ before must be obtained again.
+
+ @param colorings     The new index colorings, by index space. The offsets
+                      of the shared and ghost entities are set as for the
+                      colorings that are added before the runtime driver.
+ @param coloring_info The coloring information of all colors of the new
+                      colorings, by index space.
+
+ @ingroup mpi-execution
+ */
+
+void migrate_colorings(
+  std::map<size_t, flecsi::coloring::index_coloring_t> & colorings,
+  std::map<size_t, std::unordered_map<size_t,
+    flecsi::coloring::coloring_info_t>> & coloring_info);
+
 } // namespace execution
 } // namespace flecsi
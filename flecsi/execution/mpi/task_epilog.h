@@ -96,6 +96,9 @@ namespace execution {
 
       auto &field_metadata = context.registered_field_metadata().at(h.fid);
 
+      // An earlier update of this field may still be in flight.
+      context.complete_ghost_update(field_metadata);
+
       MPI_Win win = field_metadata.win;
 
       MPI_Win_post(field_metadata.shared_users_grp, 0, win);
@@ -107,8 +110,11 @@ namespace execution {
                 win);
       }
 
-      MPI_Win_complete(win);
-      MPI_Win_wait(win);
+      // The epochs are completed by the task prolog of the next task that
+      // needs the ghost data (see task_prolog_t), before the next update
+      // of this field, or when the context is finalized.
+      field_metadata.ghost_access_pending = true;
+      field_metadata.ghost_exposure_pending = true;
     } // handle
 
 
@@ -155,116 +161,12 @@ namespace execution {
     ) {
       auto &h = a.handle;
 
-      using offset_t = typename mutator_handle__<T>::offset_t;
-      using entry_value_t = typename mutator_handle__<T>::entry_value_t;
-      using commit_info_t = typename mutator_handle__<T>::commit_info_t;
-
       // Skip Read Only handles
       if (EXCLUSIVE_PERMISSIONS == ro && SHARED_PERMISSIONS == ro)
         return;
 
       auto &context = context_t::instance();
-      const int my_color = context.color();
-      auto &my_coloring_info =
-        context.coloring_info(h.index_space).at(my_color);
-      auto index_coloring = context.coloring(h.index_space);
-
-      auto &sparse_field_metadata =
-        context.registered_sparse_field_metadata().at(h.fid);
-
-      entry_value_t *entries = h.entries;
-      auto offsets = &(h.offsets)[0];
-      auto shared_data = entries + h.reserve;
-      auto ghost_data = shared_data + h.num_shared_ * h.max_entries_per_index;
-
-      // Get entry_values
-      MPI_Datatype shared_ghost_type;
-      MPI_Type_contiguous(
-        sizeof(entry_value_t),
-        MPI_BYTE, &shared_ghost_type);
-      MPI_Type_commit(&shared_ghost_type);
-
-      MPI_Win win;
-      MPI_Win_create(shared_data,
-                     sizeof(entry_value_t) * h.num_shared_ * h.max_entries_per_index,
-                     sizeof(entry_value_t),
-                     MPI_INFO_NULL, MPI_COMM_WORLD,
-                     &win);
-
-      MPI_Win_post(sparse_field_metadata.shared_users_grp, 0, win);
-      MPI_Win_start(sparse_field_metadata.ghost_owners_grp, 0, win);
-
-      int i = 0;
-      for (auto& ghost : index_coloring.ghost) {
-        clog_rank(warn, 0) << "ghost id: " << ghost.id << ", rank: "
-                           << ghost.rank
-                           << ", offset: " << ghost.offset
-                           << std::endl;
-        MPI_Get(&ghost_data[i*h.max_entries_per_index],
-                h.max_entries_per_index,
-                shared_ghost_type,
-                ghost.rank,
-                ghost.offset*h.max_entries_per_index,
-                h.max_entries_per_index,
-                shared_ghost_type,
-                win);
-        i++;
-      }
-
-      MPI_Win_complete(win);
-      MPI_Win_wait(win);
-
-      MPI_Win_free(&win);
-
-      for (int i = 0; i < h.num_ghost_ * h.max_entries_per_index; i++)
-        clog_rank(warn, 0) << "ghost after: " << ghost_data[i].value << std::endl;
-
-      int send_count = 0;
-      for (auto& shared : index_coloring.shared) {
-        send_count += shared.shared.size();
-      }
-
-      // Send/Recv counts in entry_values.
-      std::vector<MPI_Request> requests(send_count + h.num_ghost_);
-      std::vector<MPI_Status> statuses(send_count + h.num_ghost_);
-
-      std::vector<uint32_t> send_count_buf;
-      for (auto& shared : index_coloring.shared) {
-        for (auto peer : shared.shared) {
-          send_count_buf.push_back(offsets[h.num_exclusive_ + shared.offset].count());
-        }
-      }
-
-      i = 0;
-      for (auto& shared : index_coloring.shared) {
-        for (auto peer : shared.shared) {
-          MPI_Isend(&send_count_buf[i],
-                    1,
-                    flecsi::coloring::mpi_typetraits__<uint32_t>::type(),
-                    peer, shared.id, MPI_COMM_WORLD, &requests[i]);
-          i++;
-        }
-      }
-
-      std::vector<uint32_t> recv_count_buf(h.num_ghost_);
-      i = 0;
-      for (auto& ghost : index_coloring.ghost) {
-        MPI_Status status;
-        MPI_Irecv(&recv_count_buf[i],
-                  1,
-                  flecsi::coloring::mpi_typetraits__<uint32_t>::type(),
-                  ghost.rank, ghost.id, MPI_COMM_WORLD, &requests[i+send_count]);
-        i++;
-      }
-
-      MPI_Waitall(send_count + h.num_ghost_,
-                  requests.data(),
-                  statuses.data());
-
-      for (int i = 0; i < h.num_ghost_; i++) {
-        clog_rank(warn, 0) << recv_count_buf[i] << std::endl;
-        offsets[h.num_exclusive_ + h.num_shared_ + i].set_count(recv_count_buf[i]);
-      }
+      context.update_sparse_ghosts(h.fid, h.offsets, h.entries);
     } // handle
 
     template<
@@ -279,41 +181,60 @@ namespace execution {
       auto &h = m.h_;
 
       using offset_t = typename mutator_handle__<T>::offset_t;
-      using entry_value_t = typename mutator_handle__<T>::entry_value_t;
+      using entries_t = typename mutator_handle__<T>::entries_t;
       using commit_info_t = typename mutator_handle__<T>::commit_info_t;
 
-      if (*h.num_exclusive_insertions > *h.reserve) {
-        size_t old_exclusive_entries = *h.num_exclusive_entries;
-        size_t old_reserve = *h.reserve;
+      commit_info_t ci;
+      ci.offsets = &(*h.offsets)[0];
+      ci.back_offsets = &(*h.back_offsets)[0];
 
-        size_t needed = *h.num_exclusive_insertions - *h.reserve;
+      auto set_entries = [&]() {
+        entries_t entries(h.entries->data(), h.values->data());
 
-        *h.num_exclusive_entries += *h.num_exclusive_insertions;
-        *h.reserve += std::max(h.reserve_chunk, needed);
+        ci.entries[0] = entries;
+        ci.entries[1] = entries + *h.reserve;
+        ci.entries[2] =
+          ci.entries[1] + h.num_shared() * h.max_entries_per_index();
+
+        ci.back_entries = entries_t(h.back_entries->data(),
+          h.back_values->data());
+      };
 
-        constexpr size_t entry_value_size = sizeof(size_t) + sizeof(T);
+      set_entries();
 
-        size_t count = *h.reserve +
-                       (h.num_shared() + h.num_ghost()) *
-                       h.max_entries_per_index();
+      // The commit passes the exact number of exclusive entries, before it
+      // writes any of them.
+      auto grow = [&](size_t exclusive_entries) {
+        if (exclusive_entries <= *h.reserve) {
+          return;
+        }
+
+        size_t old_reserve = *h.reserve;
 
-        h.entries->resize(count * entry_value_size);
+        size_t needed = exclusive_entries - *h.reserve;
+
+        *h.reserve += std::max(h.reserve_chunk, needed);
 
-        entry_value_t *tmp =
-          new entry_value_t[(h.num_shared() + h.num_ghost()) *
-                            h.max_entries_per_index()];
+        size_t shared_and_ghost =
+          (h.num_shared() + h.num_ghost()) * h.max_entries_per_index();
 
-        size_t bytes =
-          (h.num_shared() + h.num_ghost()) * h.max_entries_per_index() *
-          entry_value_size;
+        size_t count = *h.reserve + shared_and_ghost;
 
-        std::memcpy(tmp, &(*h.entries)[0] + old_reserve *
-                                            entry_value_size, bytes);
+        // Grow the buffer, and move the shared and ghost entries to the
+        // end of the new reserve.
+        auto grow_buffer = [&](std::vector<uint8_t> & buffer, size_t bytes) {
+          buffer.resize(count * bytes);
+          std::memmove(&buffer[0] + *h.reserve * bytes,
+            &buffer[0] + old_reserve * bytes, shared_and_ghost * bytes);
+        };
 
-        std::memcpy(&(*h.entries)[0] + *h.reserve *
-                                       entry_value_size, tmp, bytes);
+        grow_buffer(*h.entries, entries_t::entry_bytes);
+        h.back_entries->resize(h.entries->size());
 
-        delete[] tmp;
+        if (entries_t::value_bytes > 0) {
+          grow_buffer(*h.values, entries_t::value_bytes);
+          h.back_values->resize(h.values->size());
+        }
 
         size_t n = h.num_shared() + h.num_ghost();
         size_t ne = h.num_exclusive();
@@ -322,21 +243,20 @@ namespace execution {
           offset_t &oi = (*h.offsets)[i + ne];
           oi.set_offset(*h.reserve + i * h.max_entries_per_index());
         }
-      }
 
-      delete h.num_exclusive_insertions;
+        set_entries();
+      };
 
-      entry_value_t *entries =
-        reinterpret_cast<entry_value_t *>(&(*h.entries)[0]);
+      h.commit(&ci, grow);
 
-      commit_info_t ci;
-      ci.offsets = &(*h.offsets)[0];
-      ci.entries[0] = entries;
-      ci.entries[1] = entries + *h.reserve;
-      ci.entries[2] =
-        ci.entries[1] + h.num_shared() * h.max_entries_per_index();
+      std::swap(*h.offsets, *h.back_offsets);
+      std::swap(*h.entries, *h.back_entries);
+      std::swap(*h.values, *h.back_values);
+
+      h.transpose->invalidate();
 
-      h.commit(&ci);
+      *h.num_exclusive_entries = h.num_exclusive() == 0 ? 0 :
+        (*h.offsets)[h.num_exclusive() - 1].end();
 
     } // handle
 
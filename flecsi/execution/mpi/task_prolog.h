@@ -16,6 +16,7 @@
 /*! @file */
 
 
+#include <memory>
 #include <vector>
 
 #include "mpi.h"
@@ -80,7 +81,28 @@ namespace execution {
      > & a
     )
     {
-      // TODO: move field data allocation here?
+      // Ghost updates of dense fields are started by the epilog of the
+      // writing task and completed here, only if this task reads or writes
+      // the ghost region, or writes the shared region that peers may still
+      // be reading. Reading the ghosts only needs this rank's gets to be
+      // done.
+      constexpr bool writes_shared =
+        SHARED_PERMISSIONS == wo || SHARED_PERMISSIONS == rw;
+
+      if (GHOST_PERMISSIONS == reserved && !writes_shared)
+        return;
+
+      auto& context = context_t::instance();
+      auto& field_metadata = context.registered_field_metadata();
+      auto itr = field_metadata.find(a.handle.fid);
+
+      if (itr != field_metadata.end()) {
+        if (writes_shared) {
+          context.complete_ghost_update(itr->second);
+        } else {
+          context.complete_ghost_access(itr->second);
+        } // if
+      } // if
     } // handle
 
     template<
@@ -117,6 +139,18 @@ namespace execution {
       > & a
     )
     {
+      // The storage of the field may have been swapped or grown by a
+      // mutator commit since the handle was created.
+      auto & h = a.handle;
+      auto & context = context_t::instance();
+      auto & fd = context.registered_sparse_field_data().at(h.fid);
+
+      h.offsets = &fd.offsets[0];
+      h.entries = data::sparse_entries__<T>(fd.entries.data(),
+        fd.values.data());
+      h.reserve = fd.reserve;
+      h.num_exclusive_entries = fd.num_exclusive_entries;
+
 //      // TODO: move field data allocation here?
 //      auto& context = context_t::instance();
 //      const int my_color = context.color();
@@ -149,6 +183,26 @@ namespace execution {
 #endif
     } // handle
 
+    template<
+      typename T,
+      size_t EXCLUSIVE_PERMISSIONS,
+      size_t SHARED_PERMISSIONS,
+      size_t GHOST_PERMISSIONS
+    >
+    void
+    handle(
+      ragged_accessor<
+        T,
+        EXCLUSIVE_PERMISSIONS,
+        SHARED_PERMISSIONS,
+        GHOST_PERMISSIONS
+      > & a
+    )
+    {
+      handle(static_cast<sparse_accessor<
+        T, EXCLUSIVE_PERMISSIONS, SHARED_PERMISSIONS, GHOST_PERMISSIONS>&>(a));
+    } // handle
+
     template<
       typename T
     >
@@ -184,10 +238,25 @@ namespace execution {
       data_client_handle__<T, PERMISSIONS> & h
     )
     {
+      using storage_t = typename T::storage_t;
+
       auto& context_ = context_t::instance();
 
+      // The topology is unchanged since the last task that wrote to the
+      // client, so read-only tasks share the storage reconstructed by the
+      // first of them (see finalize_handles_t).
+      auto * cached = PERMISSIONS == ro ?
+        &context_.topology_storage(h.type_hash, h.namespace_hash,
+          h.name_hash) : nullptr;
+
+      if(cached && cached->storage &&
+        cached->generation == context_.handle_generation()) {
+        h.set_storage(static_cast<storage_t *>(cached->storage.get()));
+        return;
+      } // if
+
       // h is partially initialized in client.h
-      auto storage = h.set_storage(new typename T::storage_t);
+      auto storage = h.set_storage(new storage_t);
 
       bool _read{ PERMISSIONS == ro || PERMISSIONS == rw };
 
@@ -215,7 +284,8 @@ namespace execution {
           size_t size = ent.size * num_entities;
 
           execution::context_t::instance().register_field_data(ent.fid,
-                                                               size);
+                                                               size,
+                                                               num_entities);
         }
         auto ents =
           reinterpret_cast<topology::mesh_entity_base_*>(registered_field_data[ent.fid].data());
@@ -225,7 +295,8 @@ namespace execution {
           size_t size = ent.size * num_entities;
 
           execution::context_t::instance().register_field_data(ent.id_fid,
-                                                               size);
+                                                               size,
+                                                               num_entities);
         }
         auto ids =
           reinterpret_cast<utils::id_t *>(registered_field_data[ent.id_fid].data());
@@ -308,6 +379,11 @@ namespace execution {
       if(!_read){
         h.initialize_storage();
       }
+
+      if(cached) {
+        cached->storage = std::shared_ptr<storage_t>(storage);
+        cached->generation = context_.handle_generation();
+      } // if
     } // handle
 
     /*!
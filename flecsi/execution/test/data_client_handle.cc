@@ -115,7 +115,14 @@ template<typename DC, size_t PS>
 using client_handle_t = data_client_handle__<DC, PS>;
 
 void task1(client_handle_t<test_mesh_t, ro> mesh) {
-  //np(y);
+  for(auto c: mesh.entities<2, 0>()) {
+    size_t count = 0;
+    for(auto v: mesh.entities<0, 0>(c)) {
+      ++count;
+    } // for
+
+    ASSERT_EQ(count, 4u);
+  } // for
 } // task1
 
 void fill_task(client_handle_t<test_mesh_t, wo> mesh,
@@ -268,6 +275,23 @@ void specialization_spmd_init(int argc, char ** argv) {
   f2.wait();
   } // scope
 
+  {
+  // Read-only tasks share the topology storage reconstructed by the first
+  // of them.
+  auto ch = flecsi_get_client_handle(test_mesh_t, meshes, mesh1);
+
+  auto & context = execution::context_t::instance();
+  auto storage = context.topology_storage(ch.type_hash, ch.namespace_hash,
+    ch.name_hash).storage;
+  ASSERT_NE(storage, nullptr);
+
+  auto f3 = flecsi_execute_task_simple(task1, single, ch);
+  f3.wait();
+
+  ASSERT_EQ(context.topology_storage(ch.type_hash, ch.namespace_hash,
+    ch.name_hash).storage, storage);
+  } // scope
+
 } // specialization_spmd_init
 
 //----------------------------------------------------------------------------//
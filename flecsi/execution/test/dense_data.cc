@@ -128,6 +128,10 @@ init(mesh<ro> mesh, field<rw, rw, ro> h) {
   auto & context = execution::context_t::instance();
   auto rank = context.color();
 
+  // The field data are aligned.
+  ASSERT_EQ(h.data(), &h(0));
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(h.data()) % h.alignment, 0u);
+
   for (auto c : mesh.cells(owned)) {
     size_t val = c->index()[1] + 100 * (c->index()[0] + 100 * rank);
     h(c) = 1000000000 + val * 100;
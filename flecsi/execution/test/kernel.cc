@@ -0,0 +1,134 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+#include <cinchtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include <flecsi/execution/kernel.h>
+
+using namespace flecsi;
+using namespace flecsi::execution;
+
+struct object_id {
+  size_t id;
+
+  object_id(size_t id) : id(id) {}
+
+  size_t index_space_index() const {
+    return id;
+  }
+
+  bool operator<(const object_id & oid) const {
+    return id < oid.id;
+  }
+};
+
+struct object {
+  using id_t = object_id;
+
+  object(size_t id) : id(id), mass(std::sin(double(id)) + 1.5) {}
+
+  object_id index_space_id() const {
+    return id;
+  }
+
+  object_id id;
+  double mass;
+  size_t visits = 0;
+};
+
+using index_space_t = topology::index_space__<object *, true, true, false>;
+
+const size_t num_objects = 100003;
+
+TEST(kernel, for_each) {
+  index_space_t is;
+
+  for(size_t i = 0; i < num_objects; ++i) {
+    is << new object(i);
+  } // for
+
+  thread_pool pool;
+  pool.start(4);
+
+  for_each__(serial_execution_t(1000), is, [](object * o) { ++o->visits; });
+  for_each__(thread_pool_execution_t(pool, 1000), is,
+    [](object * o) { ++o->visits; });
+  for_each__(openmp_execution_t(1000), is, [](object * o) { ++o->visits; });
+
+  for(size_t i = 0; i < num_objects; ++i) {
+    ASSERT_EQ(is[i]->visits, 3);
+    delete is[i];
+  } // for
+} // TEST
+
+TEST(kernel, for_each_offset) {
+  std::vector<size_t> visits(num_objects, 0);
+
+  thread_pool pool;
+  pool.start(4);
+
+  auto f = [&visits](size_t i) { ++visits[i]; };
+
+  // Offset ranges need not start at zero, e.g., the shared offsets.
+  for_each_offset__(serial_execution_t(1000), 0, num_objects, f);
+  for_each_offset__(thread_pool_execution_t(pool, 1000), 7, num_objects, f);
+  for_each_offset__(openmp_execution_t(1000), 7, num_objects, f);
+
+  for(size_t i = 0; i < num_objects; ++i) {
+    ASSERT_EQ(visits[i], i < 7 ? 1 : 3);
+  } // for
+} // TEST
+
+TEST(kernel, reduce_each) {
+  index_space_t is;
+
+  for(size_t i = 0; i < num_objects; ++i) {
+    is << new object(i);
+  } // for
+
+  auto f = [](object * o, double & sum) { sum += o->mass; };
+  auto join = [](double & sum, double partial) { sum += partial; };
+
+  double serial(0.0);
+  reduce_each__(serial_execution_t(), is, serial, f, join);
+
+  // The partials are joined in chunk order, so the result must not depend
+  // on the policy or the number of threads.
+  for(size_t threads : {1, 2, 3, 8}) {
+    thread_pool pool;
+    pool.start(threads);
+
+    double pooled(0.0);
+    reduce_each__(thread_pool_execution_t(pool), is, pooled, f, join);
+    ASSERT_EQ(pooled, serial);
+  } // for
+
+  double openmp(0.0);
+  reduce_each__(openmp_execution_t(), is, openmp, f, join);
+  ASSERT_EQ(openmp, serial);
+
+  // Reductions with a non-zero identity.
+  double min(1.0e10);
+  reduce_each__(serial_execution_t(), is, min,
+    [](object * o, double & m) { m = std::min(m, o->mass); },
+    [](double & m, double partial) { m = std::min(m, partial); }, 1.0e10);
+
+  double expected(1.0e10);
+  for(size_t i = 0; i < num_objects; ++i) {
+    expected = std::min(expected, is[i]->mass);
+    delete is[i];
+  } // for
+
+  ASSERT_EQ(min, expected);
+} // TEST
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
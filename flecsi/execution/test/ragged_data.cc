@@ -142,11 +142,39 @@ void task2(client_handle_t<test_mesh_t, ro> mesh,
 
 } // task2
 
+void task3(client_handle_t<test_mesh_t, ro> mesh, ragged_mutator<double> rm) {
+  auto& context = execution::context_t::instance();
+  auto rank = context.color();
+  auto coloring_info = context.coloring_info(rm.h_.index_space).at(rank);
+
+  // grow the exclusive rows through push_back only, past the reserve
+  for(size_t i = 2; i < coloring_info.exclusive; ++i){
+    for(size_t j = 0; j < 3; ++j){
+      rm.push_back(i, i * 10.0 + j);
+    }
+  }
+} // task3
+
+void task4(client_handle_t<test_mesh_t, ro> mesh,
+           ragged_accessor<double, ro, ro, ro> rh) {
+  auto& context = execution::context_t::instance();
+  auto rank = context.color();
+  auto coloring_info = context.coloring_info(rh.handle.index_space).at(rank);
+
+  for(size_t i = 2; i < coloring_info.exclusive; ++i){
+    for(size_t j = 0; j < 3; ++j){
+      ASSERT_EQ(rh(i, j), i * 10.0 + j);
+    }
+  }
+} // task4
+
 flecsi_register_data_client(test_mesh_t, meshes, mesh1); 
 
 flecsi_register_task_simple(task1, loc, single);
 flecsi_register_task_simple(task1b, loc, single);
 flecsi_register_task_simple(task2, loc, single);
+flecsi_register_task_simple(task3, loc, single);
+flecsi_register_task_simple(task4, loc, single);
 
 flecsi_register_field(test_mesh_t, hydro, pressure, double, ragged, 1, 0);
 
@@ -185,7 +213,7 @@ void specialization_tlt_init(int argc, char ** argv) {
 
   execution::context_t::sparse_index_space_info_t isi;
   isi.max_entries_per_index = 5;
-  isi.reserve_chunk = 8192;
+  isi.reserve_chunk = 8;
   context.set_sparse_index_space_info(0, isi);
 } // specialization_tlt_init
 
@@ -215,6 +243,12 @@ void driver(int argc, char ** argv) {
   auto ph = flecsi_get_handle(ch, hydro, pressure, double, ragged, 0);
 
   flecsi_execute_task_simple(task2, single, ch, ph);
+
+  auto mh3 = flecsi_get_mutator(ch, hydro, pressure, double, ragged, 0, 5);
+  auto f3 = flecsi_execute_task_simple(task3, single, ch, mh3);
+  f3.wait();
+
+  flecsi_execute_task_simple(task4, single, ch, ph);
 } // specialization_driver
 
 //----------------------------------------------------------------------------//
@@ -0,0 +1,394 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2018, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+
+#include <cinchtest.h>
+
+#include <flecsi/execution/execution.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/supplemental/mesh/test_mesh_2d.h>
+
+#include <flecsi/data/dense_accessor.h>
+#include <flecsi/data/mutator.h>
+#include <flecsi/data/sparse_accessor.h>
+
+namespace flecsi {
+namespace execution {
+
+//----------------------------------------------------------------------------//
+// Type definitions
+//----------------------------------------------------------------------------//
+
+using point_t = flecsi::supplemental::point_t;
+using index_t = flecsi::supplemental::index_t;
+using vertex_t = flecsi::supplemental::vertex_t;
+using cell_t = flecsi::supplemental::cell_t;
+using mesh_t = flecsi::supplemental::test_mesh_2d_t;
+
+using coloring_info_t = flecsi::coloring::coloring_info_t;
+using adjacency_info_t = flecsi::coloring::adjacency_info_t;
+
+template<size_t PS>
+using mesh = data_client_handle__<mesh_t, PS>;
+
+template<typename T, size_t EP, size_t SP, size_t GP>
+using field = dense_accessor<T, EP, SP, GP>;
+
+template<size_t EP, size_t SP, size_t GP>
+using sparse_field = sparse_accessor<double, EP, SP, GP>;
+
+#ifdef FLECSI_8_8_MESH
+const size_t width{8};
+#else
+const size_t width{16};
+#endif
+
+//----------------------------------------------------------------------------//
+// Variable registration
+//----------------------------------------------------------------------------//
+
+flecsi_register_data_client(mesh_t, meshes, mesh1);
+flecsi_register_field(mesh_t, hydro, pressure, size_t, dense, 1,
+  index_spaces::cells);
+flecsi_register_field(mesh_t, hydro, cost, double, dense, 1,
+  index_spaces::cells);
+flecsi_register_field(mesh_t, hydro, temperature, size_t, dense, 1,
+  index_spaces::vertices);
+flecsi_register_field(mesh_t, hydro, density, double, sparse, 1,
+  index_spaces::cells);
+
+//----------------------------------------------------------------------------//
+// Expected field values, by mesh id.
+//----------------------------------------------------------------------------//
+
+size_t
+pressure_value(size_t cell) {
+  return 1000 + 10 * cell;
+} // pressure_value
+
+size_t
+temperature_value(size_t vertex) {
+  return 7 + 3 * vertex;
+} // temperature_value
+
+double
+density_value(size_t cell, size_t entry) {
+  return cell + 0.25 * entry;
+} // density_value
+
+// The cells that are initially owned by the first color, which are four
+// times as expensive as the others, by mesh id.
+std::vector<int> expensive_cells;
+
+double
+cost_value(size_t cell) {
+  return expensive_cells[cell] ? 4.0 : 1.0;
+} // cost_value
+
+// The entries of the density of a cell.
+std::vector<size_t>
+density_entries(size_t cell) {
+  std::vector<size_t> entries = {0};
+  for (size_t e(1); e <= cell % 3; ++e) {
+    entries.push_back(2 * e);
+  } // for
+
+  return entries;
+} // density_entries
+
+//----------------------------------------------------------------------------//
+// Initialize mesh
+//----------------------------------------------------------------------------//
+
+void
+initialize_mesh(mesh<wo> mesh) {
+  auto & context = execution::context_t::instance();
+
+  auto & vertex_map{context.index_map(index_spaces::vertices)};
+  auto & reverse_vertex_map{context.reverse_index_map(index_spaces::vertices)};
+  auto & cell_map{context.index_map(index_spaces::cells)};
+
+  std::vector<vertex_t *> vertices;
+
+  for (auto & vm : vertex_map) {
+    const size_t mid{vm.second};
+    const size_t row{mid / (width + 1)};
+    const size_t column{mid % (width + 1)};
+    point_t point({{(double)row, (double)column}});
+    index_t index({{row, column}});
+
+    vertices.push_back(mesh.make<vertex_t>(point, index));
+  } // for
+
+  for (auto & cm : cell_map) {
+    const size_t mid{cm.second};
+
+    const size_t row{mid / width};
+    const size_t column{mid % width};
+
+    const size_t v0{(column) + (row) * (width + 1)};
+    const size_t v1{(column + 1) + (row) * (width + 1)};
+    const size_t v2{(column + 1) + (row + 1) * (width + 1)};
+    const size_t v3{(column) + (row + 1) * (width + 1)};
+
+    const size_t lv0{reverse_vertex_map[v0]};
+    const size_t lv1{reverse_vertex_map[v1]};
+    const size_t lv2{reverse_vertex_map[v2]};
+    const size_t lv3{reverse_vertex_map[v3]};
+
+    auto c{mesh.make<cell_t>(index_t{{row, column}})};
+    mesh.init_cell<0>(
+        c, {vertices[lv0], vertices[lv1], vertices[lv2], vertices[lv3]});
+  } // for
+
+  mesh.init<0>();
+} // initialize_mesh
+
+flecsi_register_task(initialize_mesh, flecsi::execution, loc, single);
+
+//----------------------------------------------------------------------------//
+// Init fields
+//----------------------------------------------------------------------------//
+
+void
+init(
+    mesh<ro> mesh,
+    field<size_t, rw, rw, ro> p,
+    field<double, rw, rw, ro> c,
+    field<size_t, rw, rw, ro> t) {
+  auto & context = execution::context_t::instance();
+  auto & cell_map{context.index_map(index_spaces::cells)};
+  auto & vertex_map{context.index_map(index_spaces::vertices)};
+
+  for (auto cell : mesh.cells(owned)) {
+    const size_t mid{cell_map.at(cell->id<0>())};
+    p(cell) = pressure_value(mid);
+    c(cell) = cost_value(mid);
+  } // for
+
+  for (auto v : mesh.entities<0, 0>(owned)) {
+    t(v) = temperature_value(vertex_map.at(v->id<0>()));
+  } // for
+} // init
+
+flecsi_register_task(init, flecsi::execution, loc, single);
+
+void
+init_density(mesh<ro> mesh, sparse_mutator<double> m) {
+  auto & context = execution::context_t::instance();
+  auto & cell_map{context.index_map(index_spaces::cells)};
+
+  for (auto cell : mesh.cells(owned)) {
+    const size_t mid{cell_map.at(cell->id<0>())};
+    for (auto e : density_entries(mid)) {
+      m(cell->id<0>(), e) = density_value(mid, e);
+    } // for
+  } // for
+} // init_density
+
+flecsi_register_task(init_density, flecsi::execution, loc, single);
+
+//----------------------------------------------------------------------------//
+// Check fields
+//----------------------------------------------------------------------------//
+
+void
+check(
+    mesh<ro> mesh,
+    field<size_t, ro, ro, ro> p,
+    field<double, ro, ro, ro> c,
+    field<size_t, ro, ro, ro> t,
+    sparse_field<ro, ro, ro> d) {
+  auto & context = execution::context_t::instance();
+  auto & cell_map{context.index_map(index_spaces::cells)};
+  auto & vertex_map{context.index_map(index_spaces::vertices)};
+
+  // The ghosts are checked too.
+  for (auto cell : mesh.cells()) {
+    const size_t mid{cell_map.at(cell->id<0>())};
+    ASSERT_EQ(p(cell), pressure_value(mid));
+    ASSERT_EQ(c(cell), cost_value(mid));
+  } // for
+
+  for (auto v : mesh.vertices()) {
+    ASSERT_EQ(t(v), temperature_value(vertex_map.at(v->id<0>())));
+  } // for
+
+  // The owned density entries.
+  for (auto cell : mesh.cells(owned)) {
+    const size_t mid{cell_map.at(cell->id<0>())};
+    const auto entries = density_entries(mid);
+
+    ASSERT_EQ(d.entries(cell->id<0>()).size(), entries.size());
+    for (auto e : entries) {
+      ASSERT_EQ(d(cell->id<0>(), e), density_value(mid, e));
+    } // for
+  } // for
+} // check
+
+flecsi_register_task(check, flecsi::execution, loc, single);
+
+//----------------------------------------------------------------------------//
+// Top-Level Specialization Initialization
+//----------------------------------------------------------------------------//
+
+// Add the cells to vertices adjacency with the sizes of the current
+// colorings.
+void
+add_adjacency() {
+  auto & context{execution::context_t::instance()};
+  auto & cinfo{context.coloring_info(index_spaces::cells)};
+
+  adjacency_info_t ai;
+  ai.index_space = index_spaces::cells_to_vertices;
+  ai.from_index_space = index_spaces::cells;
+  ai.to_index_space = index_spaces::vertices;
+  ai.color_sizes.resize(cinfo.size());
+
+  for (auto & itr : cinfo) {
+    size_t color{itr.first};
+    const coloring::coloring_info_t & ci = itr.second;
+    ai.color_sizes[color] = (ci.exclusive + ci.shared + ci.ghost) * 4;
+  } // for
+
+  context.add_adjacency(ai);
+} // add_adjacency
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  clog(info) << "In specialization top-level-task init" << std::endl;
+
+  coloring_map_t map{index_spaces::vertices, index_spaces::cells};
+  flecsi_execute_mpi_task(add_colorings, flecsi::execution, map);
+
+  add_adjacency();
+
+  auto & context{execution::context_t::instance()};
+
+  execution::context_t::sparse_index_space_info_t isi;
+  isi.max_entries_per_index = 5;
+  isi.reserve_chunk = 64;
+  isi.max_exclusive_entries = 8192;
+  context.set_sparse_index_space_info(index_spaces::cells, isi);
+} // specialization_tlt_init
+
+//----------------------------------------------------------------------------//
+// SPMD Specialization Initialization
+//----------------------------------------------------------------------------//
+
+void
+specialization_spmd_init(int argc, char ** argv) {
+  auto mh = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+  flecsi_execute_task(initialize_mesh, flecsi::execution, single, mh);
+} // specialization_spmd_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void
+driver(int argc, char ** argv) {
+  auto & context = execution::context_t::instance();
+
+  int size;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  expensive_cells.assign(width * width, 0);
+  if (context.color() == 0) {
+    auto & cells = context.coloring(index_spaces::cells);
+    for (auto & c : cells.exclusive) {
+      expensive_cells[c.id] = 1;
+    } // for
+    for (auto & c : cells.shared) {
+      expensive_cells[c.id] = 1;
+    } // for
+  } // if
+
+  MPI_Allreduce(MPI_IN_PLACE, expensive_cells.data(), expensive_cells.size(),
+      MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+
+  {
+    auto ch = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+    auto ph = flecsi_get_handle(ch, hydro, pressure, size_t, dense, 0);
+    auto cph = flecsi_get_handle(ch, hydro, cost, double, dense, 0);
+    auto th = flecsi_get_handle(ch, hydro, temperature, size_t, dense, 0);
+    auto dm = flecsi_get_mutator(ch, hydro, density, double, sparse, 0, 5);
+
+    flecsi_execute_task(init, flecsi::execution, single, ch, ph, cph, th)
+        .wait();
+    flecsi_execute_task(init_density, flecsi::execution, single, ch, dm)
+        .wait();
+
+    auto dh = flecsi_get_handle(ch, hydro, density, double, sparse, 0);
+    flecsi_execute_task(check, flecsi::execution, single, ch, ph, cph, th, dh)
+        .wait();
+  } // scope
+
+  const auto before = context.coloring(index_spaces::cells).exclusive.size() +
+                      context.coloring(index_spaces::cells).shared.size();
+
+  // Repartition with the cost of the cells, and rebuild the topology.
+  {
+    auto ch = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+    auto cph = flecsi_get_handle(ch, hydro, cost, double, dense, 0);
+
+    coloring_map_t map{index_spaces::vertices, index_spaces::cells};
+    flecsi_execute_mpi_task(
+        repartition_colorings, flecsi::execution, map, cph.fid);
+  } // scope
+
+  add_adjacency();
+
+  {
+    auto mh = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+    flecsi_execute_task(initialize_mesh, flecsi::execution, single, mh)
+        .wait();
+  } // scope
+
+  // The handles are obtained again for the new colorings.
+  {
+    auto ch = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+    auto ph = flecsi_get_handle(ch, hydro, pressure, size_t, dense, 0);
+    auto cph = flecsi_get_handle(ch, hydro, cost, double, dense, 0);
+    auto th = flecsi_get_handle(ch, hydro, temperature, size_t, dense, 0);
+    auto dh = flecsi_get_handle(ch, hydro, density, double, sparse, 0);
+
+    flecsi_execute_task(check, flecsi::execution, single, ch, ph, cph, th, dh)
+        .wait();
+  } // scope
+
+  // Some of the expensive cells moved.
+  const auto after = context.coloring(index_spaces::cells).exclusive.size() +
+                     context.coloring(index_spaces::cells).shared.size();
+
+  int moved = before != after;
+  MPI_Allreduce(MPI_IN_PLACE, &moved, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+
+  if (size > 1) {
+    ASSERT_TRUE(moved);
+  } // if
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(repartition, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
@@ -0,0 +1,321 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+///
+/// \file
+/// \date Initial file creation: Oct 18, 2026
+///
+/// The structure-of-arrays sparse layout: a field registered with
+/// sparse_soa__ must hold the same entries and values as the same field
+/// with the default layout, on all indices, including the ghosts.
+///
+
+#include <cinchtest.h>
+
+#include <flecsi/execution/execution.h>
+#include <flecsi/io/simple_definition.h>
+#include <flecsi/coloring/dcrs_utils.h>
+#include <flecsi/coloring/parmetis_colorer.h>
+#include <flecsi/coloring/mpi_communicator.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/data/mutator_handle.h>
+#include <flecsi/data/sparse_accessor.h>
+#include <flecsi/data/mutator.h>
+
+using namespace std;
+using namespace flecsi;
+using namespace topology;
+using namespace execution;
+using namespace coloring;
+
+clog_register_tag(coloring);
+
+class vertex : public mesh_entity__<0, 1>{
+public:
+  template<size_t M>
+  uint64_t precedence() const { return 0; }
+  vertex() = default;
+
+};
+
+class edge : public mesh_entity__<1, 1>{
+public:
+};
+
+class face : public mesh_entity__<1, 1>{
+public:
+};
+
+class cell : public mesh_entity__<2, 1>{
+public:
+
+  using id_t = flecsi::utils::id_t;
+
+  std::vector<size_t>
+  create_entities(id_t cell_id, size_t dim, domain_connectivity__<2> & c, id_t * e){
+    id_t* v = c.get_entities(cell_id, 0);
+
+    e[0] = v[0];
+    e[1] = v[2];
+    
+    e[2] = v[1];
+    e[3] = v[3];
+    
+    e[4] = v[0];
+    e[5] = v[1];
+    
+    e[6] = v[2];
+    e[7] = v[3];
+
+    return {2, 2, 2, 2};
+  }
+
+}; // class cell
+
+class test_mesh_types_t{
+public:
+  static constexpr size_t num_dimensions = 2;
+
+  static constexpr size_t num_domains = 1;
+
+  using id_t = flecsi::utils::id_t;
+
+  using entity_types = std::tuple<
+    std::tuple<index_space_<0>, domain_<0>, cell>,
+//    std::tuple<index_space_<2>, domain_<0>, edge>,
+    std::tuple<index_space_<1>, domain_<0>, vertex>>;
+
+  using connectivities = 
+    std::tuple<std::tuple<index_space_<3>, domain_<0>, cell, vertex>>;
+
+  using bindings = std::tuple<>;
+
+  template<size_t M, size_t D, typename ST>
+  static mesh_entity_base__<num_domains>*
+  create_entity(mesh_topology_base__<ST>* mesh, size_t num_vertices,
+    id_t const & id){
+    switch(M){
+      case 0:{
+        switch(D){
+          case 1:
+            //return mesh->template make<edge>(*mesh);
+          default:
+            assert(false && "invalid topological dimension");
+        }
+        break;
+      }
+      default:
+        assert(false && "invalid domain");
+    }
+  }
+};
+
+struct test_mesh_t : public mesh_topology__<test_mesh_types_t> {};
+
+template<typename DC, size_t PS>
+using client_handle_t = data_client_handle__<DC, PS>;
+
+using soa_t = data::sparse_soa__<double, uint16_t>;
+
+void task1(client_handle_t<test_mesh_t, ro> mesh, sparse_mutator<double> mh,
+  sparse_mutator<soa_t> sh) {
+
+  auto& context = execution::context_t::instance();
+  auto rank = context.color();
+  auto coloring_info = context.coloring_info(mh.h_.index_space).at(rank);
+
+  for(size_t i = 0; i < coloring_info.exclusive + coloring_info.shared; ++i){
+    for(size_t j = 0; j < 5; j+=2){
+      mh(i, j) = i * 100 + j + rank * 10000;
+      sh(i, j) = i * 100 + j + rank * 10000;
+    }
+  }
+} // task1
+
+void task2(client_handle_t<test_mesh_t, ro> mesh,
+           sparse_accessor<double, ro, ro, ro> h,
+           sparse_accessor<soa_t, ro, ro, ro> s) {
+
+  ASSERT_EQ(h.indices().size(), s.indices().size());
+
+  for (auto index : h.indices()) {
+    ASSERT_EQ(h.entries(index).size(), s.entries(index).size());
+
+    for (auto entry : h.entries(index)) {
+      ASSERT_EQ(h(index, entry), s(index, entry));
+    }
+  }
+
+  // The transposed view agrees with a scan of all indices.
+  ASSERT_EQ(h.entries().size(), s.entries().size());
+
+  for (auto entry : h.entries()) {
+    std::vector<size_t> expected;
+
+    for (auto index : h.indices()) {
+      for (auto e : h.entries(index)) {
+        if (e == entry) {
+          expected.push_back(index);
+        }
+      }
+    }
+
+    std::vector<size_t> hi, si;
+
+    for (auto index : h.indices(entry)) {
+      hi.push_back(index);
+    }
+
+    for (auto index : s.indices(entry)) {
+      si.push_back(index);
+    }
+
+    ASSERT_EQ(hi, expected);
+    ASSERT_EQ(si, expected);
+  }
+} // task2
+
+void task5(client_handle_t<test_mesh_t, ro> mesh,
+           sparse_accessor<double, ro, ro, ro> h) {
+
+  auto& context = execution::context_t::instance();
+  auto coloring_info = context.coloring_info(h.handle.index_space).at(
+    context.color());
+
+  // The entries inserted by task4 are visible after the commit.
+  ASSERT_EQ(h.indices(5).size(), coloring_info.exclusive);
+  ASSERT_EQ(h.indices(6).size(), coloring_info.exclusive);
+} // task5
+
+void task3(client_handle_t<test_mesh_t, ro> mesh,
+           sparse_accessor<double, rw, rw, rw> h,
+           sparse_accessor<soa_t, rw, rw, rw> s) {
+
+  for (auto index : h.indices()) {
+    for (auto entry : h.entries(index)) {
+      h(index, entry) = -h(index, entry);
+      s(index, entry) = -s(index, entry);
+    }
+  }
+} // task3
+
+void task4(client_handle_t<test_mesh_t, ro> mesh, sparse_mutator<double> mh,
+  sparse_mutator<soa_t> sh) {
+
+  auto& context = execution::context_t::instance();
+  auto rank = context.color();
+  auto coloring_info = context.coloring_info(mh.h_.index_space).at(rank);
+
+  // More insertions than slots, which go to the overflow buffer, and not
+  // in entry order.
+  for(size_t i = 0; i < coloring_info.exclusive; ++i){
+    for(size_t j : {6, 5}){
+      mh(i, j) = i * 100 + j + rank * 10000;
+      sh(i, j) = i * 100 + j + rank * 10000;
+    }
+  }
+} // task4
+
+flecsi_register_data_client(test_mesh_t, meshes, mesh1);
+
+flecsi_register_task_simple(task1, loc, single);
+flecsi_register_task_simple(task2, loc, single);
+flecsi_register_task_simple(task3, loc, single);
+flecsi_register_task_simple(task4, loc, single);
+flecsi_register_task_simple(task5, loc, single);
+
+flecsi_register_field(test_mesh_t, hydro, pressure, double, sparse, 1, 0);
+flecsi_register_field(test_mesh_t, hydro, pressure_soa, soa_t, sparse, 1, 0);
+
+namespace flecsi {
+namespace execution {
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+void specialization_tlt_init(int argc, char ** argv) {
+  clog(info) << "In specialization top-level-task init" << std::endl;
+  coloring_map_t map;
+  map.vertices = 1;
+  map.cells = 0;
+  flecsi_execute_mpi_task(add_colorings, flecsi::execution, map);
+
+  auto& context = execution::context_t::instance();
+
+  auto& cc = context.coloring_info(0);
+  auto& cv = context.coloring_info(1);
+
+  adjacency_info_t ai;
+  ai.index_space = 3;
+  ai.from_index_space = 0;
+  ai.to_index_space = 1;
+  ai.color_sizes.resize(cc.size());
+
+  for(auto& itr : cc){
+    size_t color = itr.first;
+    const coloring_info_t& ci = itr.second;
+    ai.color_sizes[color] = (ci.exclusive + ci.shared + ci.ghost) * 4;
+  }
+
+  context.add_adjacency(ai);
+
+  execution::context_t::sparse_index_space_info_t isi;
+  isi.max_entries_per_index = 5;
+  isi.reserve_chunk = 8192;
+  isi.max_exclusive_entries = 8192;
+  context.set_sparse_index_space_info(0, isi);
+} // specialization_tlt_init
+
+void specialization_spmd_init(int argc, char ** argv) {
+
+} // specialization_spmd_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void driver(int argc, char ** argv) {
+  auto ch = flecsi_get_client_handle(test_mesh_t, meshes, mesh1);
+
+  auto mh = flecsi_get_mutator(ch, hydro, pressure, double, sparse, 0, 5);
+  auto sh = flecsi_get_mutator(ch, hydro, pressure_soa, soa_t, sparse, 0, 5);
+
+  flecsi_execute_task_simple(task1, single, ch, mh, sh).wait();
+
+  auto ph = flecsi_get_handle(ch, hydro, pressure, double, sparse, 0);
+  auto sph = flecsi_get_handle(ch, hydro, pressure_soa, soa_t, sparse, 0);
+
+  flecsi_execute_task_simple(task2, single, ch, ph, sph).wait();
+  flecsi_execute_task_simple(task3, single, ch, ph, sph).wait();
+  flecsi_execute_task_simple(task2, single, ch, ph, sph).wait();
+
+  auto mh2 = flecsi_get_mutator(ch, hydro, pressure, double, sparse, 0, 1);
+  auto sh2 = flecsi_get_mutator(ch, hydro, pressure_soa, soa_t, sparse, 0, 1);
+
+  flecsi_execute_task_simple(task4, single, ch, mh2, sh2).wait();
+
+  // The commit may have grown the storage.
+  ph = flecsi_get_handle(ch, hydro, pressure, double, sparse, 0);
+  sph = flecsi_get_handle(ch, hydro, pressure_soa, soa_t, sparse, 0);
+
+  flecsi_execute_task_simple(task2, single, ch, ph, sph).wait();
+  flecsi_execute_task_simple(task5, single, ch, ph).wait();
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(sparse_soa_data, testname) {
+
+} // TEST
+
+} // namespace execution
+} // namespace flecsi
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
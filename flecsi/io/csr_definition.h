@@ -0,0 +1,398 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include <flecsi/io/mapped_file.h>
+#include <flecsi/topology/mesh_definition.h>
+#include <flecsi/utils/array_ref.h>
+#include <flecsi/utils/logging.h>
+
+namespace flecsi {
+namespace io {
+
+//----------------------------------------------------------------------------//
+//! The header of a FleCSI binary CSR mesh file. The file layout is:
+//!
+//!   csr_header_t
+//!   num_vertices * dimension coordinates (double)
+//!   num_cells + 1 cell-to-vertex offsets (uint64_t)
+//!   num_indices cell-to-vertex indices (uint64_t)
+//!
+//! Each section starts at the byte offset recorded in the header, which
+//! is a multiple of csr_alignment, so that the arrays can be used directly
+//! from a memory mapping.
+//!
+//! @ingroup io
+//----------------------------------------------------------------------------//
+
+struct csr_header_t {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t dimension;
+  uint32_t reserved;
+  uint64_t num_vertices;
+  uint64_t num_cells;
+  uint64_t num_indices;
+  uint64_t coordinates_offset;
+  uint64_t offsets_offset;
+  uint64_t indices_offset;
+  uint64_t file_size;
+}; // struct csr_header_t
+
+constexpr char csr_magic[8] = {'F', 'L', 'E', 'C', 'S', 'C', 'S', 'R'};
+constexpr uint32_t csr_version = 1;
+constexpr uint32_t csr_byte_order = 0x01020304;
+constexpr uint64_t csr_alignment = 64;
+
+//----------------------------------------------------------------------------//
+//! Round \em bytes up to the next multiple of csr_alignment.
+//----------------------------------------------------------------------------//
+
+inline uint64_t
+csr_align(uint64_t bytes) {
+  return (bytes + csr_alignment - 1) / csr_alignment * csr_alignment;
+} // csr_align
+
+//----------------------------------------------------------------------------//
+//! The csr_definition__ type implements the mesh_definition__ interface
+//! for FleCSI binary CSR mesh files. The file is memory-mapped, and the
+//! coordinate and connectivity accessors return views into the mapping,
+//! i.e., nothing is parsed or copied on load.
+//!
+//! @tparam DIMENSION The dimension of the mesh.
+//!
+//! @ingroup io
+//----------------------------------------------------------------------------//
+
+template<size_t DIMENSION>
+class csr_definition__ : public topology::mesh_definition__<DIMENSION> {
+public:
+  using point_t = typename topology::mesh_definition__<DIMENSION>::point_t;
+
+  //--------------------------------------------------------------------------//
+  //! Constructor.
+  //!
+  //! @param filename The CSR file to map.
+  //--------------------------------------------------------------------------//
+
+  csr_definition__(const char * filename) : file_(filename) {
+    clog_assert(
+        file_.size() >= sizeof(csr_header_t),
+        filename << " is too small to be a CSR mesh file");
+
+    std::memcpy(&header_, file_.data(), sizeof(csr_header_t));
+
+    clog_assert(
+        std::memcmp(header_.magic, csr_magic, sizeof(csr_magic)) == 0,
+        filename << " is not a CSR mesh file");
+    clog_assert(
+        header_.byte_order == csr_byte_order,
+        filename << " was written with a different byte order");
+    clog_assert(
+        header_.version == csr_version,
+        filename << " has unsupported version " << header_.version);
+    clog_assert(
+        header_.dimension == DIMENSION,
+        filename << " has dimension " << header_.dimension
+                 << ", expected " << DIMENSION);
+    clog_assert(
+        header_.file_size == file_.size(), filename << " is truncated");
+
+    // Every section must be aligned and lie entirely within the file. The
+    // sizes are checked by division, so that a corrupt count cannot
+    // overflow the byte computation.
+    auto check_section = [this, filename](uint64_t offset, uint64_t count,
+                             uint64_t element_size, const char * name) {
+      const uint64_t size = file_.size();
+
+      if (offset < sizeof(csr_header_t) || offset % csr_alignment != 0 ||
+          offset > size || count > (size - offset) / element_size) {
+        clog_fatal(filename << " has an invalid " << name << " section");
+      } // if
+    }; // check_section
+
+    if (header_.num_cells == std::numeric_limits<uint64_t>::max() ||
+        header_.num_vertices > std::numeric_limits<uint64_t>::max() /
+            DIMENSION) {
+      clog_fatal(filename << " has invalid entity counts");
+    } // if
+
+    check_section(header_.coordinates_offset,
+        header_.num_vertices * DIMENSION, sizeof(double), "coordinates");
+    check_section(header_.offsets_offset, header_.num_cells + 1,
+        sizeof(uint64_t), "offsets");
+    check_section(header_.indices_offset, header_.num_indices,
+        sizeof(uint64_t), "indices");
+
+    // The ids are stored as uint64_t and viewed in place as size_t.
+    static_assert(
+        sizeof(size_t) == sizeof(uint64_t),
+        "the CSR mesh format requires a 64-bit size_t");
+
+    coordinates_ = reinterpret_cast<const double *>(
+        file_.data() + header_.coordinates_offset);
+    offsets_ = reinterpret_cast<const size_t *>(
+        file_.data() + header_.offsets_offset);
+    indices_ = reinterpret_cast<const size_t *>(
+        file_.data() + header_.indices_offset);
+
+    // The offsets must describe a valid compressed-row layout, since
+    // cell_vertices() indexes the indices section with them unchecked.
+    if (offsets_[0] != 0) {
+      clog_fatal(filename << " has a nonzero first cell offset");
+    } // if
+
+    for (size_t c(0); c < header_.num_cells; ++c) {
+      if (offsets_[c + 1] < offsets_[c]) {
+        clog_fatal(filename << " has decreasing offsets at cell " << c);
+      } // if
+    } // for
+
+    if (offsets_[header_.num_cells] != header_.num_indices) {
+      clog_fatal(filename << " has offsets that do not match the number "
+                             "of indices");
+    } // if
+  } // csr_definition__
+
+  /// Copy constructor (disabled)
+  csr_definition__(const csr_definition__ &) = delete;
+
+  /// Assignment operator (disabled)
+  csr_definition__ & operator=(const csr_definition__ &) = delete;
+
+  /// Destructor
+  ~csr_definition__() {}
+
+  //--------------------------------------------------------------------------//
+  //! Return the number of entities of the given dimension. Only vertices
+  //! and cells are stored in the CSR format.
+  //--------------------------------------------------------------------------//
+
+  size_t num_entities(size_t dimension) const override {
+    clog_assert(
+        dimension == 0 || dimension == DIMENSION,
+        "invalid dimension " << dimension);
+    return dimension == 0 ? header_.num_vertices : header_.num_cells;
+  } // num_entities
+
+  //--------------------------------------------------------------------------//
+  //! Return the vertices of the cell \em entity_id.
+  //--------------------------------------------------------------------------//
+
+  std::vector<size_t>
+  entities(size_t from_dim, size_t to_dim, size_t entity_id) const override {
+    auto ids = cell_vertices(from_dim, to_dim, entity_id);
+    return std::vector<size_t>(ids.begin(), ids.end());
+  } // entities
+
+  //--------------------------------------------------------------------------//
+  //! Return a view of the vertices of the cell \em entity_id. The view
+  //! points into the mapping and is valid for the lifetime of this object.
+  //--------------------------------------------------------------------------//
+
+  utils::array_ref<size_t>
+  cell_vertices(size_t from_dim, size_t to_dim, size_t entity_id) const {
+    clog_assert(from_dim == DIMENSION, "invalid dimension " << from_dim);
+    clog_assert(to_dim == 0, "invalid dimension " << to_dim);
+    clog_assert(entity_id < header_.num_cells, "invalid cell " << entity_id);
+
+    return utils::array_ref<size_t>(
+        indices_ + offsets_[entity_id],
+        offsets_[entity_id + 1] - offsets_[entity_id]);
+  } // cell_vertices
+
+  //--------------------------------------------------------------------------//
+  //! Return the cell-to-vertex connectivity as a compressed-row view into
+  //! the mapping.
+  //--------------------------------------------------------------------------//
+
+  topology::crs_view_t
+  entities_crs(size_t from_dim, size_t to_dim) const override {
+    if (from_dim == DIMENSION && to_dim == 0) {
+      return {offsets(), indices()};
+    } // if
+
+    return topology::mesh_definition__<DIMENSION>::entities_crs(
+        from_dim, to_dim);
+  } // entities_crs
+
+  //--------------------------------------------------------------------------//
+  //! Return the cell-to-vertex connectivity of the cells in [\em begin,
+  //! \em end) as a compressed-row view into the mapping. Only the pages
+  //! that hold these rows are touched.
+  //--------------------------------------------------------------------------//
+
+  topology::crs_view_t entities_crs(
+      size_t from_dim,
+      size_t to_dim,
+      size_t begin,
+      size_t end) const override {
+    if (from_dim == DIMENSION && to_dim == 0) {
+      clog_assert(
+          begin <= end && end <= header_.num_cells,
+          "invalid cells [" << begin << ", " << end << ")");
+      return {utils::array_ref<size_t>(offsets_ + begin, end - begin + 1),
+          indices()};
+    } // if
+
+    return topology::mesh_definition__<DIMENSION>::entities_crs(
+        from_dim, to_dim, begin, end);
+  } // entities_crs
+
+  //--------------------------------------------------------------------------//
+  //! Return the coordinates of the vertex \em vertex_id.
+  //--------------------------------------------------------------------------//
+
+  point_t vertex(size_t vertex_id) const {
+    clog_assert(
+        vertex_id < header_.num_vertices, "invalid vertex " << vertex_id);
+
+    point_t v;
+    const double * c = coordinates_ + vertex_id * DIMENSION;
+
+    for (size_t d(0); d < DIMENSION; ++d) {
+      v[d] = c[d];
+    } // for
+
+    return v;
+  } // vertex
+
+  /// Return a view of the interleaved vertex coordinates.
+  utils::array_ref<double> coordinates() const {
+    return utils::array_ref<double>(
+        coordinates_, header_.num_vertices * DIMENSION);
+  } // coordinates
+
+  /// Return a view of the cell-to-vertex offsets (num_cells + 1 entries).
+  utils::array_ref<size_t> offsets() const {
+    return utils::array_ref<size_t>(offsets_, header_.num_cells + 1);
+  } // offsets
+
+  /// Return a view of the cell-to-vertex indices.
+  utils::array_ref<size_t> indices() const {
+    return utils::array_ref<size_t>(indices_, header_.num_indices);
+  } // indices
+
+private:
+  mapped_file_t file_;
+  csr_header_t header_;
+
+  const double * coordinates_ = nullptr;
+  const size_t * offsets_ = nullptr;
+  const size_t * indices_ = nullptr;
+
+}; // class csr_definition__
+
+//----------------------------------------------------------------------------//
+//! Write a mesh definition to \em filename in the binary CSR format.
+//!
+//! @tparam DEFINITION A mesh definition type that provides the
+//!                    mesh_definition__ interface and a vertex() method
+//!                    returning the coordinates of a vertex.
+//!
+//! @param md       The mesh definition to write.
+//! @param filename The output file.
+//!
+//! @ingroup io
+//----------------------------------------------------------------------------//
+
+template<typename DEFINITION>
+void
+write_csr_definition(const DEFINITION & md, const char * filename) {
+  constexpr size_t dimension = DEFINITION::dimension();
+
+  const size_t num_vertices = md.num_entities(0);
+  const size_t num_cells = md.num_entities(dimension);
+
+  // Gather the cell-to-vertex CRS first, since the number of indices
+  // determines the section offsets.
+  std::vector<uint64_t> offsets;
+  std::vector<uint64_t> indices;
+
+  offsets.reserve(num_cells + 1);
+  offsets.push_back(0);
+
+  for (size_t c(0); c < num_cells; ++c) {
+    for (auto v : md.entities(dimension, 0, c)) {
+      indices.push_back(v);
+    } // for
+
+    offsets.push_back(indices.size());
+  } // for
+
+  csr_header_t header;
+  std::memset(&header, 0, sizeof(csr_header_t));
+  std::memcpy(header.magic, csr_magic, sizeof(csr_magic));
+
+  header.version = csr_version;
+  header.byte_order = csr_byte_order;
+  header.dimension = dimension;
+  header.num_vertices = num_vertices;
+  header.num_cells = num_cells;
+  header.num_indices = indices.size();
+
+  header.coordinates_offset = csr_align(sizeof(csr_header_t));
+  header.offsets_offset = csr_align(
+      header.coordinates_offset + num_vertices * dimension * sizeof(double));
+  header.indices_offset = csr_align(
+      header.offsets_offset + offsets.size() * sizeof(uint64_t));
+  header.file_size =
+      header.indices_offset + indices.size() * sizeof(uint64_t);
+
+  std::ofstream out(filename, std::ofstream::out | std::ofstream::binary);
+  clog_assert(out.good(), "failed opening " << filename);
+
+  // Pad the stream with zeros up to the given section offset.
+  auto pad = [&out](uint64_t offset) {
+    static const char zeros[csr_alignment] = {};
+    const uint64_t position = static_cast<uint64_t>(out.tellp());
+    out.write(zeros, offset - position);
+  }; // pad
+
+  out.write(reinterpret_cast<const char *>(&header), sizeof(csr_header_t));
+
+  pad(header.coordinates_offset);
+  for (size_t v(0); v < num_vertices; ++v) {
+    const auto p = md.vertex(v);
+
+    for (size_t d(0); d < dimension; ++d) {
+      const double x = p[d];
+      out.write(reinterpret_cast<const char *>(&x), sizeof(double));
+    } // for
+  } // for
+
+  pad(header.offsets_offset);
+  out.write(
+      reinterpret_cast<const char *>(offsets.data()),
+      offsets.size() * sizeof(uint64_t));
+
+  pad(header.indices_offset);
+  out.write(
+      reinterpret_cast<const char *>(indices.data()),
+      indices.size() * sizeof(uint64_t));
+
+  clog_assert(out.good(), "failed writing " << filename);
+} // write_csr_definition
+
+} // namespace io
+} // namespace flecsi
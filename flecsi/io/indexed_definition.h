@@ -0,0 +1,423 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include <flecsi/io/mapped_file.h>
+#include <flecsi/topology/mesh_definition.h>
+#include <flecsi/utils/logging.h>
+
+namespace flecsi {
+namespace io {
+
+//----------------------------------------------------------------------------//
+//! The indexed_definition__ type implements the mesh_definition__ interface
+//! for the simple .msh format written by tools/mesh-gen. Both the ASCII and
+//! the binary flavors are supported, and the flavor is detected from the
+//! file contents.
+//!
+//! The input is memory-mapped and indexed once on construction, so that
+//! entities() and vertex() are O(1) lookups. Binary inputs are used in
+//! place (zero-copy); ASCII inputs are parsed in a single pass into a
+//! coordinate array and a cell-to-vertex CRS, after which the mapping is
+//! released.
+//!
+//! The .msh layout is:
+//!
+//!   num_vertices num_cells
+//!   DIMENSION coordinates per vertex (num_vertices rows)
+//!   vertex ids per cell (num_cells rows)
+//!
+//! In the binary flavor, the counts and ids are size_t, the coordinates
+//! are double, and every cell has the same number of vertices.
+//!
+//! A definition can also be constructed for a single block of a naive
+//! distribution of the cells (see topology::naive_block_range), e.g., to
+//! let every rank read only its own block for coloring::
+//! make_dcrs_distributed. Only the definitions of the cells in the block
+//! are then available, and ASCII inputs do not load vertex coordinates,
+//! so that memory is proportional to the block rather than to the mesh.
+//!
+//! @tparam DIMENSION The dimension of the mesh.
+//!
+//! @ingroup io
+//----------------------------------------------------------------------------//
+
+template<size_t DIMENSION>
+class indexed_definition__ : public topology::mesh_definition__<DIMENSION> {
+public:
+  using point_t = typename topology::mesh_definition__<DIMENSION>::point_t;
+
+  //--------------------------------------------------------------------------//
+  //! Constructor.
+  //!
+  //! @param filename The .msh file to read.
+  //--------------------------------------------------------------------------//
+
+  indexed_definition__(const char * filename) : file_(filename) {
+    if (!index_binary()) {
+      index_ascii(filename);
+
+      // Everything has been copied out of the mapping.
+      file_.unmap();
+    } // if
+  } // indexed_definition__
+
+  //--------------------------------------------------------------------------//
+  //! Constructor for a single block of the cells.
+  //!
+  //! @param filename   The .msh file to read.
+  //! @param num_blocks The number of blocks in the naive distribution.
+  //! @param block      The block of cells to read.
+  //--------------------------------------------------------------------------//
+
+  indexed_definition__(const char * filename, size_t num_blocks, size_t block)
+      : file_(filename), num_blocks_(num_blocks), block_(block) {
+    clog_assert(block < num_blocks, "invalid block " << block);
+
+    if (!index_binary()) {
+      index_ascii(filename);
+      file_.unmap();
+    } // if
+  } // indexed_definition__
+
+  /// Copy constructor (disabled)
+  indexed_definition__(const indexed_definition__ &) = delete;
+
+  /// Assignment operator (disabled)
+  indexed_definition__ & operator=(const indexed_definition__ &) = delete;
+
+  /// Destructor
+  ~indexed_definition__() {}
+
+  //--------------------------------------------------------------------------//
+  //! Return the number of entities of the given dimension. Only vertices
+  //! and cells are defined by the .msh format.
+  //--------------------------------------------------------------------------//
+
+  size_t num_entities(size_t dimension) const override {
+    clog_assert(
+        dimension == 0 || dimension == DIMENSION,
+        "invalid dimension " << dimension);
+    return dimension == 0 ? num_vertices_ : num_cells_;
+  } // num_entities
+
+  //--------------------------------------------------------------------------//
+  //! Return the vertices of the cell \em entity_id.
+  //--------------------------------------------------------------------------//
+
+  std::vector<size_t>
+  entities(size_t from_dim, size_t to_dim, size_t entity_id) const override {
+    clog_assert(from_dim == DIMENSION, "invalid dimension " << from_dim);
+    clog_assert(to_dim == 0, "invalid dimension " << to_dim);
+    clog_assert(
+        entity_id >= first_cell_ && entity_id < last_cell_,
+        "cell id " << entity_id << " is not loaded");
+
+    const size_t row = entity_id - first_cell_;
+
+    return std::vector<size_t>(
+        indices_ + offsets_[row], indices_ + offsets_[row + 1]);
+  } // entities
+
+  //--------------------------------------------------------------------------//
+  //! Return the cell-to-vertex connectivity as a compressed-row view. This
+  //! is not available for definitions of a single block.
+  //--------------------------------------------------------------------------//
+
+  topology::crs_view_t
+  entities_crs(size_t from_dim, size_t to_dim) const override {
+    if (from_dim == DIMENSION && to_dim == 0) {
+      clog_assert(num_blocks_ == 0, "only a block of the cells is loaded");
+      return {offsets_, utils::array_ref<size_t>(indices_, offsets_.back())};
+    } // if
+
+    return topology::mesh_definition__<DIMENSION>::entities_crs(
+        from_dim, to_dim);
+  } // entities_crs
+
+  //--------------------------------------------------------------------------//
+  //! Return the cell-to-vertex connectivity of the cells in [\em begin,
+  //! \em end) as a compressed-row view into the loaded rows.
+  //--------------------------------------------------------------------------//
+
+  topology::crs_view_t entities_crs(
+      size_t from_dim,
+      size_t to_dim,
+      size_t begin,
+      size_t end) const override {
+    if (from_dim == DIMENSION && to_dim == 0) {
+      clog_assert(
+          begin >= first_cell_ && begin <= end && end <= last_cell_,
+          "cells [" << begin << ", " << end << ") are not loaded");
+
+      return {utils::array_ref<size_t>(
+                  offsets_.data() + begin - first_cell_, end - begin + 1),
+          utils::array_ref<size_t>(indices_, offsets_.back())};
+    } // if
+
+    return topology::mesh_definition__<DIMENSION>::entities_crs(
+        from_dim, to_dim, begin, end);
+  } // entities_crs
+
+  //--------------------------------------------------------------------------//
+  //! Return the coordinates of the vertex \em vertex_id.
+  //--------------------------------------------------------------------------//
+
+  point_t vertex(size_t vertex_id) const {
+    clog_assert(vertex_id < num_vertices_, "invalid vertex id " << vertex_id);
+    clog_assert(coordinates_, "vertex coordinates are not loaded");
+
+    point_t v;
+    const double * c = coordinates_ + vertex_id * DIMENSION;
+
+    for (size_t d(0); d < DIMENSION; ++d) {
+      v[d] = c[d];
+    } // for
+
+    return v;
+  } // vertex
+
+  /// Return true if the input was read from the binary flavor.
+  bool binary() const {
+    return !file_.empty();
+  } // binary
+
+private:
+  //--------------------------------------------------------------------------//
+  //! Try to interpret the mapping as a binary .msh file. The binary flavor
+  //! has no magic number, so the file is accepted if its size is consistent
+  //! with the counts in the header and a fixed number of vertices per cell.
+  //--------------------------------------------------------------------------//
+
+  bool index_binary() {
+    constexpr size_t header = 2 * sizeof(size_t);
+
+    if (file_.size() < header) {
+      return false;
+    } // if
+
+    size_t counts[2];
+    std::memcpy(counts, file_.data(), header);
+
+    const size_t nv = counts[0];
+    const size_t nc = counts[1];
+
+    // Guard against overflow for garbage (e.g., ASCII) headers.
+    const size_t available = file_.size() - header;
+    if (nv > available / (DIMENSION * sizeof(double))) {
+      return false;
+    } // if
+
+    const size_t cell_bytes = available - nv * DIMENSION * sizeof(double);
+    const size_t id_bytes = nc * sizeof(size_t);
+
+    if (nc == 0 || nc > cell_bytes / sizeof(size_t) ||
+        cell_bytes % id_bytes != 0) {
+      return false;
+    } // if
+
+    num_vertices_ = nv;
+    num_cells_ = nc;
+    set_cell_range();
+
+    // Every cell has the same number of vertices, so the offsets are
+    // implicit in the file. They are stored for the compressed-row view
+    // of the loaded cells, relative to the start of the cell section.
+    const size_t width = cell_bytes / id_bytes;
+
+    offsets_.resize(last_cell_ - first_cell_ + 1);
+    for (size_t c(first_cell_); c <= last_cell_; ++c) {
+      offsets_[c - first_cell_] = c * width;
+    } // for
+
+    coordinates_ = reinterpret_cast<const double *>(file_.data() + header);
+    indices_ = reinterpret_cast<const size_t *>(
+        file_.data() + header + nv * DIMENSION * sizeof(double));
+
+    return true;
+  } // index_binary
+
+  //--------------------------------------------------------------------------//
+  //! Parse the mapping as an ASCII .msh file in a single pass.
+  //--------------------------------------------------------------------------//
+
+  void index_ascii(const char * filename) {
+    const char * p = file_.data();
+    const char * const end = file_.end();
+
+    if (!read_index(p, end, num_vertices_) ||
+        !read_index(p, end, num_cells_)) {
+      clog_fatal("failed reading header from " << filename);
+    } // if
+    skip_line(p, end);
+    set_cell_range();
+
+    // Definitions of a block do not load the coordinates.
+    if (num_blocks_ != 0) {
+      for (size_t v(0); v < num_vertices_; ++v) {
+        skip_line(p, end);
+      } // for
+    } else {
+      ascii_coordinates_.resize(num_vertices_ * DIMENSION);
+
+      for (size_t v(0); v < num_vertices_; ++v) {
+        for (size_t d(0); d < DIMENSION; ++d) {
+          if (!read_coordinate(
+                  p, end, ascii_coordinates_[v * DIMENSION + d])) {
+            clog_fatal(
+                "failed reading vertex " << v << " from " << filename);
+          } // if
+        } // for
+
+        skip_line(p, end);
+      } // for
+    } // if
+
+    for (size_t c(0); c < first_cell_; ++c) {
+      skip_line(p, end);
+    } // for
+
+    offsets_.reserve(last_cell_ - first_cell_ + 1);
+    offsets_.push_back(0);
+
+    for (size_t c(first_cell_); c < last_cell_; ++c) {
+      size_t id;
+
+      while (read_index(p, end, id, true)) {
+        ascii_indices_.push_back(id);
+      } // while
+
+      if (ascii_indices_.size() == offsets_.back()) {
+        clog_fatal("failed reading cell " << c << " from " << filename);
+      } // if
+
+      offsets_.push_back(ascii_indices_.size());
+      skip_line(p, end);
+    } // for
+
+    coordinates_ = num_blocks_ == 0 ? ascii_coordinates_.data() : nullptr;
+    indices_ = ascii_indices_.data();
+  } // index_ascii
+
+  /// Set the range of cells to load from the number of cells.
+  void set_cell_range() {
+    if (num_blocks_ == 0) {
+      first_cell_ = 0;
+      last_cell_ = num_cells_;
+    } else {
+      std::tie(first_cell_, last_cell_) =
+          topology::naive_block_range(num_cells_, num_blocks_, block_);
+    } // if
+  } // set_cell_range
+
+  /// Advance \em p past the next newline.
+  static void skip_line(const char *& p, const char * end) {
+    while (p < end && *p++ != '\n') {
+    } // while
+  } // skip_line
+
+  /// Advance \em p past blanks, stopping at newlines if \em in_line is set.
+  static void
+  skip_blanks(const char *& p, const char * end, bool in_line = false) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' ||
+                        (!in_line && *p == '\n'))) {
+      ++p;
+    } // while
+  } // skip_blanks
+
+  //--------------------------------------------------------------------------//
+  //! Read an unsigned integer at \em p. If \em in_line is set, the read
+  //! fails at the end of the current line.
+  //--------------------------------------------------------------------------//
+
+  static bool read_index(
+      const char *& p,
+      const char * end,
+      size_t & value,
+      bool in_line = false) {
+    skip_blanks(p, end, in_line);
+
+    if (p == end || *p < '0' || *p > '9') {
+      return false;
+    } // if
+
+    value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+      value = 10 * value + static_cast<size_t>(*p++ - '0');
+    } // while
+
+    return true;
+  } // read_index
+
+  //--------------------------------------------------------------------------//
+  //! Read a floating-point value at \em p. The mapping is not null
+  //! terminated, so the token is copied to a local buffer for strtod.
+  //--------------------------------------------------------------------------//
+
+  static bool
+  read_coordinate(const char *& p, const char * end, double & value) {
+    skip_blanks(p, end, true);
+
+    char token[64];
+    size_t length(0);
+
+    while (p < end && length < sizeof(token) - 1 && *p != ' ' && *p != '\t' &&
+           *p != '\r' && *p != '\n') {
+      token[length++] = *p++;
+    } // while
+
+    token[length] = '\0';
+
+    char * last;
+    value = std::strtod(token, &last);
+
+    return length > 0 && last == token + length;
+  } // read_coordinate
+
+  mapped_file_t file_;
+
+  size_t num_vertices_ = 0;
+  size_t num_cells_ = 0;
+
+  // The naive block of cells to load, if num_blocks_ is nonzero.
+  size_t num_blocks_ = 0;
+  size_t block_ = 0;
+
+  // The range [first_cell_, last_cell_) of the loaded cells.
+  size_t first_cell_ = 0;
+  size_t last_cell_ = 0;
+
+  // Views of the coordinates and the cell-to-vertex indices. These point
+  // either into the mapping or into the ASCII storage below.
+  const double * coordinates_ = nullptr;
+  const size_t * indices_ = nullptr;
+
+  // Cell-to-vertex offsets into indices_, for the loaded cells.
+  std::vector<size_t> offsets_;
+
+  // ASCII storage (unused for the binary flavor).
+  std::vector<double> ascii_coordinates_;
+  std::vector<size_t> ascii_indices_;
+
+}; // class indexed_definition__
+
+} // namespace io
+} // namespace flecsi
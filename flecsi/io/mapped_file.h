@@ -0,0 +1,149 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <cstddef>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <flecsi/utils/logging.h>
+
+namespace flecsi {
+namespace io {
+
+//----------------------------------------------------------------------------//
+//! The mapped_file_t type provides a read-only, memory-mapped view of a
+//! file. The mapping is released when the object is destroyed. Mesh
+//! readers use this to avoid streaming (and re-streaming) large inputs
+//! through std::ifstream.
+//!
+//! @ingroup io
+//----------------------------------------------------------------------------//
+
+class mapped_file_t {
+public:
+  /// Default constructor (empty mapping)
+  mapped_file_t() {}
+
+  //--------------------------------------------------------------------------//
+  //! Map the file \em filename into memory.
+  //!
+  //! @param filename The file to map.
+  //--------------------------------------------------------------------------//
+
+  mapped_file_t(const char * filename) {
+    const int fd = ::open(filename, O_RDONLY);
+    clog_assert(fd >= 0, "failed opening " << filename);
+
+    struct stat sb;
+    if (::fstat(fd, &sb) != 0) {
+      ::close(fd);
+      clog_fatal("failed to stat " << filename);
+    } // if
+
+    size_ = static_cast<size_t>(sb.st_size);
+
+    if (size_ > 0) {
+      void * data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (data == MAP_FAILED) {
+        ::close(fd);
+        clog_fatal("failed mapping " << filename);
+      } // if
+
+      // The readers walk the mapping front to back.
+      ::madvise(data, size_, MADV_SEQUENTIAL);
+
+      data_ = static_cast<const char *>(data);
+    } // if
+
+    // The mapping holds its own reference to the file.
+    ::close(fd);
+  } // mapped_file_t
+
+  /// Copy constructor (disabled)
+  mapped_file_t(const mapped_file_t &) = delete;
+
+  /// Assignment operator (disabled)
+  mapped_file_t & operator=(const mapped_file_t &) = delete;
+
+  /// Move constructor
+  mapped_file_t(mapped_file_t && other)
+      : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  } // mapped_file_t
+
+  /// Move assignment operator
+  mapped_file_t & operator=(mapped_file_t && other) {
+    if (this != &other) {
+      unmap();
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+    } // if
+
+    return *this;
+  } // operator =
+
+  /// Destructor
+  ~mapped_file_t() {
+    unmap();
+  } // ~mapped_file_t
+
+  //--------------------------------------------------------------------------//
+  //! Release the mapping. This is a no-op for an empty mapping.
+  //--------------------------------------------------------------------------//
+
+  void unmap() {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char *>(data_), size_);
+      data_ = nullptr;
+      size_ = 0;
+    } // if
+  } // unmap
+
+  /// Return a pointer to the first byte of the mapping.
+  const char * data() const {
+    return data_;
+  } // data
+
+  /// Return a pointer one past the last byte of the mapping.
+  const char * end() const {
+    return data_ + size_;
+  } // end
+
+  /// Return the size of the mapping in bytes.
+  size_t size() const {
+    return size_;
+  } // size
+
+  /// Return true if nothing is mapped.
+  bool empty() const {
+    return size_ == 0;
+  } // empty
+
+private:
+  const char * data_ = nullptr;
+  size_t size_ = 0;
+
+}; // class mapped_file_t
+
+} // namespace io
+} // namespace flecsi
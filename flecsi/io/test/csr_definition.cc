@@ -0,0 +1,144 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+#include <cinchtest.h>
+
+#include <fstream>
+
+#include <flecsi/io/csr_definition.h>
+#include <flecsi/io/simple_definition.h>
+#include <flecsi/io/test/temporary_file.h>
+
+TEST(csr_definition, roundtrip) {
+
+  flecsi::io::simple_definition_t sd("simple2d-8x8.msh");
+
+  flecsi::io::temporary_file_t file(".csr");
+  flecsi::io::write_csr_definition(sd, file.path());
+
+  flecsi::io::csr_definition__<2> cd(file.path());
+
+  CINCH_ASSERT(EQ, cd.num_entities(0), sd.num_entities(0));
+  CINCH_ASSERT(EQ, cd.num_entities(2), sd.num_entities(2));
+  CINCH_ASSERT(EQ, cd.offsets().size(), sd.num_entities(2)+1);
+  CINCH_ASSERT(EQ, cd.indices().size(), 4*sd.num_entities(2));
+
+  for(size_t c(0); c<sd.num_entities(2); ++c) {
+    CINCH_ASSERT(EQ, cd.entities(2, 0, c), sd.entities(2, 0, c));
+
+    // The views point directly into the mapping.
+    auto ids = cd.cell_vertices(2, 0, c);
+    CINCH_ASSERT(EQ, ids.data(), cd.indices().data() + cd.offsets()[c]);
+  } // for
+
+  for(size_t v(0); v<sd.num_entities(0); ++v) {
+    CINCH_ASSERT(EQ, cd.vertex(v)[0], sd.vertex(v)[0]);
+    CINCH_ASSERT(EQ, cd.vertex(v)[1], sd.vertex(v)[1]);
+  } // for
+
+  // Sections are aligned for direct use from the mapping.
+  const auto base = reinterpret_cast<uintptr_t>(cd.coordinates().data());
+  CINCH_ASSERT(EQ, base % flecsi::io::csr_alignment, 0);
+
+} // TEST
+
+TEST(csr_definition, malformed) {
+
+  flecsi::io::simple_definition_t sd("simple2d-8x8.msh");
+
+  flecsi::io::temporary_file_t file(".csr");
+  flecsi::io::write_csr_definition(sd, file.path());
+
+  flecsi::io::csr_header_t header;
+
+  {
+    std::ifstream in(file.path(), std::ifstream::binary);
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+  } // scope
+
+  // Overwrite part of the file in place.
+  auto patch = [&file](uint64_t offset, const auto & value) {
+    std::fstream out(file.path(),
+      std::fstream::in | std::fstream::out | std::fstream::binary);
+    out.seekp(offset);
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  }; // patch
+
+  // An offsets section that runs past the end of the file.
+  auto bad = header;
+  bad.offsets_offset = header.file_size - flecsi::io::csr_alignment;
+  patch(0, bad);
+  EXPECT_DEATH(flecsi::io::csr_definition__<2> cd(file.path()), "offsets");
+
+  // Offsets that decrease.
+  patch(0, header);
+  patch(header.offsets_offset + 2*sizeof(uint64_t), uint64_t(1));
+  EXPECT_DEATH(flecsi::io::csr_definition__<2> cd(file.path()), "decreasing");
+
+  // A last offset that does not match the number of indices.
+  bad = header;
+  bad.num_indices = header.num_indices - 1;
+  patch(0, bad);
+  patch(header.offsets_offset + 2*sizeof(uint64_t), uint64_t(8));
+  EXPECT_DEATH(flecsi::io::csr_definition__<2> cd(file.path()),
+    "number of indices");
+
+} // TEST
+
+/*----------------------------------------------------------------------------*
+ * Cinch test Macros
+ *
+ *  ==== I/O ====
+ *  CINCH_CAPTURE()              : Insertion stream for capturing output.
+ *                                 Captured output can be written or
+ *                                 compared using the macros below.
+ *
+ *    EXAMPLE:
+ *      CINCH_CAPTURE() << "My value equals: " << myvalue << std::endl;
+ *
+ *  CINCH_COMPARE_BLESSED(file); : Compare captured output with
+ *                                 contents of a blessed file.
+ *
+ *  CINCH_WRITE(file);           : Write captured output to file.
+ *
+ *  CINCH_ASSERT(ASSERTION, ...) : Call Google test macro and automatically
+ *                                 dump captured output (from CINCH_CAPTURE)
+ *                                 on failure.
+ *
+ *  CINCH_EXPECT(ASSERTION, ...) : Call Google test macro and automatically
+ *                                 dump captured output (from CINCH_CAPTURE)
+ *                                 on failure.
+ *
+ * Google Test Macros
+ *
+ * Basic Assertions:
+ *
+ *  ==== Fatal ====             ==== Non-Fatal ====
+ *  ASSERT_TRUE(condition);     EXPECT_TRUE(condition)
+ *  ASSERT_FALSE(condition);    EXPECT_FALSE(condition)
+ *
+ * Binary Comparison:
+ *
+ *  ==== Fatal ====             ==== Non-Fatal ====
+ *  ASSERT_EQ(val1, val2);      EXPECT_EQ(val1, val2)
+ *  ASSERT_NE(val1, val2);      EXPECT_NE(val1, val2)
+ *  ASSERT_LT(val1, val2);      EXPECT_LT(val1, val2)
+ *  ASSERT_LE(val1, val2);      EXPECT_LE(val1, val2)
+ *  ASSERT_GT(val1, val2);      EXPECT_GT(val1, val2)
+ *  ASSERT_GE(val1, val2);      EXPECT_GE(val1, val2)
+ *
+ * String Comparison:
+ *
+ *  ==== Fatal ====                     ==== Non-Fatal ====
+ *  ASSERT_STREQ(expected, actual);     EXPECT_STREQ(expected, actual)
+ *  ASSERT_STRNE(expected, actual);     EXPECT_STRNE(expected, actual)
+ *  ASSERT_STRCASEEQ(expected, actual); EXPECT_STRCASEEQ(expected, actual)
+ *  ASSERT_STRCASENE(expected, actual); EXPECT_STRCASENE(expected, actual)
+ *----------------------------------------------------------------------------*/
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
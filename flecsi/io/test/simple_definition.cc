@@ -5,7 +5,10 @@
 
 #include <cinchtest.h>
 
+#include <fstream>
+
 #include <flecsi/io/simple_definition.h>
+#include <flecsi/io/test/temporary_file.h>
 #include <flecsi/topology/closure_utils.h>
 
 TEST(simple_definition, simple) {
@@ -51,6 +54,56 @@ TEST(simple_definition, simple) {
 
 } // TEST
 
+TEST(simple_definition, binary) {
+
+  flecsi::io::simple_definition_t ascii("simple2d-8x8.msh");
+
+  CINCH_ASSERT(FALSE, ascii.binary());
+
+  // Write a binary copy of the ascii mesh in the mesh-gen layout.
+  flecsi::io::temporary_file_t file(".msh");
+
+  {
+    std::ofstream out(file.path(),
+      std::ofstream::out | std::ofstream::binary);
+
+    auto write = [&out](const auto & value) {
+      out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    };
+
+    write(ascii.num_entities(0));
+    write(ascii.num_entities(2));
+
+    for(size_t v(0); v<ascii.num_entities(0); ++v) {
+      auto coords = ascii.vertex(v);
+      write(coords[0]);
+      write(coords[1]);
+    } // for
+
+    for(size_t c(0); c<ascii.num_entities(2); ++c) {
+      for(auto id: ascii.entities(2, 0, c)) {
+        write(id);
+      } // for
+    } // for
+  } // scope
+
+  flecsi::io::simple_definition_t binary(file.path());
+
+  CINCH_ASSERT(TRUE, binary.binary());
+  CINCH_ASSERT(EQ, binary.num_entities(0), ascii.num_entities(0));
+  CINCH_ASSERT(EQ, binary.num_entities(2), ascii.num_entities(2));
+
+  for(size_t c(0); c<ascii.num_entities(2); ++c) {
+    CINCH_ASSERT(EQ, binary.entities(2, 0, c), ascii.entities(2, 0, c));
+  } // for
+
+  for(size_t v(0); v<ascii.num_entities(0); ++v) {
+    CINCH_ASSERT(EQ, binary.vertex(v)[0], ascii.vertex(v)[0]);
+    CINCH_ASSERT(EQ, binary.vertex(v)[1], ascii.vertex(v)[1]);
+  } // for
+
+} // TEST
+
 TEST(simple_definition, neighbors) {
 
   flecsi::io::simple_definition_t sd("simple2d-8x8.msh");
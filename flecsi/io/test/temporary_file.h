@@ -0,0 +1,59 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <unistd.h>
+
+#include <flecsi/utils/logging.h>
+
+namespace flecsi {
+namespace io {
+
+//----------------------------------------------------------------------------//
+//! A uniquely named file in the temporary directory that is removed when
+//! the object goes out of scope, so that the tests do not leave output in
+//! the working directory.
+//----------------------------------------------------------------------------//
+
+class temporary_file_t {
+public:
+  temporary_file_t(const char * suffix) {
+    const char * directory = std::getenv("TMPDIR");
+    path_ = std::string(directory ? directory : "/tmp") + "/flecsi-XXXXXX" +
+            suffix;
+
+    const int fd = mkstemps(&path_[0], std::string(suffix).size());
+    clog_assert(fd != -1, "failed creating temporary file " << path_);
+    close(fd);
+  } // temporary_file_t
+
+  temporary_file_t(const temporary_file_t &) = delete;
+  temporary_file_t & operator=(const temporary_file_t &) = delete;
+
+  ~temporary_file_t() {
+    std::remove(path_.c_str());
+  } // ~temporary_file_t
+
+  const char * path() const {
+    return path_.c_str();
+  } // path
+
+private:
+  std::string path_;
+
+}; // class temporary_file_t
+
+} // namespace io
+} // namespace flecsi
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
@@ -12,6 +12,9 @@
    All rights reserved.
                                                                               */
 
+#include <algorithm>
+#include <cmath>
+
 #include <cinchlog.h>
 #include <mpi.h>
 
@@ -73,146 +76,24 @@ void add_colorings(coloring_map_t map) {
   {
   clog_tag_guard(coloring);
   clog_container_one(info, "primary coloring", cells.primary, clog::space);
-  } // guard
-
-  // Compute the dependency closure of the primary cell coloring
-  // through vertex intersections (specified by last argument "0").
-  // To specify edge or face intersections, use 1 (edges) or 2 (faces).
-  auto closure = flecsi::topology::entity_neighbors<2,2,0>(sd, cells.primary);
-
-  {
-  clog_tag_guard(coloring);
-  clog_container_one(info, "closure", closure, clog::space);
-  } // guard
-
-  // Subtracting out the initial set leaves just the nearest
-  // neighbors. This is similar to the image of the adjacency
-  // graph of the initial indices.
-  auto nearest_neighbors =
-    flecsi::utils::set_difference(closure, cells.primary);
-
-  {
-  clog_tag_guard(coloring);
-  clog_container_one(info, "nearest neighbors", nearest_neighbors, clog::space);
+  clog_one(info) << "edgecut " << colorer->statistics().edgecut <<
+    ", imbalance " << colorer->statistics().imbalance[0] << std::endl;
   } // guard
 
   // Create a communicator instance to get neighbor information.
   auto communicator = std::make_shared<flecsi::coloring::mpi_communicator_t>();
 
-  // Get the intersection of our nearest neighbors with the nearest
-  // neighbors of other ranks. This map of sets will only be populated
-  // with intersections that are non-empty
-  auto closure_intersection_map =
-    communicator->get_intersection_info(nearest_neighbors);
-
-  {
-  clog_tag_guard(coloring);
-
-  for(auto ci: closure_intersection_map) {
-    clog_container_one(info,
-      "closure intersection color " << ci.first << ":", ci.second, clog::space);
-  } // for
-  } // guard
-
-  // We can iteratively add halos of nearest neighbors, e.g.,
-  // here we add the next nearest neighbors. For most mesh types
-  // we actually need information about the ownership of these indices
-  // so that we can deterministically assign rank ownership to vertices.
-  auto nearest_neighbor_closure =
-    flecsi::topology::entity_neighbors<2,2,0>(sd, nearest_neighbors);
-
-  {
-  clog_tag_guard(coloring);
-  clog_container_one(info, "nearest neighbor closure",
-    nearest_neighbor_closure, clog::space);
-  } // guard
-
-  // Subtracting out the closure leaves just the
-  // next nearest neighbors.
-  auto next_nearest_neighbors =
-    flecsi::utils::set_difference(nearest_neighbor_closure, closure);
-
-  {
-  clog_tag_guard(coloring);
-  clog_container_one(info, "next nearest neighbor", next_nearest_neighbors,
-    clog::space);
-  } // guard
-
-  // The union of the nearest and next-nearest neighbors gives us all
-  // of the cells that might reference a vertex that we need.
-  auto all_neighbors = flecsi::utils::set_union(nearest_neighbors,
-    next_nearest_neighbors);
-
-  {
-  clog_tag_guard(coloring);
-  clog_container_one(info, "all neighbors", all_neighbors, clog::space);
-  } // guard
-
-  // Get the rank and offset information for our nearest neighbor
-  // dependencies. This also gives information about the ranks
-  // that access our shared cells.
-  auto cell_nn_info =
-    communicator->get_primary_info(cells.primary, nearest_neighbors);
-
-  // Get the rank and offset information for all relevant neighbor
-  // dependencies. This information will be necessary for determining
-  // shared vertices.
-  auto cell_all_info =
-    communicator->get_primary_info(cells.primary, all_neighbors);
-
-  // Create a map version of the local info for lookups below.
-  std::unordered_map<size_t, size_t> primary_indices_map;
-  {
-  size_t offset(0);
-  for(auto i: cells.primary) {
-    primary_indices_map[offset++] = i;
-  } // for
-  } // scope
-
-  // Create a map version of the remote info for lookups below.
+  // Compute the exclusive, shared and ghost cells, and the information
+  // about the neighboring cells that is needed to color the vertices.
+  std::set<size_t> closure;
   std::unordered_map<size_t, flecsi::coloring::entity_info_t> remote_info_map;
-  for(auto i: std::get<1>(cell_all_info)) {
-    remote_info_map[i.id] = i;
-  } // for
-
-  // Populate exclusive and shared cell information.
-  {
-  size_t offset(0);
-  for(auto i: std::get<0>(cell_nn_info)) {
-    if(i.size()) {
-      cells.shared.insert(
-        flecsi::coloring::entity_info_t(primary_indices_map[offset],
-        rank, offset, i));
-      
-      // Collect all colors with whom we require communication
-      // to send shared information.
-      cell_color_info.shared_users = flecsi::utils::set_union(
-        cell_color_info.shared_users, i);
-    }
-    else {
-      cells.exclusive.insert(
-        flecsi::coloring::entity_info_t(primary_indices_map[offset],
-        rank, offset, i));
-    } // if
-    ++offset;
-  } // for
-  } // scope
-  
-  // Populate ghost cell information.
-  {
-  size_t offset(0);
-  for(auto i: std::get<1>(cell_nn_info)) {
-    cells.ghost.insert(i);
-
-    // Collect all colors with whom we require communication
-    // to receive ghost information.
-    cell_color_info.ghost_owners.insert(i.rank);
-  } // for
-  } // scope
+  std::unordered_map<size_t, flecsi::coloring::entity_info_t>
+    shared_cells_map;
+  std::unordered_map<size_t, flecsi::utils::flat_set__<size_t>>
+    closure_intersection_map;
 
-  cell_color_info.exclusive = cells.exclusive.size();
-  cell_color_info.shared = cells.shared.size();
-  cell_color_info.ghost = cells.ghost.size();
+  color_cells<2>(sd, communicator.get(), closure, remote_info_map,
+    shared_cells_map, closure_intersection_map, cells, cell_color_info);
 
   {
   clog_tag_guard(coloring_output);
@@ -221,15 +102,6 @@ void add_colorings(coloring_map_t map) {
   clog_container_one(info, "ghost cells ", cells.ghost, clog::newline);
   } // guard
 
-  // Create a map version for lookups below.
-  std::unordered_map<size_t, flecsi::coloring::entity_info_t>
-    shared_cells_map;
-  {
-  for(auto i: cells.shared) {
-    shared_cells_map[i.id] = i;
-  } // for
-  } // scope
-
   //--------------------------------------------------------------------------//
   //--------------------------------------------------------------------------//
 
@@ -410,20 +282,29 @@ void add_colorings(coloring_map_t map) {
     ghost_cells_map[i.id] = i;
   } // for
 
+  // The primary vertices are the exclusive and shared vertices, which
+  // are merged into the primary set at once.
+  std::vector<size_t> primary_vertex_ids;
+  primary_vertex_ids.reserve(
+    vertices.exclusive.size() + vertices.shared.size());
+
   std::unordered_map<size_t, flecsi::coloring::entity_info_t>
     exclusive_vertices_map;
-  for(auto i: vertices.exclusive) {
+  for(auto & i: vertices.exclusive) {
     exclusive_vertices_map[i.id] = i;
-    vertices.primary.insert(i.id);
+    primary_vertex_ids.push_back(i.id);
   } // for
 
   std::unordered_map<size_t, flecsi::coloring::entity_info_t>
     shared_vertices_map;
-  for(auto i: vertices.shared) {
+  for(auto & i: vertices.shared) {
     shared_vertices_map[i.id] = i;
-    vertices.primary.insert(i.id);
+    primary_vertex_ids.push_back(i.id);
   } // for
 
+  vertices.primary.insert(primary_vertex_ids.begin(),
+    primary_vertex_ids.end());
+
   std::unordered_map<size_t, flecsi::coloring::entity_info_t>
     ghost_vertices_map;
   for(auto i: vertices.ghost) {
@@ -447,5 +328,115 @@ void add_colorings(coloring_map_t map) {
 
 flecsi_register_mpi_task(add_colorings, flecsi::execution);
 
+#if FLECSI_RUNTIME_MODEL == FLECSI_RUNTIME_MODEL_mpi
+void repartition_colorings(coloring_map_t map, field_id_t cost) {
+
+  clog_set_output_rank(0);
+
+  // Get the context instance.
+  context_t & context_ = context_t::instance();
+
+  int rank, size;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  {
+  clog_tag_guard(coloring);
+  clog(info) << "repartition_colorings, rank: " << rank << std::endl;
+  }
+
+#ifdef FLECSI_8_8_MESH
+  flecsi::io::simple_definition_t sd("simple2d-8x8.msh");
+#else
+  flecsi::io::simple_definition_t sd("simple2d-16x16.msh");
+#endif
+
+  // Create the dCRS representation of the current cell coloring.
+  auto dcrs = flecsi::coloring::make_dcrs(sd, context_.coloring(map.cells),
+    context_.coloring_info(map.cells));
+
+  // The cost of the exclusive and shared cells, which are the first cells
+  // of the local order, is scaled to integer weights in [1, 1000].
+  auto & field_data = context_.registered_field_data();
+  auto fitr = field_data.find(cost);
+  clog_assert(fitr != field_data.end(), "invalid cost field " << cost);
+
+  const double * costs = reinterpret_cast<const double *>(fitr->second.data());
+
+  double max_cost = 0.0;
+  for(size_t i(0); i<dcrs.size(); ++i) {
+    max_cost = std::max(max_cost, costs[i]);
+  } // for
+
+  MPI_Allreduce(MPI_IN_PLACE, &max_cost, 1, MPI_DOUBLE, MPI_MAX,
+    MPI_COMM_WORLD);
+
+  if(max_cost > 0.0) {
+    for(size_t i(0); i<dcrs.size(); ++i) {
+      dcrs.vertex_weights.push_back(
+        std::max(1l, std::lround(1000.0*costs[i]/max_cost)));
+    } // for
+  } // if
+
+  // Create the new primary coloring.
+  auto colorer = std::make_shared<flecsi::coloring::parmetis_colorer_t>();
+
+  flecsi::coloring::index_coloring_t cells;
+  flecsi::coloring::coloring_info_t cell_color_info;
+
+  cells.primary = colorer->repartition(dcrs);
+
+  {
+  clog_tag_guard(coloring);
+  clog_container_one(info, "primary coloring", cells.primary, clog::space);
+  clog_one(info) << "edgecut " << colorer->statistics().edgecut <<
+    ", imbalance " << colorer->statistics().imbalance[0] << std::endl;
+  } // guard
+
+  // Color the cells and the vertices, as in add_colorings.
+  auto communicator = std::make_shared<flecsi::coloring::mpi_communicator_t>();
+
+  std::set<size_t> closure;
+  std::unordered_map<size_t, flecsi::coloring::entity_info_t> remote_info_map;
+  std::unordered_map<size_t, flecsi::coloring::entity_info_t>
+    shared_cells_map;
+  std::unordered_map<size_t, flecsi::utils::flat_set__<size_t>>
+    closure_intersection_map;
+
+  color_cells<2>(sd, communicator.get(), closure, remote_info_map,
+    shared_cells_map, closure_intersection_map, cells, cell_color_info);
+
+  flecsi::coloring::index_coloring_t vertices;
+  coloring::coloring_info_t vertex_color_info;
+
+  color_entity<2, 0>(sd, communicator.get(), closure, remote_info_map,
+    shared_cells_map, closure_intersection_map, vertices, vertex_color_info);
+
+  {
+  clog_tag_guard(coloring);
+  clog(info) << cell_color_info << std::endl << std::flush;
+  clog(info) << vertex_color_info << std::endl << std::flush;
+  } // gaurd
+
+  // Replace the colorings, and migrate the field data.
+  std::map<size_t, flecsi::coloring::index_coloring_t> colorings;
+  colorings[map.cells] = std::move(cells);
+  colorings[map.vertices] = std::move(vertices);
+
+  std::map<size_t,
+    std::unordered_map<size_t, flecsi::coloring::coloring_info_t>>
+    coloring_info;
+  coloring_info[map.cells] =
+    communicator->gather_coloring_info(cell_color_info);
+  coloring_info[map.vertices] =
+    communicator->gather_coloring_info(vertex_color_info);
+
+  migrate_colorings(colorings, coloring_info);
+
+} // repartition_colorings
+
+flecsi_register_mpi_task(repartition_colorings, flecsi::execution);
+#endif // FLECSI_RUNTIME_MODEL
+
 } // namespace execution
 } // namespace flecsi
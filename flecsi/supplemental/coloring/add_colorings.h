@@ -15,6 +15,10 @@
 
 /*! @file */
 
+#include <flecsi-config.h>
+
+#include <flecsi/runtime/types.h>
+
 namespace flecsi {
 namespace execution {
 
@@ -26,5 +30,20 @@ struct coloring_map_t
 
 void add_colorings(coloring_map_t map);
 
+#if FLECSI_RUNTIME_MODEL == FLECSI_RUNTIME_MODEL_mpi
+/*!
+ Repartition the cells and the vertices of the colorings of add_colorings
+ during a run, so that the cost of the cells is balanced over the colors,
+ and migrate the field data to the new colorings (see migrate_colorings).
+ The topology of the mesh must then be initialized again.
+
+ @param map  The index spaces of the colorings.
+ @param cost The field id of a dense double field on the cells, with the
+             measured cost of each cell, e.g., its compute time.
+ */
+
+void repartition_colorings(coloring_map_t map, field_id_t cost);
+#endif
+
 } // namespace execution
 } // namespace flecsi
@@ -15,19 +15,188 @@
 
 /*! @file */
 
+#include <iterator>
+#include <limits>
+#include <vector>
+
 #include <cinchlog.h>
 
 #include <flecsi/coloring/colorer.h>
 #include <flecsi/coloring/communicator.h>
 #include <flecsi/coloring/dcrs_utils.h>
-#include <flecsi/execution/execution.h>
+#include <flecsi/topology/closure_utils.h>
 #include <flecsi/topology/mesh_definition.h>
+#include <flecsi/utils/set_utils.h>
 
 clog_register_tag(coloring_functions);
 
 namespace flecsi {
 namespace execution {
 
+//----------------------------------------------------------------------------//
+//! Color the cells, given their primary coloring in cells.primary: compute
+//! the exclusive, shared and ghost cells, and the information about the
+//! neighboring cells that color_entity needs to color the other entities.
+//!
+//! @tparam DIMENSION The dimension of the cells.
+//----------------------------------------------------------------------------//
+
+template <
+  size_t DIMENSION,
+  typename CLOSURE_SET,
+  typename ENTITY_MAP,
+  typename INTERSECTION_MAP,
+  typename INDEX_COLOR,
+  typename COLOR_INFO
+>
+void color_cells(
+  topology::mesh_definition__<DIMENSION> const & md,
+  coloring::communicator_t * communicator,
+  CLOSURE_SET & closure,
+  ENTITY_MAP & remote_info_map,
+  ENTITY_MAP & shared_cells_map,
+  INTERSECTION_MAP & closure_intersection_map,
+  INDEX_COLOR & cells,
+  COLOR_INFO & cell_color_info
+)
+{
+  constexpr auto cell_dim = DIMENSION;
+
+  using entity_info_t = flecsi::coloring::entity_info_t;
+
+  auto rank = communicator->rank();
+
+  // Compute the dependency closure of the primary cell coloring
+  // through vertex intersections (specified by last argument "0").
+  // To specify edge or face intersections, use 1 (edges) or 2 (faces).
+  closure = flecsi::topology::entity_neighbors<cell_dim, cell_dim, 0>(
+    md, cells.primary);
+
+  {
+    clog_tag_guard(coloring_functions);
+    clog_container_one(info, "closure", closure, clog::space);
+  } // guard
+
+  // Subtracting out the initial set leaves just the nearest
+  // neighbors. This is similar to the image of the adjacency
+  // graph of the initial indices.
+  auto nearest_neighbors =
+    flecsi::utils::set_difference(closure, cells.primary);
+
+  {
+    clog_tag_guard(coloring_functions);
+    clog_container_one(info, "nearest neighbors", nearest_neighbors,
+      clog::space);
+  } // guard
+
+  // Get the intersection of our nearest neighbors with the nearest
+  // neighbors of other ranks. This map of sets will only be populated
+  // with intersections that are non-empty
+  closure_intersection_map =
+    communicator->get_intersection_info(nearest_neighbors);
+
+  {
+    clog_tag_guard(coloring_functions);
+
+    for(auto & ci: closure_intersection_map) {
+      clog_container_one(info,
+        "closure intersection color " << ci.first << ":", ci.second,
+        clog::space);
+    } // for
+  } // guard
+
+  // We can iteratively add halos of nearest neighbors, e.g.,
+  // here we add the next nearest neighbors. For most mesh types
+  // we actually need information about the ownership of these indices
+  // so that we can deterministically assign rank ownership to vertices.
+  auto nearest_neighbor_closure =
+    flecsi::topology::entity_neighbors<cell_dim, cell_dim, 0>(
+      md, nearest_neighbors);
+
+  {
+    clog_tag_guard(coloring_functions);
+    clog_container_one(info, "nearest neighbor closure",
+      nearest_neighbor_closure, clog::space);
+  } // guard
+
+  // Subtracting out the closure leaves just the
+  // next nearest neighbors.
+  auto next_nearest_neighbors =
+    flecsi::utils::set_difference(nearest_neighbor_closure, closure);
+
+  {
+    clog_tag_guard(coloring_functions);
+    clog_container_one(info, "next nearest neighbor", next_nearest_neighbors,
+      clog::space);
+  } // guard
+
+  // The union of the nearest and next-nearest neighbors gives us all
+  // of the cells that might reference a vertex that we need.
+  auto all_neighbors = flecsi::utils::set_union(nearest_neighbors,
+    next_nearest_neighbors);
+
+  {
+    clog_tag_guard(coloring_functions);
+    clog_container_one(info, "all neighbors", all_neighbors, clog::space);
+  } // guard
+
+  // Get the rank and offset information for our nearest neighbor
+  // dependencies. This also gives information about the ranks
+  // that access our shared cells.
+  auto cell_nn_info =
+    communicator->get_primary_info(cells.primary, nearest_neighbors);
+
+  // Get the rank and offset information for all relevant neighbor
+  // dependencies. This information will be necessary for determining
+  // shared vertices.
+  auto cell_all_info =
+    communicator->get_primary_info(cells.primary, all_neighbors);
+
+  // Create a map version of the remote info for lookups below.
+  for(auto & i: std::get<1>(cell_all_info)) {
+    remote_info_map[i.id] = i;
+  } // for
+
+  // Populate exclusive and shared cell information. The primary cells
+  // are visited in order, so the cells are appended to the sets.
+  {
+    size_t offset(0);
+    for(auto & i: std::get<0>(cell_nn_info)) {
+      if(i.size()) {
+        cells.shared.insert(
+          entity_info_t(cells.primary[offset], rank, offset, i));
+
+        // Collect all colors with whom we require communication
+        // to send shared information.
+        cell_color_info.shared_users.insert(i.begin(), i.end());
+      }
+      else {
+        cells.exclusive.insert(
+          entity_info_t(cells.primary[offset], rank, offset, i));
+      } // if
+      ++offset;
+    } // for
+  } // scope
+
+  // Populate ghost cell information.
+  for(auto & i: std::get<1>(cell_nn_info)) {
+    cells.ghost.insert(i);
+
+    // Collect all colors with whom we require communication
+    // to receive ghost information.
+    cell_color_info.ghost_owners.insert(i.rank);
+  } // for
+
+  cell_color_info.exclusive = cells.exclusive.size();
+  cell_color_info.shared = cells.shared.size();
+  cell_color_info.ghost = cells.ghost.size();
+
+  // Create a map version for lookups below.
+  for(auto & i: cells.shared) {
+    shared_cells_map[i.id] = i;
+  } // for
+} // color_cells
+
 //----------------------------------------------------------------------------//
 //! @tparam
 //----------------------------------------------------------------------------//
@@ -66,17 +235,22 @@ void color_entity(
   auto entity_closure = 
     flecsi::topology::entity_closure<cell_dim, ENTITY_DIM>(md, closure);
 
+  // The cells that reference each entity, i.e., the transpose of the
+  // cell to entity connectivity, so that the referencers of an entity are
+  // found without a search of all cells.
+  const auto entity_referencers = flecsi::topology::transpose(
+    md.entities_crs(cell_dim, ENTITY_DIM), md.num_entities(ENTITY_DIM));
+
   // Assign entity ownership
-  std::vector<std::set<size_t>> entity_requests(comm_size);
-  std::set<entity_info_t> entity_info;
+  std::vector<utils::flat_set__<size_t>> entity_requests(comm_size);
+  utils::flat_set__<entity_info_t> entity_info;
 
   {
     size_t offset(0);
     for(auto i: entity_closure) {
 
       // Get the set of cells that reference this entity.
-      auto referencers = 
-        flecsi::topology::entity_referencers<cell_dim, ENTITY_DIM>(md, i);
+      auto referencers = entity_referencers.view()[i];
 
       {
         clog_tag_guard(coloring_functions);
@@ -84,7 +258,7 @@ void color_entity(
       } // guard
 
       size_t min_rank(std::numeric_limits<size_t>::max());
-      std::set<size_t> shared_entities;
+      utils::flat_set__<size_t> shared_entities;
 
       // Iterate the direct referencers to assign entity ownership.
       for(auto c: referencers) {
@@ -115,7 +289,7 @@ void color_entity(
         // Iterate through the closure intersection map to see if the
         // indirect reference is part of another rank's closure, i.e.,
         // that it is an indirect dependency.
-        for(auto ci: closure_intersection_map) 
+        for(auto & ci: closure_intersection_map) 
           if(ci.second.find(c) != ci.second.end()) 
             shared_entities.insert(ci.first);
       } // for
@@ -136,14 +310,13 @@ void color_entity(
     communicator->get_entity_info(entity_info, entity_requests);
 
   // Vertices index coloring.
-  for(auto i: entity_info) {
+  for(auto & i: entity_info) {
     // if it belongs to other colors, its a shared entity
     if(i.shared.size()) {
       entities.shared.insert(i);
       // Collect all colors with whom we require communication
       // to send shared information.
-      entity_color_info.shared_users = 
-        flecsi::utils::set_union(entity_color_info.shared_users, i.shared);
+      entity_color_info.shared_users.insert(i.shared.begin(), i.shared.end());
     }
     // otherwise, its exclusive
     else 
@@ -151,12 +324,16 @@ void color_entity(
   } // for
 
   {
+    // The ghosts are sorted by owner first, so they are collected and
+    // merged into the ghost set at once.
+    std::vector<entity_info_t> ghosts;
+
     size_t r(0);
-    for(auto i: entity_requests) {
+    for(auto & i: entity_requests) {
 
       auto offset(entity_offset_info[r].begin());
       for(auto s: i) {
-        entities.ghost.insert(entity_info_t(s, r, *offset));
+        ghosts.emplace_back(s, r, *offset);
         // Collect all colors with whom we require communication
         // to receive ghost information.
         entity_color_info.ghost_owners.insert(r);
@@ -166,6 +343,9 @@ void color_entity(
 
       ++r;
     } // for
+
+    entities.ghost.insert(std::make_move_iterator(ghosts.begin()),
+      std::make_move_iterator(ghosts.end()));
   } // scope
 
   {
@@ -15,6 +15,10 @@
 
 /*! @file */
 
+#include <algorithm>
+#include <set>
+#include <vector>
+
 #include <flecsi/topology/mesh_definition.h>
 #include <flecsi/utils/logging.h>
 #include <flecsi/utils/set_utils.h>
@@ -23,6 +27,92 @@
 namespace flecsi {
 namespace topology {
 
+///
+/// Return the transpose of the given connectivity, i.e., for each entity
+/// referenced by \em crs, the rows of \em crs that reference it. The
+/// rows of the result are sorted.
+///
+/// \param crs The connectivity to transpose.
+/// \param num_targets The number of entities referenced by \em crs.
+///
+inline crs_storage_t
+transpose(const crs_view_t & crs, size_t num_targets) {
+  crs_storage_t result;
+
+  // Count the references to each target.
+  result.offsets.assign(num_targets + 1, 0);
+  for (auto i : crs.indices) {
+    ++result.offsets[i + 1];
+  } // for
+
+  for (size_t t(0); t < num_targets; ++t) {
+    result.offsets[t + 1] += result.offsets[t];
+  } // for
+
+  // Scatter the row ids. Rows are visited in order, so each result row
+  // comes out sorted.
+  std::vector<size_t> fill(result.offsets.begin(), result.offsets.end() - 1);
+  result.indices.resize(crs.indices.size());
+
+  for (size_t r(0); r < crs.size(); ++r) {
+    for (auto i : crs[r]) {
+      result.indices[fill[i]++] = r;
+    } // for
+  } // for
+
+  return result;
+} // transpose
+
+///
+/// Compute the neighbors of an entity through shared vertices.
+///
+/// \param e2v The entity-to-vertex connectivity.
+/// \param v2e The vertex-to-entity connectivity (the transpose of e2v).
+/// \param id The entity for which neighbors are requested.
+/// \param thru_dim The number of shared vertices must exceed this value.
+/// \param scratch Work space. Its capacity is reused between calls.
+/// \param neighbors On return, the sorted neighbor ids. Its capacity is
+///                  reused between calls.
+///
+inline void
+crs_neighbors(
+    const crs_view_t & e2v,
+    const crs_view_t & v2e,
+    size_t id,
+    size_t thru_dim,
+    std::vector<size_t> & scratch,
+    std::vector<size_t> & neighbors) {
+  scratch.clear();
+  neighbors.clear();
+
+  // Collect every entity that shares a vertex with this one. An entity
+  // appears once for each shared vertex.
+  for (auto v : e2v[id]) {
+    for (auto other : v2e[v]) {
+      if (other != id) {
+        scratch.push_back(other);
+      } // if
+    } // for
+  } // for
+
+  std::sort(scratch.begin(), scratch.end());
+
+  // Keep the entities with enough shared vertices.
+  for (size_t i(0); i < scratch.size();) {
+    size_t j(i);
+
+    while (j < scratch.size() && scratch[j] == scratch[i]) {
+      ++j;
+    } // while
+
+    if (j - i > thru_dim) {
+      neighbors.push_back(scratch[i]);
+    } // if
+
+    i = j;
+  } // for
+} // crs_neighbors
+
 ///
 /// Find the neighbors of the given entity id.
 ///
@@ -40,29 +130,33 @@ namespace topology {
 template<size_t from_dim, size_t to_dim, size_t thru_dim, size_t D>
 std::set<size_t>
 entity_neighbors(const mesh_definition__<D> & md, size_t entity_id) {
-  // Get the vertices of the requested id
-  auto vertices = md.entities_set(from_dim, 0, entity_id);
+  // Get the sorted vertices of the requested id
+  auto row = md.entities_crs(from_dim, 0)[entity_id];
+  std::vector<size_t> vertices(row.begin(), row.end());
+  std::sort(vertices.begin(), vertices.end());
 
   // Put the results into set form
   std::set<size_t> neighbors;
 
+  const auto other = md.entities_crs(to_dim, 0);
+
   // Go through the entities of the to_dim
-  for (size_t e(0); e < md.num_entities(to_dim); ++e) {
+  for (size_t e(0); e < other.size(); ++e) {
 
     // Skip the input id if the dimensions are the same
     if (from_dim == to_dim && e == entity_id) {
       continue;
     } // if
 
-    // Get the vertices that define the current entity from the to_dim
-    auto other = md.entities_set(to_dim, 0, e);
-
-    // Get the intersection set
-    auto intersect = flecsi::utils::set_intersection(vertices, other);
+    // Count the vertices that are shared with the current entity
+    size_t shared(0);
+    for (auto v : other[e]) {
+      shared += std::binary_search(vertices.begin(), vertices.end(), v);
+    } // for
 
     // Add this entity id if the intersection shares at least
     // intersections vertices
-    if (intersect.size() > thru_dim) {
+    if (shared > thru_dim) {
       neighbors.insert(e);
     } // if
   } // for
@@ -100,46 +194,18 @@ entity_neighbors(const mesh_definition__<D> & md, U && indices) {
   std::set<size_t> closure(
       std::forward<U>(indices).begin(), std::forward<U>(indices).end());
 
-  using entityid = size_t;
-  using vertexid = size_t;
-
-  // essentially vertex to cell and cell to cell through vertices
-  // connectivity.
-  std::map<vertexid, std::vector<entityid>> vertex2entities;
-  std::map<entityid, std::vector<entityid>> entity_neighbors;
-
-  // build global entity to entity through # of shared vertices connectivity
-  for (size_t cell(0); cell < md.num_entities(from_dim); ++cell) {
-    std::map<entityid, size_t> cell_counts;
-    for (auto vertex : md.entities(from_dim, 0, cell)) {
-      // build vertex to cell connectivity, O(n_cells * n_polygon_sides)
-      // of insert().
-      vertex2entities[vertex].push_back(cell);
-
-      // Count the number of times this cell shares a common vertex with
-      // some other cell. O(n_cells * n_polygon_sides * vertex to cells degrees)
-      for (auto other : vertex2entities[vertex]) {
-        // for (auto other : md.entities(0, from_dim, vertex)) {
-        if (other != cell)
-          cell_counts[other] += 1;
-      }
-    }
-
-    for (auto count : cell_counts) {
-      if (count.second > thru_dim) {
-        // append cell to cell through "dimension" connectivity, we need to
-        // add both directions
-        entity_neighbors[cell].push_back(count.first);
-        entity_neighbors[count.first].push_back(cell);
-      }
-    }
-  }
+  // Entity to vertex connectivity and its transpose, so that only the
+  // entities that share a vertex with a given entity are visited.
+  const auto e2v = md.entities_crs(from_dim, 0);
+  const auto v2e = transpose(e2v, md.num_entities(0));
+
+  std::vector<size_t> scratch;
+  std::vector<size_t> neighbors;
 
   for (auto i : indices) {
-    for (auto n : entity_neighbors[i]) {
-      closure.insert(n);
-    }
-  }
+    crs_neighbors(e2v, v2e.view(), i, thru_dim, scratch, neighbors);
+    closure.insert(neighbors.begin(), neighbors.end());
+  } // for
 
   return closure;
 } // entity_closure
@@ -159,12 +225,14 @@ std::set<size_t>
 entity_referencers(const mesh_definition__<D> & md, size_t id) {
   std::set<size_t> referencers;
 
+  const auto crs = md.entities_crs(from_dim, to_dim);
+
   // Iterate over entities adding any entity that contains
   // the vertex id to the set.
-  for (size_t e(0); e < md.num_entities(from_dim); ++e) {
+  for (size_t e(0); e < crs.size(); ++e) {
 
     // Get the vertex ids of current cell
-    const auto & eset = md.entities(from_dim, to_dim, e);
+    const auto eset = crs[e];
 
     // If the cell references this vertex add it
     if (std::find(eset.begin(), eset.end(), id) != eset.end())
@@ -191,10 +259,12 @@ std::set<size_t>
 entity_closure(const mesh_definition__<D> & md, U && indices) {
   std::set<size_t> closure;
 
+  const auto crs = md.entities_crs(from_dim, to_dim);
+
   // Iterate over the entities in indices and add any vertices that are
   // referenced by one of the entity indices
   for (auto i : std::forward<U>(indices)) {
-    const auto & vset = md.entities(from_dim, to_dim, i);
+    const auto vset = crs[i];
     closure.insert(vset.begin(), vset.end());
   } // for
 
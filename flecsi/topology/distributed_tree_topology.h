@@ -0,0 +1,700 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <flecsi-config.h>
+
+#if !defined(FLECSI_ENABLE_MPI)
+#error FLECSI_ENABLE_MPI not defined! This file depends on MPI!
+#endif
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <flecsi/coloring/mpi_utils.h>
+#include <flecsi/topology/tree_topology.h>
+#include <flecsi/utils/radix_sort.h>
+
+/*
+  The distributed tree topology partitions the entities of a tree topology
+  across the ranks of an MPI communicator. Each rank owns a contiguous
+  range of Morton keys, i.e., branch ids at the maximum depth, and stores
+  the entities whose keys are in its range in a local tree. The key range
+  of a rank is covered by a minimal set of branches, its top-level
+  branches, whose geometry is known to all ranks.
+
+  Ghost copies of the remote entities within a given distance of a rank's
+  top-level branches are inserted into its local tree, so the queries of
+  the tree topology, e.g., find_in_radius and apply_in_radius, see remote
+  entities within that distance transparently. Ghost entities always
+  follow the owned entities, i.e., an entity is a ghost if its id is
+  greater than or equal to num_owned().
+
+  Entities are exchanged by value, as raw bytes, so the entity type must
+  not own any resources, e.g., heap memory. This is approximated by
+  requiring a trivially destructible entity type.
+*/
+
+namespace flecsi {
+namespace topology {
+
+//-----------------------------------------------------------------//
+//! The distributed tree topology is parameterized on the same policy as
+//! the tree topology.
+//-----------------------------------------------------------------//
+template<class P>
+class distributed_tree_topology : public tree_topology<P> {
+public:
+  using base_t = tree_topology<P>;
+
+  static const size_t dimension = base_t::dimension;
+
+  using element_t = typename base_t::element_t;
+
+  using point_t = typename base_t::point_t;
+
+  using branch_int_t = typename base_t::branch_int_t;
+
+  using branch_id_t = typename base_t::branch_id_t;
+
+  using branch_t = typename base_t::branch_t;
+
+  using entity_t = typename base_t::entity_t;
+
+  using box_t = typename base_t::box_t;
+
+  static_assert(
+      std::is_trivially_destructible<entity_t>::value,
+      "distributed_tree_topology requires a trivially destructible entity "
+      "type");
+
+  //-----------------------------------------------------------------//
+  //! The aggregate of the owned entities within a top-level branch.
+  //-----------------------------------------------------------------//
+  template<typename T>
+  struct branch_aggregate__ {
+    branch_id_t id;
+    size_t rank;
+    size_t count;
+    T value;
+  };
+
+  //-----------------------------------------------------------------//
+  //! Construct a distributed tree topology with unit coordinates. The
+  //! key space is initially split evenly between the ranks.
+  //-----------------------------------------------------------------//
+  distributed_tree_topology(MPI_Comm comm = MPI_COMM_WORLD) : base_t() {
+    init_(comm);
+  }
+
+  //-----------------------------------------------------------------//
+  //! Construct a distributed tree topology with specified ranges
+  //! [start, end] for each dimension.
+  //-----------------------------------------------------------------//
+  distributed_tree_topology(
+      const point_t & start,
+      const point_t & end,
+      MPI_Comm comm = MPI_COMM_WORLD)
+      : base_t(start, end) {
+    init_(comm);
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the rank of this process in the communicator.
+  //-----------------------------------------------------------------//
+  size_t rank() const {
+    return rank_;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the number of ranks of the communicator.
+  //-----------------------------------------------------------------//
+  size_t num_ranks() const {
+    return size_;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Construct a new owned entity. Entities can only be created while
+  //! there are no ghosts. The entity is not inserted into the tree and
+  //! may belong to another rank until the next migrate() or partition().
+  //-----------------------------------------------------------------//
+  template<class... Args>
+  entity_t * make_entity(Args &&... args) {
+    assert(num_ghosts() == 0 && "cannot make entities with ghosts");
+
+    ++num_owned_;
+    return base_t::make_entity(std::forward<Args>(args)...);
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the number of owned entities.
+  //-----------------------------------------------------------------//
+  size_t num_owned() const {
+    return num_owned_;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the number of ghost entities.
+  //-----------------------------------------------------------------//
+  size_t num_ghosts() const {
+    return base_t::entities_.size() - num_owned_;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return true if the entity is a copy of a remote entity.
+  //-----------------------------------------------------------------//
+  bool is_ghost(const entity_t * ent) const {
+    return ent->id() >= num_owned_;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return an index space containing the owned entities.
+  //-----------------------------------------------------------------//
+  auto owned_entities() const {
+    return base_t::entities_.template slice<>(0, num_owned_);
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the Morton key of a point.
+  //-----------------------------------------------------------------//
+  branch_int_t key(const point_t & p) const {
+    return branch_id_t(base_t::range_, p, branch_id_t::max_depth).value_();
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the rank that owns a Morton key.
+  //-----------------------------------------------------------------//
+  size_t owner(branch_int_t k) const {
+    return std::upper_bound(splitters_.begin(), splitters_.end(), k) -
+           splitters_.begin() - 1;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the rank that owns a point.
+  //-----------------------------------------------------------------//
+  size_t owner(const point_t & p) const {
+    return owner(key(p));
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the first Morton key of each rank.
+  //-----------------------------------------------------------------//
+  const std::vector<branch_int_t> & splitters() const {
+    return splitters_;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the top-level branches of a rank.
+  //-----------------------------------------------------------------//
+  std::vector<branch_id_t> top_level_branches(size_t r) const {
+    std::vector<branch_id_t> ids;
+
+    for (size_t i = cover_offsets_[r]; i < cover_offsets_[r + 1]; ++i) {
+      ids.push_back(covers_[i].id);
+    }
+
+    return ids;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Send the owned entities whose keys are outside of this rank's key
+  //! range to their owners and rebuild the local tree. Called after the
+  //! entities have moved. Ghosts are discarded, and entity ids are
+  //! renumbered.
+  //-----------------------------------------------------------------//
+  void migrate() {
+    erase_ghosts_();
+
+    std::vector<std::vector<entity_t *>> send(size_);
+    std::vector<bool> leaving(num_owned_, false);
+
+    for (size_t i = 0; i < num_owned_; ++i) {
+      entity_t * ent = base_t::entities_[i];
+      const size_t r = owner(ent->coordinates());
+
+      if (r != rank_) {
+        send[r].push_back(ent);
+        leaving[i] = true;
+      }
+    }
+
+    auto recv = exchange_entities_(send);
+
+    base_t::erase_entities(
+        [&leaving](entity_t * ent) { return leaving[ent->id()]; });
+
+    for (const auto & s : recv) {
+      base_t::make_entity(*reinterpret_cast<const entity_t *>(&s));
+    }
+
+    num_owned_ = base_t::entities_.size();
+
+    base_t::build();
+  }
+
+  //-----------------------------------------------------------------//
+  //! Choose the key ranges so that each rank owns the same number of
+  //! entities, and migrate the entities to their new owners.
+  //-----------------------------------------------------------------//
+  void partition() {
+    partition([](entity_t *) { return 1.0; });
+  }
+
+  //-----------------------------------------------------------------//
+  //! Choose the key ranges so that each rank owns the same total weight,
+  //! as given by the callable object weight(entity_t *), and migrate the
+  //! entities to their new owners.
+  //!
+  //! The splitters are found by a concurrent bisection of the key space,
+  //! with one reduction of the weights below the candidate splitters per
+  //! bit of the keys.
+  //-----------------------------------------------------------------//
+  template<typename W>
+  void partition(W && weight) {
+    erase_ghosts_();
+
+    const size_t n = num_owned_;
+
+    std::vector<std::pair<branch_int_t, double>> keys(n);
+
+    for (size_t i = 0; i < n; ++i) {
+      entity_t * ent = base_t::entities_[i];
+      keys[i] = {key(ent->coordinates()), weight(ent)};
+    }
+
+    utils::radix_sort(keys);
+
+    std::vector<double> prefix(n + 1, 0.0);
+
+    for (size_t i = 0; i < n; ++i) {
+      prefix[i + 1] = prefix[i] + keys[i].second;
+    }
+
+    double total;
+    MPI_Allreduce(&prefix[n], &total, 1, MPI_DOUBLE, MPI_SUM, comm_);
+
+    // Search the key offsets [0, span) for the first key with at least
+    // the target weight below it.
+    const size_t m = size_ - 1;
+    std::vector<branch_int_t> lo(m, 0);
+    std::vector<branch_int_t> hi(m, key_last_ - key_first_);
+    std::vector<double> below(m);
+    std::vector<double> global_below(m);
+
+    for (size_t b = 0; b < branch_id_t::bits; ++b) {
+      for (size_t j = 0; j < m; ++j) {
+        const branch_int_t mid = lo[j] + (hi[j] - lo[j]) / 2;
+
+        auto itr = std::lower_bound(
+            keys.begin(), keys.end(), key_first_ + mid,
+            [](const std::pair<branch_int_t, double> & k, branch_int_t v) {
+              return k.first < v;
+            });
+
+        below[j] = prefix[itr - keys.begin()];
+      }
+
+      MPI_Allreduce(
+          below.data(), global_below.data(), int(m), MPI_DOUBLE, MPI_SUM,
+          comm_);
+
+      for (size_t j = 0; j < m; ++j) {
+        if (lo[j] == hi[j]) {
+          continue;
+        }
+
+        const branch_int_t mid = lo[j] + (hi[j] - lo[j]) / 2;
+        const double target = total * double(j + 1) / double(size_);
+
+        if (global_below[j] >= target) {
+          hi[j] = mid;
+        } else {
+          lo[j] = mid + 1;
+        }
+      }
+    }
+
+    for (size_t j = 0; j < m; ++j) {
+      splitters_[j + 1] = key_first_ + lo[j];
+    }
+
+    // The reductions need not be bitwise identical on all ranks.
+    MPI_Bcast(
+        splitters_.data(), int(size_),
+        coloring::mpi_typetraits__<branch_int_t>::type(), 0, comm_);
+
+    update_covers_();
+    migrate();
+  }
+
+  //-----------------------------------------------------------------//
+  //! Partition the entities again if the maximum number of owned
+  //! entities exceeds the average by more than the given tolerance.
+  //! Return true if the entities were partitioned.
+  //-----------------------------------------------------------------//
+  bool rebalance(double tolerance) {
+    return rebalance(tolerance, [](entity_t *) { return 1.0; });
+  }
+
+  //-----------------------------------------------------------------//
+  //! Partition the entities again if the maximum owned weight exceeds
+  //! the average by more than the given tolerance. Return true if the
+  //! entities were partitioned.
+  //-----------------------------------------------------------------//
+  template<typename W>
+  bool rebalance(double tolerance, W && weight) {
+    double local = 0.0;
+
+    for (size_t i = 0; i < num_owned_; ++i) {
+      local += weight(base_t::entities_[i]);
+    }
+
+    double max, total;
+    MPI_Allreduce(&local, &max, 1, MPI_DOUBLE, MPI_MAX, comm_);
+    MPI_Allreduce(&local, &total, 1, MPI_DOUBLE, MPI_SUM, comm_);
+
+    if (total == 0.0 || max * size_ <= (1.0 + tolerance) * total) {
+      return false;
+    }
+
+    partition(std::forward<W>(weight));
+
+    return true;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Replace the ghosts with copies of the remote entities within
+  //! distance radius of this rank's top-level branches.
+  //-----------------------------------------------------------------//
+  void exchange_ghosts(element_t radius) {
+    erase_ghosts_();
+
+    std::vector<size_t> remote;
+
+    for (size_t i = 0; i < covers_.size(); ++i) {
+      if (covers_[i].rank != rank_) {
+        remote.push_back(i);
+      }
+    }
+
+    std::vector<std::vector<entity_t *>> send(size_);
+
+    if (num_owned_ > 0) {
+      collect_ghosts_(base_t::root(), remote, radius * radius, send);
+    }
+
+    auto recv = exchange_entities_(send);
+
+    for (const auto & s : recv) {
+      entity_t * ent =
+          base_t::make_entity(*reinterpret_cast<const entity_t *>(&s));
+      base_t::insert(ent);
+    }
+  }
+
+  //-----------------------------------------------------------------//
+  //! Compute the aggregates of the owned entities within each top-level
+  //! branch and gather the aggregates of all ranks. The callable object
+  //! f(T &, entity_t *) adds an entity to an aggregate, which is
+  //! initially T(). Top-level branches without entities are omitted.
+  //-----------------------------------------------------------------//
+  template<typename T, typename F>
+  std::vector<branch_aggregate__<T>> exchange_aggregates(F && f) {
+    using aggregate_t = branch_aggregate__<T>;
+
+    static_assert(
+        std::is_trivially_destructible<T>::value,
+        "aggregate type must be trivially destructible");
+
+    const size_t first = cover_offsets_[rank_];
+    const size_t last = cover_offsets_[rank_ + 1];
+
+    std::vector<aggregate_t> local;
+
+    for (size_t i = first; i < last; ++i) {
+      local.push_back({covers_[i].id, rank_, 0, T()});
+    }
+
+    for (size_t i = 0; i < num_owned_; ++i) {
+      entity_t * ent = base_t::entities_[i];
+      const branch_int_t k = key(ent->coordinates());
+
+      auto itr = std::upper_bound(
+          covers_.begin() + first, covers_.begin() + last, k,
+          [](branch_int_t v, const cover_t & c) { return v < c.first; });
+
+      assert(itr != covers_.begin() + first && "entity not owned");
+
+      aggregate_t & a = local[itr - covers_.begin() - first - 1];
+      f(a.value, ent);
+      ++a.count;
+    }
+
+    local.erase(
+        std::remove_if(
+            local.begin(), local.end(),
+            [](const aggregate_t & a) { return a.count == 0; }),
+        local.end());
+
+    int count = int(local.size());
+    std::vector<int> counts(size_);
+
+    MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm_);
+
+    std::vector<int> offsets(size_ + 1, 0);
+
+    for (size_t r = 0; r < size_; ++r) {
+      offsets[r + 1] = offsets[r] + counts[r];
+    }
+
+    std::vector<aggregate_t> aggregates(offsets[size_]);
+    const auto type = coloring::mpi_typetraits__<aggregate_t>::type();
+
+    MPI_Allgatherv(
+        local.data(), count, type, aggregates.data(), counts.data(),
+        offsets.data(), type, comm_);
+
+    return aggregates;
+  }
+
+private:
+  // A top-level branch of a rank and the first key it contains.
+  struct cover_t {
+    branch_id_t id;
+    size_t rank;
+    branch_int_t first;
+    box_t box;
+  };
+
+  // Storage for an entity sent by value.
+  using entity_storage_t = typename std::
+      aligned_storage<sizeof(entity_t), alignof(entity_t)>::type;
+
+  void init_(MPI_Comm comm) {
+    comm_ = comm;
+
+    int rank, size;
+    MPI_Comm_rank(comm_, &rank);
+    MPI_Comm_size(comm_, &size);
+
+    rank_ = rank;
+    size_ = size;
+
+    constexpr size_t shift = branch_id_t::max_depth * dimension;
+
+    key_first_ = branch_id_t::root().value_() << shift;
+    key_last_ = key_first_ | ((branch_int_t(1) << shift) - 1);
+
+    const branch_int_t width = (key_last_ - key_first_) / size_ + 1;
+
+    splitters_.resize(size_);
+
+    for (size_t r = 0; r < size_; ++r) {
+      splitters_[r] = key_first_ + r * width;
+    }
+
+    update_covers_();
+  }
+
+  // Decompose the key range of each rank into a minimal set of aligned
+  // branches.
+  void update_covers_() {
+    covers_.clear();
+    cover_offsets_.assign(1, 0);
+
+    for (size_t r = 0; r < size_; ++r) {
+      const bool empty = r + 1 < size_ && splitters_[r] == splitters_[r + 1];
+
+      branch_int_t lo = splitters_[r];
+      const branch_int_t hi = r + 1 < size_ ? splitters_[r + 1] - 1 : key_last_;
+
+      while (!empty) {
+        // Find the largest aligned branch starting at lo within [lo, hi].
+        size_t l = branch_id_t::max_depth;
+        branch_int_t mask;
+
+        for (;; --l) {
+          mask = (branch_int_t(1) << l * dimension) - 1;
+
+          if ((lo & mask) == 0 && hi - lo >= mask) {
+            break;
+          }
+        }
+
+        branch_id_t id;
+        id.set_value_(lo >> l * dimension);
+
+        covers_.push_back({id, r, lo, base_t::branch_box(id)});
+
+        if (hi - lo == mask) {
+          break;
+        }
+
+        lo += mask + 1;
+      }
+
+      cover_offsets_.push_back(covers_.size());
+    }
+  }
+
+  void erase_ghosts_() {
+    if (num_ghosts() > 0) {
+      base_t::erase_entities(
+          [this](entity_t * ent) { return is_ghost(ent); });
+    }
+  }
+
+  // Squared distance between a point and a box.
+  static element_t distance2_(const point_t & p, const box_t & box) {
+    element_t d2 = 0;
+
+    for (size_t j = 0; j < dimension; ++j) {
+      const element_t d =
+          std::max({box[0][j] - p[j], p[j] - box[1][j], element_t(0)});
+      d2 += d * d;
+    }
+
+    return d2;
+  }
+
+  // Squared distance between two boxes.
+  static element_t distance2_(const box_t & a, const box_t & b) {
+    element_t d2 = 0;
+
+    for (size_t j = 0; j < dimension; ++j) {
+      const element_t d =
+          std::max({b[0][j] - a[1][j], a[0][j] - b[1][j], element_t(0)});
+      d2 += d * d;
+    }
+
+    return d2;
+  }
+
+  // Traverse the local tree, pruning the remote top-level branches that
+  // are farther than the ghost radius, and add the entities within the
+  // radius of a remote branch to the send list of its rank.
+  void collect_ghosts_(
+      branch_t * b,
+      const std::vector<size_t> & remote,
+      element_t radius2,
+      std::vector<std::vector<entity_t *>> & send) {
+
+    const box_t box = base_t::branch_box(b->id());
+
+    std::vector<size_t> near;
+
+    for (auto i : remote) {
+      if (distance2_(box, covers_[i].box) <= radius2) {
+        near.push_back(i);
+      }
+    }
+
+    if (near.empty()) {
+      return;
+    }
+
+    if (b->is_leaf()) {
+      for (auto ent : *b) {
+        // The covers are ordered by rank, so each entity is sent to a
+        // rank at most once.
+        size_t last = size_;
+
+        for (auto i : near) {
+          const cover_t & c = covers_[i];
+
+          if (c.rank != last &&
+              distance2_(ent->coordinates(), c.box) <= radius2) {
+            send[c.rank].push_back(ent);
+            last = c.rank;
+          }
+        }
+      }
+
+      return;
+    }
+
+    for (size_t ci = 0; ci < branch_t::num_children; ++ci) {
+      collect_ghosts_(base_t::child(b, ci), near, radius2, send);
+    }
+  }
+
+  // Send copies of entities to other ranks, and return the received
+  // copies in rank order.
+  std::vector<entity_storage_t>
+  exchange_entities_(const std::vector<std::vector<entity_t *>> & send) {
+    std::vector<int> send_counts(size_);
+    std::vector<int> send_offsets(size_ + 1, 0);
+
+    for (size_t r = 0; r < size_; ++r) {
+      send_counts[r] = int(send[r].size());
+      send_offsets[r + 1] = send_offsets[r] + send_counts[r];
+    }
+
+    std::vector<entity_storage_t> send_buf(send_offsets[size_]);
+
+    for (size_t r = 0; r < size_; ++r) {
+      for (size_t i = 0; i < send[r].size(); ++i) {
+        std::memcpy(
+            &send_buf[send_offsets[r] + i], send[r][i], sizeof(entity_t));
+      }
+    }
+
+    std::vector<int> recv_counts(size_);
+
+    MPI_Alltoall(
+        send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm_);
+
+    std::vector<int> recv_offsets(size_ + 1, 0);
+
+    for (size_t r = 0; r < size_; ++r) {
+      recv_offsets[r + 1] = recv_offsets[r] + recv_counts[r];
+    }
+
+    std::vector<entity_storage_t> recv_buf(recv_offsets[size_]);
+    const auto type = coloring::mpi_typetraits__<entity_storage_t>::type();
+
+    MPI_Alltoallv(
+        send_buf.data(), send_counts.data(), send_offsets.data(), type,
+        recv_buf.data(), recv_counts.data(), recv_offsets.data(), type, comm_);
+
+    return recv_buf;
+  }
+
+  MPI_Comm comm_;
+  size_t rank_;
+  size_t size_;
+
+  size_t num_owned_ = 0;
+
+  // The first and last keys at the maximum depth.
+  branch_int_t key_first_;
+  branch_int_t key_last_;
+
+  // The first key of each rank.
+  std::vector<branch_int_t> splitters_;
+
+  // The top-level branches, ordered by rank and key.
+  std::vector<cover_t> covers_;
+  std::vector<size_t> cover_offsets_;
+};
+
+} // namespace topology
+} // namespace flecsi
@@ -15,14 +15,83 @@
 
 /*! @file */
 
+#include <map>
+#include <mutex>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include <flecsi/geometry/point.h>
+#include <flecsi/utils/array_ref.h>
 
 namespace flecsi {
 namespace topology {
 
+//----------------------------------------------------------------------------//
+//! The crs_view_t type is a non-owning compressed-row view of the
+//! connectivity between two entity dimensions. Row \em i holds the ids of
+//! the entities that define entity \em i.
+//!
+//! @ingroup mesh-topology
+//----------------------------------------------------------------------------//
+
+struct crs_view_t {
+  utils::array_ref<size_t> offsets;
+  utils::array_ref<size_t> indices;
+
+  /// Return the number of rows.
+  size_t size() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  } // size
+
+  /// Return the ids of row \em i.
+  utils::array_ref<size_t> operator[](size_t i) const {
+    return utils::array_ref<size_t>(
+        indices.data() + offsets[i], offsets[i + 1] - offsets[i]);
+  } // operator []
+
+}; // struct crs_view_t
+
+//----------------------------------------------------------------------------//
+//! The crs_storage_t type owns compressed-row connectivity, e.g., the
+//! transpose of a crs_view_t.
+//!
+//! @ingroup mesh-topology
+//----------------------------------------------------------------------------//
+
+struct crs_storage_t {
+  std::vector<size_t> offsets;
+  std::vector<size_t> indices;
+
+  /// Return a view of this storage.
+  crs_view_t view() const {
+    return {offsets, indices};
+  } // view
+
+}; // struct crs_storage_t
+
+//----------------------------------------------------------------------------//
+//! Return the range [begin, end) of entity ids in block \em block of a
+//! naive distribution of \em num entities over \em num_blocks blocks. The
+//! remainder is spread over the last blocks, which matches the initial
+//! distribution used by the dcrs utilities.
+//!
+//! @ingroup mesh-topology
+//----------------------------------------------------------------------------//
+
+inline std::pair<size_t, size_t>
+naive_block_range(size_t num, size_t num_blocks, size_t block) {
+  const size_t quot = num / num_blocks;
+  const size_t rem = num % num_blocks;
+  const size_t extra = num_blocks - rem;
+
+  const size_t begin =
+      block * quot + (block > extra ? block - extra : 0);
+  const size_t end = begin + quot + (block >= extra ? 1 : 0);
+
+  return std::make_pair(begin, end);
+} // naive_block_range
+
 //----------------------------------------------------------------------------//
 //! The mesh_definition__ type...
 //!
@@ -88,10 +157,145 @@ public:
 
   virtual std::set<size_t>
   entities_set(size_t from_dimension, size_t to_dimension, size_t id) const {
-    auto vvec = entities(from_dimension, to_dimension, id);
-    return std::set<size_t>(vvec.begin(), vvec.end());
+    auto ids = entities(from_dimension, to_dimension, id);
+    return std::set<size_t>(ids.begin(), ids.end());
   } // entities_set
 
+  //--------------------------------------------------------------------------//
+  //! Interface to get the entities of dimension \em to that define all of
+  //! the entities of dimension \em from as a compressed-row view. The view
+  //! is valid for the lifetime of the definition.
+  //!
+  //! The default implementation assembles the view from entities() on the
+  //! first request and keeps it, so this is meant for bulk consumers that
+  //! walk the whole mesh. Per-entity queries should use entities().
+  //! Definitions that store their connectivity in compressed-row form
+  //! should override this to return their storage directly.
+  //!
+  //! @param from_dimension The dimension of the entities whose definitions
+  //!                       are being requested.
+  //! @param to_dimension   The dimension of the entities of the definitions.
+  //--------------------------------------------------------------------------//
+
+  virtual crs_view_t
+  entities_crs(size_t from_dimension, size_t to_dimension) const {
+    std::lock_guard<std::mutex> lock(crs_mutex_);
+
+    auto & cache = crs_cache_[std::make_pair(from_dimension, to_dimension)];
+
+    if (cache.full.offsets.empty()) {
+      assemble_crs_(from_dimension, to_dimension, 0,
+          num_entities(from_dimension), cache.full);
+    } // if
+
+    return cache.full.view();
+  } // entities_crs
+
+  //--------------------------------------------------------------------------//
+  //! Interface to get the entities of dimension \em to that define the
+  //! entities of dimension \em from with ids in [\em begin, \em end) as a
+  //! compressed-row view. Row \em i of the view holds the definition of
+  //! entity \em begin + \em i. The view is valid for the lifetime of the
+  //! definition.
+  //!
+  //! The default implementation assembles only the requested rows from
+  //! entities() and keeps them. Once the kept blocks would hold as many
+  //! rows as the whole mesh, the full connectivity is assembled instead and
+  //! later blocks are views into it. Definitions that store their
+  //! connectivity in compressed-row form, or that only hold a block of it,
+  //! should override this to return their storage directly.
+  //!
+  //! @param from_dimension The dimension of the entities whose definitions
+  //!                       are being requested.
+  //! @param to_dimension   The dimension of the entities of the definitions.
+  //! @param begin          The first entity id of the block.
+  //! @param end            One past the last entity id of the block.
+  //--------------------------------------------------------------------------//
+
+  virtual crs_view_t entities_crs(
+      size_t from_dimension,
+      size_t to_dimension,
+      size_t begin,
+      size_t end) const {
+    std::lock_guard<std::mutex> lock(crs_mutex_);
+
+    auto & cache = crs_cache_[std::make_pair(from_dimension, to_dimension)];
+
+    if (cache.full.offsets.empty()) {
+      auto block = cache.blocks.find(std::make_pair(begin, end));
+
+      if (block != cache.blocks.end()) {
+        return block->second.view();
+      } // if
+
+      const size_t num = num_entities(from_dimension);
+
+      if (cache.block_rows + (end - begin) < num) {
+        auto & crs = cache.blocks[std::make_pair(begin, end)];
+        assemble_crs_(from_dimension, to_dimension, begin, end, crs);
+        cache.block_rows += end - begin;
+        return crs.view();
+      } // if
+
+      assemble_crs_(from_dimension, to_dimension, 0, num, cache.full);
+    } // if
+
+    return {utils::array_ref<size_t>(
+                cache.full.offsets.data() + begin, end - begin + 1),
+        cache.full.indices};
+  } // entities_crs
+
+  //--------------------------------------------------------------------------//
+  //! Fill \em ids with the entities of dimension \em to that define the
+  //! entity of dimension \em from with the given identifier \em id.
+  //!
+  //! @return The number of entities written to \em ids.
+  //--------------------------------------------------------------------------//
+
+  size_t fill_entities(
+      size_t from_dimension,
+      size_t to_dimension,
+      size_t id,
+      std::vector<size_t> & ids) const {
+    auto row = entities(from_dimension, to_dimension, id);
+    ids.assign(row.begin(), row.end());
+    return ids.size();
+  } // fill_entities
+
+private:
+  //--------------------------------------------------------------------------//
+  //! Append the definitions of the entities in [\em begin, \em end) to
+  //! \em crs, which must be empty.
+  //--------------------------------------------------------------------------//
+
+  void assemble_crs_(
+      size_t from_dimension,
+      size_t to_dimension,
+      size_t begin,
+      size_t end,
+      crs_storage_t & crs) const {
+    crs.offsets.reserve(end - begin + 1);
+    crs.offsets.push_back(0);
+
+    for (size_t e(begin); e < end; ++e) {
+      auto ids = entities(from_dimension, to_dimension, e);
+      crs.indices.insert(crs.indices.end(), ids.begin(), ids.end());
+      crs.offsets.push_back(crs.indices.size());
+    } // for
+  } // assemble_crs_
+
+  // The connectivity assembled by the default entities_crs() for one pair
+  // of dimensions. No block is added once the full connectivity has been
+  // assembled, so the cache never holds more than twice the mesh.
+  struct crs_cache_t {
+    crs_storage_t full;
+    std::map<std::pair<size_t, size_t>, crs_storage_t> blocks;
+    size_t block_rows = 0;
+  }; // struct crs_cache_t
+
+  mutable std::mutex crs_mutex_;
+  mutable std::map<std::pair<size_t, size_t>, crs_cache_t> crs_cache_;
+
 }; // class mesh_definition__
 
 } // namespace topology
@@ -183,6 +183,34 @@ TEST(closure, vertex_closure) {
 
 } // TEST
 
+// This test checks the compressed-row connectivity view and its
+// transpose against the per-entity interface.
+TEST(closure, crs) {
+
+  flecsi::topology::test_definition_t td;
+
+  auto c2v = td.entities_crs(2, 0);
+  CINCH_ASSERT(EQ, c2v.size(), 16);
+
+  std::vector<size_t> ids;
+  for(size_t c(0); c<c2v.size(); ++c) {
+    td.fill_entities(2, 0, c, ids);
+    CINCH_ASSERT(EQ, ids, td.entities(2, 0, c));
+    CINCH_ASSERT(EQ, ids,
+      std::vector<size_t>(c2v[c].begin(), c2v[c].end()));
+  } // for
+
+  auto v2c = flecsi::topology::transpose(c2v, td.num_entities(0));
+  CINCH_ASSERT(EQ, v2c.view().size(), 25);
+
+  for(size_t v(0); v<25; ++v) {
+    auto referencers = flecsi::topology::entity_referencers<2, 0>(td, v);
+    CINCH_ASSERT(EQ, referencers,
+      std::set<size_t>(v2c.view()[v].begin(), v2c.view()[v].end()));
+  } // for
+
+} // TEST
+
 /*----------------------------------------------------------------------------*
  * Cinch test Macros
  *
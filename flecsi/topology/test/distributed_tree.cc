@@ -0,0 +1,186 @@
+#include <cinchtest.h>
+#include <mpi.h>
+
+#include <flecsi/topology/distributed_tree_topology.h>
+#include "gravity_policy.h"
+#include "pseudo_random.h"
+
+using namespace std;
+using namespace flecsi;
+
+using namespace gravity;
+
+using tree_topology__ = topology::distributed_tree_topology<tree_policy>;
+using body = tree_topology__::entity_t;
+using point_t = tree_topology__::point_t;
+
+static const size_t N = 20000;
+static const double R = 0.02;
+
+struct Moments {
+  double mass;
+  double center[2];
+};
+
+// The positions of all bodies, which every rank can generate.
+static vector<point_t> positions() {
+  pseudo_random rng;
+
+  vector<point_t> ps;
+  for (size_t i = 0; i < N; ++i) {
+    if (i % 4 == 0) {
+      // a cluster, so that a uniform split of the keys is unbalanced
+      ps.push_back({rng.uniform(0.7, 0.72), rng.uniform(0.2, 0.22)});
+    } else {
+      ps.push_back({rng.uniform(0.0, 0.999), rng.uniform(0.0, 0.999)});
+    }
+  }
+
+  return ps;
+}
+
+static size_t sum(size_t n) {
+  size_t total;
+  MPI_Allreduce(&n, &total, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+  return total;
+}
+
+TEST(distributed_tree, partition) {
+  tree_topology__ t;
+
+  const size_t rank = t.rank();
+  const size_t size = t.num_ranks();
+
+  auto ps = positions();
+
+  for (size_t i = rank; i < N; i += size) {
+    point_t v = {0.0, 0.0};
+    t.make_entity(1.0 + i % 3, ps[i], v);
+  }
+
+  t.partition();
+
+  // Every body is owned by exactly one rank, and the ranks own the same
+  // number of bodies.
+  ASSERT_EQ(sum(t.num_owned()), N);
+  ASSERT_LE(t.num_owned(), N / size + 1);
+  ASSERT_GE(t.num_owned(), N / size - 1);
+
+  for (auto ent : t.owned_entities()) {
+    ASSERT_EQ(t.owner(ent->coordinates()), rank);
+    ASSERT_TRUE(ent->is_valid());
+  }
+
+  // The top-level branches of all ranks cover the domain once.
+  double volume = 0.0;
+  for (size_t r = 0; r < size; ++r) {
+    for (auto id : t.top_level_branches(r)) {
+      auto box = t.branch_box(id);
+      volume += (box[1][0] - box[0][0]) * (box[1][1] - box[0][1]);
+    }
+  }
+  ASSERT_NEAR(volume, 1.0, 1e-12);
+
+  // Queries see remote bodies within the ghost radius.
+  t.exchange_ghosts(R);
+  ASSERT_EQ(sum(t.num_owned()), N);
+
+  size_t checked = 0;
+  for (auto ent : t.owned_entities()) {
+    if (checked++ % 10 != 0) {
+      continue;
+    }
+
+    size_t expected = 0;
+    for (auto & p : ps) {
+      if (distance(p, ent->coordinates()) <= R) {
+        ++expected;
+      }
+    }
+
+    ASSERT_EQ(t.find_in_radius(ent->coordinates(), R).size(), expected);
+
+    size_t applied = 0;
+    t.apply_in_radius(ent->coordinates(), R, [&](body *) { ++applied; });
+    ASSERT_EQ(applied, expected);
+  }
+
+  // The aggregates of the top-level branches of all ranks sum up to the
+  // totals.
+  auto aggs = t.exchange_aggregates<Moments>([](Moments & m, body * b) {
+    m.mass += b->mass();
+    m.center[0] += b->mass() * b->coordinates()[0];
+  });
+
+  size_t count = 0;
+  double mass = 0.0;
+  double center = 0.0;
+  for (auto & a : aggs) {
+    count += a.count;
+    mass += a.value.mass;
+    center += a.value.center[0];
+  }
+
+  double expected_mass = 0.0;
+  double expected_center = 0.0;
+  for (size_t i = 0; i < N; ++i) {
+    expected_mass += 1.0 + i % 3;
+    expected_center += (1.0 + i % 3) * ps[i][0];
+  }
+
+  ASSERT_EQ(count, N);
+  ASSERT_NEAR(mass, expected_mass, 1e-9 * expected_mass);
+  ASSERT_NEAR(center, expected_center, 1e-9 * expected_center);
+}
+
+TEST(distributed_tree, rebalance) {
+  tree_topology__ t;
+
+  const size_t rank = t.rank();
+  const size_t size = t.num_ranks();
+
+  auto ps = positions();
+
+  for (size_t i = rank; i < N; i += size) {
+    point_t v = {0.0, 0.0};
+    t.make_entity(1.0, ps[i], v);
+  }
+
+  t.partition();
+  t.exchange_ghosts(R);
+
+  // Balanced: nothing to do.
+  ASSERT_FALSE(t.rebalance(0.1));
+
+  // Squeeze all bodies into the lower left corner, and send them to the
+  // owners of their new positions.
+  for (auto ent : t.owned_entities()) {
+    point_t p = ent->coordinates();
+    ent->set_coordinates({0.25 * p[0], 0.25 * p[1]});
+  }
+
+  t.migrate();
+  ASSERT_EQ(t.num_ghosts(), 0);
+  ASSERT_EQ(sum(t.num_owned()), N);
+
+  for (auto ent : t.owned_entities()) {
+    ASSERT_EQ(t.owner(ent->coordinates()), rank);
+  }
+
+  if (size > 1) {
+    ASSERT_TRUE(t.rebalance(0.1));
+  }
+
+  ASSERT_EQ(sum(t.num_owned()), N);
+  ASSERT_LE(t.num_owned(), N / size + 1);
+  ASSERT_GE(t.num_owned(), N / size - 1);
+
+  for (auto ent : t.owned_entities()) {
+    ASSERT_EQ(t.owner(ent->coordinates()), rank);
+  }
+}
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
@@ -0,0 +1,335 @@
+/*~--------------------------------------------------------------------------~*
+ * Copyright (c) 2016 Los Alamos National Laboratory, LLC
+ * All rights reserved
+ *~--------------------------------------------------------------------------~*/
+////////////////////////////////////////////////////////////////////////////////
+/// \file
+/// \brief A tree policy with monopole payloads and a first-order fast
+///        multipole gravity kernel, shared by the traversal and query tests
+///        and the benchmark.
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <flecsi/topology/tree_topology.h>
+#include "pseudo_random.h"
+
+namespace fmm {
+
+using namespace std;
+using namespace flecsi;
+
+// Plummer softening length
+const double epsilon = 1.0e-4;
+
+class tree_policy {
+public:
+  using tree_t = topology::tree_topology<tree_policy>;
+
+  using branch_int_t = uint64_t;
+
+  static const size_t dimension = 2;
+
+  using element_t = double;
+
+  using point_t = point__<element_t, dimension>;
+
+  class body : public topology::tree_entity<branch_int_t, dimension> {
+  public:
+    body(double mass, const point_t & position)
+        : mass_(mass), position_(position) {
+      acceleration_ = {0.0, 0.0};
+    }
+
+    const point_t & coordinates() const {
+      return position_;
+    }
+
+    double mass() const {
+      return mass_;
+    }
+
+    const point_t & acceleration() const {
+      return acceleration_;
+    }
+
+    void reset() {
+      acceleration_ = {0.0, 0.0};
+    }
+
+    void accelerate(double ax, double ay) {
+      acceleration_[0] += ax;
+      acceleration_[1] += ay;
+    }
+
+  private:
+    double mass_;
+    point_t position_;
+    point_t acceleration_;
+  };
+
+  using entity_t = body;
+
+  class branch : public topology::tree_branch__<branch_int_t, dimension> {
+  public:
+    branch() {}
+
+    void insert(body * ent) {
+      ents_.push_back(ent);
+
+      if (ents_.size() > 32) {
+        refine();
+      }
+    }
+
+    void remove(body * ent) {
+      auto itr = find(ents_.begin(), ents_.end(), ent);
+      assert(itr != ents_.end());
+      ents_.erase(itr);
+
+      if (ents_.empty()) {
+        coarsen();
+      }
+    }
+
+    auto begin() {
+      return ents_.begin();
+    }
+
+    auto end() {
+      return ents_.end();
+    }
+
+    void clear() {
+      ents_.clear();
+    }
+
+    size_t count() {
+      return ents_.size();
+    }
+
+    // Payload: the monopole moment, and the geometry of the branch.
+    double mass;
+    point_t center_of_mass;
+    point_t center;
+    double radius;
+
+    // Local expansion about center: g + J (x - center).
+    double g[2];
+    double J[2][2];
+
+  private:
+    vector<body *> ents_;
+  };
+
+  bool should_coarsen(branch * parent) {
+    return true;
+  }
+
+  using branch_t = branch;
+};
+
+using tree_t = tree_policy::tree_t;
+using body = tree_policy::body;
+using branch = tree_policy::branch;
+using point_t = tree_policy::point_t;
+
+//----------------------------------------------------------------------------//
+// The upward pass.
+//----------------------------------------------------------------------------//
+
+// Reset the payload of b, and set its geometry.
+inline void
+reset(tree_t & t, branch * b) {
+  auto box = t.branch_box(b->id());
+
+  b->mass = 0.0;
+  b->center_of_mass = {0.0, 0.0};
+  b->center = {0.5 * (box[0][0] + box[1][0]), 0.5 * (box[0][1] + box[1][1])};
+  b->radius = 0.5 * distance(box[0], box[1]);
+  b->g[0] = b->g[1] = 0.0;
+  b->J[0][0] = b->J[0][1] = b->J[1][0] = b->J[1][1] = 0.0;
+}
+
+inline void
+finish(branch * b) {
+  if (b->mass > 0.0) {
+    b->center_of_mass[0] /= b->mass;
+    b->center_of_mass[1] /= b->mass;
+  } else {
+    b->center_of_mass = b->center;
+  }
+}
+
+inline void
+p2m(tree_t & t, branch * b) {
+  reset(t, b);
+
+  for (auto ent : *b) {
+    b->mass += ent->mass();
+    b->center_of_mass[0] += ent->mass() * ent->coordinates()[0];
+    b->center_of_mass[1] += ent->mass() * ent->coordinates()[1];
+  }
+
+  finish(b);
+}
+
+inline void
+m2m(tree_t & t, branch * b) {
+  reset(t, b);
+
+  for (size_t i = 0; i < branch::num_children; ++i) {
+    branch * c = t.child(b, i);
+    b->mass += c->mass;
+    b->center_of_mass[0] += c->mass * c->center_of_mass[0];
+    b->center_of_mass[1] += c->mass * c->center_of_mass[1];
+  }
+
+  finish(b);
+}
+
+//----------------------------------------------------------------------------//
+// The interaction kernel, with an opening angle acceptance criterion.
+//----------------------------------------------------------------------------//
+
+class gravity_kernel {
+public:
+  gravity_kernel(double theta) : theta_(theta) {}
+
+  bool accept(branch * t, branch * s) const {
+    if (s->mass == 0.0) {
+      return true;
+    }
+
+    // The source extent is bounded by its box, seen from its center of
+    // mass.
+    const double rs = s->radius + distance(s->center, s->center_of_mass);
+    return t->radius + rs < theta_ * distance(t->center, s->center_of_mass);
+  }
+
+  void m2l(branch * t, branch * s) const {
+    if (s->mass == 0.0) {
+      return;
+    }
+
+    const double d[2] = {s->center_of_mass[0] - t->center[0],
+                         s->center_of_mass[1] - t->center[1]};
+    const double s2 = d[0] * d[0] + d[1] * d[1] + epsilon * epsilon;
+    const double inv3 = s->mass / (s2 * std::sqrt(s2));
+    const double inv5 = 3.0 * inv3 / s2;
+
+    for (size_t i = 0; i < 2; ++i) {
+      t->g[i] += d[i] * inv3;
+
+      for (size_t j = 0; j < 2; ++j) {
+        t->J[i][j] += d[i] * d[j] * inv5 - (i == j ? inv3 : 0.0);
+      }
+    }
+  }
+
+  void p2p(branch * t, branch * s) const {
+    for (auto e : *t) {
+      double a[2] = {0.0, 0.0};
+
+      for (auto o : *s) {
+        if (o == e) {
+          continue;
+        }
+
+        const double d[2] = {o->coordinates()[0] - e->coordinates()[0],
+                             o->coordinates()[1] - e->coordinates()[1]};
+        const double s2 = d[0] * d[0] + d[1] * d[1] + epsilon * epsilon;
+        const double inv3 = o->mass() / (s2 * std::sqrt(s2));
+
+        a[0] += d[0] * inv3;
+        a[1] += d[1] * inv3;
+      }
+
+      e->accelerate(a[0], a[1]);
+    }
+  }
+
+  void l2l(branch * p, branch * c) const {
+    const double d[2] = {c->center[0] - p->center[0],
+                         c->center[1] - p->center[1]};
+
+    for (size_t i = 0; i < 2; ++i) {
+      c->g[i] += p->g[i] + p->J[i][0] * d[0] + p->J[i][1] * d[1];
+
+      for (size_t j = 0; j < 2; ++j) {
+        c->J[i][j] += p->J[i][j];
+      }
+    }
+  }
+
+  void l2p(branch * b) const {
+    for (auto e : *b) {
+      const double d[2] = {e->coordinates()[0] - b->center[0],
+                           e->coordinates()[1] - b->center[1]};
+
+      e->accelerate(
+          b->g[0] + b->J[0][0] * d[0] + b->J[0][1] * d[1],
+          b->g[1] + b->J[1][0] * d[0] + b->J[1][1] * d[1]);
+    }
+  }
+
+private:
+  double theta_;
+};
+
+//----------------------------------------------------------------------------//
+// The direct sum, for reference.
+//----------------------------------------------------------------------------//
+
+inline point_t
+direct(const vector<body *> & bodies, const body * e) {
+  double a[2] = {0.0, 0.0};
+
+  for (auto o : bodies) {
+    if (o == e) {
+      continue;
+    }
+
+    const double d[2] = {o->coordinates()[0] - e->coordinates()[0],
+                         o->coordinates()[1] - e->coordinates()[1]};
+    const double s2 = d[0] * d[0] + d[1] * d[1] + epsilon * epsilon;
+    const double inv3 = o->mass() / (s2 * std::sqrt(s2));
+
+    a[0] += d[0] * inv3;
+    a[1] += d[1] * inv3;
+  }
+
+  return {a[0], a[1]};
+}
+
+//----------------------------------------------------------------------------//
+// Test bodies.
+//----------------------------------------------------------------------------//
+
+// Make n bodies and build the tree. Half of the bodies are in a cluster, so
+// that the tree is refined unevenly.
+inline vector<body *>
+make_bodies(tree_t & t, size_t n) {
+  pseudo_random rng;
+
+  vector<body *> bodies;
+  for (size_t i = 0; i < n; ++i) {
+    point_t p = {rng.uniform(0.0, 1.0), rng.uniform(0.0, 1.0)};
+
+    if (i % 2 == 0) {
+      p = {0.3 + 0.05 * p[0], 0.6 + 0.05 * p[1]};
+    }
+
+    bodies.push_back(t.make_entity(rng.uniform(0.1, 0.5), p));
+  }
+
+  t.build();
+
+  return bodies;
+}
+
+} // namespace fmm
@@ -2,137 +2,13 @@
 #include <iostream>
 
 #include <flecsi/concurrency/thread_pool.h>
-#include <flecsi/topology/tree_topology.h>
+#include "gravity_policy.h"
 #include "pseudo_random.h"
 
 using namespace std;
 using namespace flecsi;
 
-struct Aggregate {
-  Aggregate() {
-    center = {0, 0};
-    mass = 0;
-  }
-
-  double mass;
-  point<double, 2> center;
-};
-
-class tree_policy {
-public:
-  using tree_t = topology::tree_topology<tree_policy>;
-
-  using branch_int_t = uint64_t;
-
-  static const size_t dimension = 2;
-
-  using element_t = double;
-
-  using point_t = point<element_t, dimension>;
-
-  class body : public topology::tree_entity<branch_int_t, dimension> {
-  public:
-    body(double mass, const point_t & position, const point_t & velocity)
-        : mass_(mass), position_(position), velocity_(velocity) {}
-
-    const point_t & coordinates() const {
-      return position_;
-    }
-
-    double mass() const {
-      return mass_;
-    }
-
-    void interact(const body * b) {
-      double d = distance(position_, b->position_);
-      velocity_ += 1e-9 * b->mass_ * (b->position_ - position_) / (d * d);
-    }
-
-    void interact(Aggregate & a) {
-      double d = distance(position_, a.center);
-      velocity_ += 1e-9 * a.mass * (a.center - position_) / (d * d);
-    }
-
-    void update() {
-      position_ += velocity_;
-
-      if (position_[0] > 1.0) {
-        position_[0] = 0;
-      } else if (position_[0] < 0.0) {
-        position_[0] = 1.0;
-      }
-
-      if (position_[1] > 1.0) {
-        position_[1] = 0;
-      } else if (position_[1] < 0.0) {
-        position_[1] = 1.0;
-      }
-    }
-
-  private:
-    double mass_;
-    point_t position_;
-    point_t velocity_;
-  };
-
-  using entity_t = body;
-
-  class branch : public topology::tree_branch__<branch_int_t, dimension> {
-  public:
-    branch() {}
-
-    void insert(body * ent) {
-      ents_.push_back(ent);
-
-      if (ents_.size() > 100) {
-        refine();
-      }
-    }
-
-    void remove(body * ent) {
-      auto itr = find(ents_.begin(), ents_.end(), ent);
-      assert(itr != ents_.end());
-      ents_.erase(itr);
-
-      if (ents_.empty()) {
-        coarsen();
-      }
-    }
-
-    auto begin() {
-      return ents_.begin();
-    }
-
-    auto end() {
-      return ents_.end();
-    }
-
-    void clear() {
-      ents_.clear();
-    }
-
-    size_t count() {
-      return ents_.size();
-    }
-
-    point_t coordinates(
-        const std::array<point<element_t, dimension>, 2> & range) const {
-      point_t p;
-      branch_id_t bid = id();
-      bid.coordinates(range, p);
-      return p;
-    }
-
-  private:
-    vector<body *> ents_;
-  };
-
-  bool should_coarsen(branch * parent) {
-    return true;
-  }
-
-  using branch_t = branch;
-};
+using namespace gravity;
 
 using tree_topology__ = topology::tree_topology<tree_policy>;
 using body = tree_topology__::body;
@@ -224,3 +100,61 @@ TEST(tree_topology, gravity) {
     }
   }
 }
+
+TEST(tree_topology, bulk_build) {
+  tree_topology__ t1;
+  tree_topology__ t2;
+
+  thread_pool pool;
+  pool.start(4);
+
+  pseudo_random rng;
+
+  vector<body *> bodies1;
+  vector<body *> bodies2;
+  for (size_t i = 0; i < N; ++i) {
+    double m = rng.uniform(0.1, 0.5);
+    point_t p = {rng.uniform(0.0, 1.0), rng.uniform(0.0, 1.0)};
+    point_t v = {0.0, 0.0};
+
+    auto b1 = t1.make_entity(m, p, v);
+    t1.insert(b1);
+    bodies1.push_back(b1);
+
+    bodies2.push_back(t2.make_entity(m, p, v));
+  }
+
+  // The bulk build creates the same branches as incremental insertion.
+  t2.build();
+
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(bodies1[i]->get_branch_id(), bodies2[i]->get_branch_id());
+  }
+
+  // The concurrent build and a rebuild of an existing tree give the same
+  // result.
+  t2.build(pool);
+
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(bodies1[i]->get_branch_id(), bodies2[i]->get_branch_id());
+  }
+
+  // Entities can be removed and inserted after a bulk build.
+  for (size_t i = 0; i < N; i += 2) {
+    t1.remove(bodies1[i]);
+    t2.remove(bodies2[i]);
+  }
+
+  for (size_t i = 0; i < N; i += 2) {
+    t1.insert(bodies1[i]);
+    t2.insert(bodies2[i]);
+  }
+
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(bodies1[i]->get_branch_id(), bodies2[i]->get_branch_id());
+  }
+
+  auto ents1 = t1.find_in_radius({0.5, 0.5}, 0.1);
+  auto ents2 = t2.find_in_radius({0.5, 0.5}, 0.1);
+  ASSERT_EQ(ents1.size(), ents2.size());
+}
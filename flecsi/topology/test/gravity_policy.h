@@ -0,0 +1,153 @@
+/*~--------------------------------------------------------------------------~*
+ * Copyright (c) 2016 Los Alamos National Laboratory, LLC
+ * All rights reserved
+ *~--------------------------------------------------------------------------~*/
+////////////////////////////////////////////////////////////////////////////////
+/// \file
+/// \brief The tree policy of the gravity test, shared with the tree
+///        benchmark.
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <flecsi/topology/tree_topology.h>
+
+namespace gravity {
+
+using namespace std;
+using namespace flecsi;
+
+struct Aggregate {
+  Aggregate() {
+    center = {0, 0};
+    mass = 0;
+  }
+
+  double mass;
+  point__<double, 2> center;
+};
+
+class tree_policy {
+public:
+  using tree_t = topology::tree_topology<tree_policy>;
+
+  using branch_int_t = uint64_t;
+
+  static const size_t dimension = 2;
+
+  using element_t = double;
+
+  using point_t = point__<element_t, dimension>;
+
+  class body : public topology::tree_entity<branch_int_t, dimension> {
+  public:
+    body(double mass, const point_t & position, const point_t & velocity)
+        : mass_(mass), position_(position), velocity_(velocity) {}
+
+    const point_t & coordinates() const {
+      return position_;
+    }
+
+    void set_coordinates(const point_t & position) {
+      position_ = position;
+    }
+
+    double mass() const {
+      return mass_;
+    }
+
+    void interact(const body * b) {
+      double d = distance(position_, b->position_);
+      velocity_ += 1e-9 * b->mass_ * (b->position_ - position_) / (d * d);
+    }
+
+    void interact(Aggregate & a) {
+      double d = distance(position_, a.center);
+      velocity_ += 1e-9 * a.mass * (a.center - position_) / (d * d);
+    }
+
+    void update() {
+      position_ += velocity_;
+
+      if (position_[0] > 1.0) {
+        position_[0] = 0;
+      } else if (position_[0] < 0.0) {
+        position_[0] = 1.0;
+      }
+
+      if (position_[1] > 1.0) {
+        position_[1] = 0;
+      } else if (position_[1] < 0.0) {
+        position_[1] = 1.0;
+      }
+    }
+
+  private:
+    double mass_;
+    point_t position_;
+    point_t velocity_;
+  };
+
+  using entity_t = body;
+
+  class branch : public topology::tree_branch__<branch_int_t, dimension> {
+  public:
+    branch() {}
+
+    void insert(body * ent) {
+      ents_.push_back(ent);
+
+      if (ents_.size() > 100) {
+        refine();
+      }
+    }
+
+    void remove(body * ent) {
+      auto itr = find(ents_.begin(), ents_.end(), ent);
+      assert(itr != ents_.end());
+      ents_.erase(itr);
+
+      if (ents_.empty()) {
+        coarsen();
+      }
+    }
+
+    auto begin() {
+      return ents_.begin();
+    }
+
+    auto end() {
+      return ents_.end();
+    }
+
+    void clear() {
+      ents_.clear();
+    }
+
+    size_t count() {
+      return ents_.size();
+    }
+
+    point_t coordinates(
+        const std::array<point__<element_t, dimension>, 2> & range) const {
+      point_t p;
+      branch_id_t bid = id();
+      bid.coordinates(range, p);
+      return p;
+    }
+
+  private:
+    vector<body *> ents_;
+  };
+
+  bool should_coarsen(branch * parent) {
+    return true;
+  }
+
+  using branch_t = branch;
+};
+
+} // namespace gravity
@@ -0,0 +1,194 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+///
+/// \file
+/// \date Initial file creation: Oct 18, 2026
+///
+/// Throughput of the tree topology for the gravity test policy: entity
+/// insertion (with refinement), bulk construction, branch lookups,
+/// single and batched radius and nearest neighbor queries, and the
+/// refinement/coarsening churn of moving and reinserting bodies.
+///
+
+#include <cinchdevel.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "gravity_policy.h"
+#include "pseudo_random.h"
+
+using namespace gravity;
+
+using tree_topology__ = topology::tree_topology<tree_policy>;
+using body = tree_topology__::body;
+using point_t = tree_topology__::point_t;
+
+namespace {
+
+const size_t N = 1000000;
+const size_t queries = 10000;
+const size_t steps = 5;
+
+class stopwatch_t
+{
+public:
+
+  stopwatch_t() : start_(std::chrono::steady_clock::now()) {}
+
+  // Print the throughput of count operations since construction.
+  void report(const char * name, size_t count) const {
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start_;
+
+    std::cout << name << ": " << count / elapsed.count() / 1.0e6
+              << " M/s (" << elapsed.count() << " s)" << std::endl;
+  } // report
+
+private:
+
+  std::chrono::steady_clock::time_point start_;
+
+}; // class stopwatch_t
+
+// Half of the bodies are uniformly distributed, and half are clustered,
+// so that the tree is refined unevenly.
+point_t
+position(pseudo_random & rng) {
+  if(rng.uniform() < 0.5) {
+    return {rng.uniform(0.0, 1.0), rng.uniform(0.0, 1.0)};
+  } // if
+
+  const double cx = 0.25 + 0.5 * (rng.uniform() < 0.5);
+  return {cx + rng.uniform(-0.01, 0.01), 0.5 + rng.uniform(-0.01, 0.01)};
+} // position
+
+} // namespace
+
+DEVEL(tree_benchmark) {
+  tree_topology__ t;
+  pseudo_random rng;
+
+  std::vector<body *> bodies;
+  bodies.reserve(N);
+
+  {
+    stopwatch_t stopwatch;
+
+    for(size_t i = 0; i < N; ++i) {
+      point_t v = {0.0, 0.0};
+      auto bi = t.make_entity(rng.uniform(0.1, 0.5), position(rng), v);
+      bodies.push_back(bi);
+      t.insert(bi);
+    } // for
+
+    stopwatch.report("insert", N);
+  } // scope
+
+  std::cout << "max depth: " << t.max_depth() << std::endl;
+
+  // Rebuild the same tree from the Morton-sorted bodies.
+  {
+    stopwatch_t stopwatch;
+    t.build();
+    stopwatch.report("bulk build", N);
+  } // scope
+
+  {
+    thread_pool pool;
+    pool.start(std::thread::hardware_concurrency());
+
+    stopwatch_t stopwatch;
+    t.build(pool);
+    stopwatch.report("bulk build (threads)", N);
+  } // scope
+
+  std::cout << "max depth: " << t.max_depth() << std::endl;
+
+  {
+    stopwatch_t stopwatch;
+    size_t found = 0;
+
+    for(auto bi : bodies) {
+      found += t.get(bi->get_branch_id())->count();
+    } // for
+
+    stopwatch.report("branch lookup", N);
+    clog_assert(found >= N, "invalid branch lookup");
+  } // scope
+
+  {
+    stopwatch_t stopwatch;
+    size_t found = 0;
+
+    for(size_t i = 0; i < queries; ++i) {
+      found += t.find_in_radius(bodies[i]->coordinates(), 0.0001).size();
+    } // for
+
+    stopwatch.report("radius query", queries);
+    clog_assert(found >= queries, "invalid radius query");
+  } // scope
+
+  // The same queries, batched, and k nearest neighbors.
+  {
+    std::vector<point_t> centers(queries);
+
+    for(size_t i = 0; i < queries; ++i) {
+      centers[i] = bodies[i]->coordinates();
+    } // for
+
+    {
+      stopwatch_t stopwatch;
+      auto nl = t.find_in_radius_batch(centers, 0.0001);
+      stopwatch.report("batched radius query", queries);
+      clog_assert(nl.entities.size() >= queries, "invalid radius query");
+    } // scope
+
+    {
+      stopwatch_t stopwatch;
+      auto nl = t.find_nearest_batch(centers, 16);
+      stopwatch.report("batched 16-nearest query", queries);
+      clog_assert(nl.entities.size() == 16 * queries, "invalid knn query");
+    } // scope
+
+    thread_pool pool;
+    pool.start(std::thread::hardware_concurrency());
+
+    {
+      stopwatch_t stopwatch;
+      auto nl = t.find_nearest_batch(pool, centers, 16);
+      stopwatch.report("batched 16-nearest query (threads)", queries);
+      clog_assert(nl.entities.size() == 16 * queries, "invalid knn query");
+    } // scope
+  } // scope
+
+  // Remove and reinsert half of the bodies at new positions, which
+  // coarsens and refines branches.
+  {
+    stopwatch_t stopwatch;
+
+    for(size_t s = 0; s < steps; ++s) {
+      for(size_t i = s % 2; i < N; i += 2) {
+        t.remove(bodies[i]);
+      } // for
+
+      for(size_t i = s % 2; i < N; i += 2) {
+        bodies[i]->set_coordinates(position(rng));
+        t.insert(bodies[i]);
+      } // for
+    } // for
+
+    stopwatch.report("remove/reinsert", steps * N);
+  } // scope
+
+  std::cout << "max depth: " << t.max_depth() << std::endl;
+} // DEVEL
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
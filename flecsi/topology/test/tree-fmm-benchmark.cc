@@ -0,0 +1,114 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+///
+/// \file
+/// \date Initial file creation: Oct 18, 2026
+///
+/// Accuracy against speed of the tree traversal engine for the first-order
+/// fast multipole gravity kernel of the traversal test: for a range of
+/// opening angles, the time of the upward pass and the dual-tree
+/// traversal, and the RMS error of the accelerations of a sample of the
+/// bodies relative to the direct sum.
+///
+
+#include <cinchdevel.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#include "fmm_policy.h"
+#include "pseudo_random.h"
+
+using namespace fmm;
+
+namespace {
+
+const size_t N = 200000;
+const size_t samples = 1000;
+
+double
+seconds_since(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+} // seconds_since
+
+} // namespace
+
+DEVEL(tree_fmm_benchmark) {
+  tree_t t;
+  pseudo_random rng;
+
+  std::vector<body *> bodies;
+  bodies.reserve(N);
+
+  // Half of the bodies are uniformly distributed, and half are in a
+  // Plummer-like cluster.
+  for(size_t i = 0; i < N; ++i) {
+    point_t p = {rng.uniform(0.0, 1.0), rng.uniform(0.0, 1.0)};
+
+    if(i % 2 == 0) {
+      const double r = 0.1 / std::sqrt(std::pow(rng.uniform(0.01, 1.0),
+        -2.0 / 3.0) - 1.0 + 1.0e-3);
+      const double phi = rng.uniform(0.0, 2.0 * M_PI);
+      p = {std::min(0.999, std::max(0.0, 0.5 + r * std::cos(phi))),
+        std::min(0.999, std::max(0.0, 0.5 + r * std::sin(phi)))};
+    } // if
+
+    bodies.push_back(t.make_entity(rng.uniform(0.1, 0.5), p));
+  } // for
+
+  t.build();
+
+  std::vector<point_t> reference(samples);
+  for(size_t i = 0; i < samples; ++i) {
+    reference[i] = direct(bodies, bodies[i * (N / samples)]);
+  } // for
+
+  thread_pool pool;
+  pool.start(std::thread::hardware_concurrency());
+
+  std::cout << "N = " << N << ", threads = " << pool.num_threads()
+            << std::endl;
+
+  for(double theta : {1.0, 0.7, 0.5, 0.3, 0.2}) {
+    gravity_kernel kernel(theta);
+
+    for(auto b : bodies) {
+      b->reset();
+    } // for
+
+    auto start = std::chrono::steady_clock::now();
+
+    t.accumulate(pool, [&](branch * b) { p2m(t, b); },
+      [&](branch * b) { m2m(t, b); });
+    t.interact(pool, kernel);
+
+    const double elapsed = seconds_since(start);
+
+    double e2 = 0.0;
+    double a2 = 0.0;
+
+    for(size_t i = 0; i < samples; ++i) {
+      const point_t & a = bodies[i * (N / samples)]->acceleration();
+
+      for(size_t d = 0; d < 2; ++d) {
+        e2 += (a[d] - reference[i][d]) * (a[d] - reference[i][d]);
+        a2 += reference[i][d] * reference[i][d];
+      } // for
+    } // for
+
+    std::cout << "theta " << theta << ": " << elapsed << " s, error "
+              << std::sqrt(e2 / a2) << std::endl;
+  } // for
+} // DEVEL
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
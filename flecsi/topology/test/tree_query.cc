@@ -0,0 +1,123 @@
+#include <cinchtest.h>
+#include <algorithm>
+#include <cmath>
+
+#include <flecsi/concurrency/thread_pool.h>
+#include "fmm_policy.h"
+#include "pseudo_random.h"
+
+using namespace std;
+using namespace flecsi;
+
+using namespace fmm;
+
+static const size_t N = 5000;
+static const size_t Q = 3000;
+static const size_t K = 12;
+static const double R = 0.03;
+
+static vector<point_t> make_queries() {
+  pseudo_random rng(7);
+
+  vector<point_t> qs;
+  for (size_t i = 0; i < Q; ++i) {
+    qs.push_back({rng.uniform(0.0, 0.999), rng.uniform(0.0, 0.999)});
+
+    if (i % 3 == 0) {
+      qs.back() = {0.3 + 0.05 * qs.back()[0], 0.6 + 0.05 * qs.back()[1]};
+    }
+  }
+
+  return qs;
+}
+
+// The k nearest bodies by brute force, ordered by distance and id.
+static vector<body *>
+nearest(const vector<body *> & bodies, const point_t & p, size_t k) {
+  vector<body *> v = bodies;
+
+  auto closer = [&](body * a, body * b) {
+    const double da = distance(a->coordinates(), p);
+    const double db = distance(b->coordinates(), p);
+    return da < db || (da == db && a->id() < b->id());
+  };
+
+  partial_sort(v.begin(), v.begin() + k, v.end(), closer);
+  v.resize(k);
+
+  return v;
+}
+
+TEST(tree_query, find_nearest) {
+  tree_t t;
+  auto bodies = make_bodies(t, N);
+  auto qs = make_queries();
+
+  for (size_t i = 0; i < Q; i += 10) {
+    auto expected = nearest(bodies, qs[i], K);
+    auto ents = t.find_nearest(qs[i], K);
+
+    ASSERT_EQ(ents.size(), K);
+
+    size_t j = 0;
+    for (auto ent : ents) {
+      ASSERT_EQ(ent, expected[j++]);
+    }
+  }
+
+  ASSERT_EQ(t.find_nearest(qs[0], 0).size(), 0);
+  ASSERT_EQ(t.find_nearest(qs[0], 2 * N).size(), N);
+}
+
+TEST(tree_query, batch) {
+  tree_t t;
+  auto bodies = make_bodies(t, N);
+  auto qs = make_queries();
+
+  thread_pool pool;
+  pool.start(4);
+
+  auto radius = t.find_in_radius_batch(qs, R);
+  auto knn = t.find_nearest_batch(qs, K);
+
+  ASSERT_EQ(radius.size(), Q);
+  ASSERT_EQ(knn.size(), Q);
+
+  for (size_t i = 0; i < Q; ++i) {
+    // The same entities as brute force, in any order.
+    vector<body *> expected;
+    for (auto b : bodies) {
+      if (distance(b->coordinates(), qs[i]) <= R) {
+        expected.push_back(b);
+      }
+    }
+
+    vector<body *> found(radius.begin(i), radius.end(i));
+
+    sort(expected.begin(), expected.end());
+    sort(found.begin(), found.end());
+    ASSERT_EQ(found, expected);
+
+    // The nearest entities, in order.
+    ASSERT_EQ(
+        vector<body *>(knn.begin(i), knn.end(i)), nearest(bodies, qs[i], K));
+  }
+
+  // The concurrent versions find the same entities in the same order.
+  auto pradius = t.find_in_radius_batch(pool, qs, R);
+  auto pknn = t.find_nearest_batch(pool, qs, K);
+
+  ASSERT_EQ(pradius.offsets, radius.offsets);
+  ASSERT_EQ(pradius.entities, radius.entities);
+  ASSERT_EQ(pknn.offsets, knn.offsets);
+  ASSERT_EQ(pknn.entities, knn.entities);
+
+  // No queries.
+  auto none = t.find_nearest_batch(vector<point_t>(), K);
+  ASSERT_EQ(none.size(), 0);
+}
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
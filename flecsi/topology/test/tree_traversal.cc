@@ -0,0 +1,116 @@
+#include <cinchtest.h>
+#include <cmath>
+
+#include <flecsi/concurrency/thread_pool.h>
+#include "fmm_policy.h"
+
+using namespace std;
+using namespace flecsi;
+
+using namespace fmm;
+
+static const size_t N = 4000;
+
+// The RMS error of the accelerations relative to the direct sum.
+static double error(const vector<body *> & bodies) {
+  double e2 = 0.0;
+  double a2 = 0.0;
+
+  for (auto b : bodies) {
+    point_t a = direct(bodies, b);
+
+    for (size_t d = 0; d < 2; ++d) {
+      e2 += (b->acceleration()[d] - a[d]) * (b->acceleration()[d] - a[d]);
+      a2 += a[d] * a[d];
+    }
+  }
+
+  return sqrt(e2 / a2);
+}
+
+TEST(tree_traversal, accumulate) {
+  tree_t t;
+  auto bodies = make_bodies(t, N);
+
+  thread_pool pool;
+  pool.start(4);
+
+  double mass = 0.0;
+  double x = 0.0;
+  for (auto b : bodies) {
+    mass += b->mass();
+    x += b->mass() * b->coordinates()[0];
+  }
+
+  t.accumulate([&](branch * b) { p2m(t, b); }, [&](branch * b) { m2m(t, b); });
+
+  ASSERT_NEAR(t.root()->mass, mass, 1e-12 * mass);
+  ASSERT_NEAR(t.root()->center_of_mass[0], x / mass, 1e-12);
+
+  const double serial = t.root()->center_of_mass[1];
+
+  t.accumulate(
+      pool, [&](branch * b) { p2m(t, b); }, [&](branch * b) { m2m(t, b); });
+
+  ASSERT_NEAR(t.root()->mass, mass, 1e-12 * mass);
+  ASSERT_NEAR(t.root()->center_of_mass[1], serial, 1e-12);
+}
+
+TEST(tree_traversal, direct) {
+  tree_t t;
+  auto bodies = make_bodies(t, N);
+
+  // Nothing is accepted: all interactions are direct.
+  gravity_kernel kernel(0.0);
+
+  t.accumulate([&](branch * b) { p2m(t, b); }, [&](branch * b) { m2m(t, b); });
+  t.interact(kernel);
+
+  ASSERT_LT(error(bodies), 1e-12);
+}
+
+TEST(tree_traversal, fmm) {
+  tree_t t;
+  auto bodies = make_bodies(t, N);
+
+  thread_pool pool;
+  pool.start(4);
+
+  double last = 1.0;
+
+  for (double theta : {0.7, 0.5, 0.3}) {
+    gravity_kernel kernel(theta);
+
+    for (auto b : bodies) {
+      b->reset();
+    }
+
+    t.accumulate(
+        [&](branch * b) { p2m(t, b); }, [&](branch * b) { m2m(t, b); });
+    t.interact(kernel);
+
+    const double e = error(bodies);
+
+    // The error decreases with the opening angle.
+    ASSERT_LT(e, 0.02);
+    ASSERT_LT(e, last);
+    last = e;
+
+    // The concurrent traversal starts from the targets at the queue depth,
+    // which changes the interactions, but hardly the error.
+    for (auto b : bodies) {
+      b->reset();
+    }
+
+    t.accumulate(
+        pool, [&](branch * b) { p2m(t, b); }, [&](branch * b) { m2m(t, b); });
+    t.interact(pool, kernel);
+
+    ASSERT_LE(error(bodies), 1.01 * e);
+  }
+}
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
@@ -20,12 +20,13 @@
 #include <bitset>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iostream>
 #include <map>
 #include <mutex>
 #include <set>
-#include <unordered_map>
 #include <vector>
 
 #include <flecsi/concurrency/thread_pool.h>
@@ -33,6 +34,8 @@
 #include <flecsi/data/storage.h>
 #include <flecsi/geometry/point.h>
 #include <flecsi/topology/index_space.h>
+#include <flecsi/utils/object_pool.h>
+#include <flecsi/utils/radix_sort.h>
 
 /*
   Tree topology is a statically configured N-dimensional hashed tree for
@@ -66,15 +69,15 @@ struct tree_geometry__ {};
 //-----------------------------------------------------------------//
 template<typename T>
 struct tree_geometry__<T, 1> {
-  using point_t = point<T, 1>;
+  using point_t = point__<T, 1>;
   using element_t = T;
 
   //-----------------------------------------------------------------//
   //! Return true if point origin lies within the spheroid centered at center
-  with radius.
-      //-----------------------------------------------------------------//
-      static bool
-      within(const point_t & origin, const point_t & center, element_t radius) {
+  //! with radius.
+  //-----------------------------------------------------------------//
+  static bool
+  within(const point_t & origin, const point_t & center, element_t radius) {
     return distance(origin, center) <= radius;
   }
 
@@ -141,7 +144,7 @@ struct tree_geometry__<T, 1> {
 //-----------------------------------------------------------------//
 template<typename T>
 struct tree_geometry__<T, 2> {
-  using point_t = point<T, 2>;
+  using point_t = point__<T, 2>;
   using element_t = T;
 
   //-----------------------------------------------------------------//
@@ -229,7 +232,7 @@ struct tree_geometry__<T, 2> {
 //-----------------------------------------------------------------//
 template<typename T>
 struct tree_geometry__<T, 3> {
-  using point_t = point<T, 3>;
+  using point_t = point__<T, 3>;
   using element_t = T;
 
   //-----------------------------------------------------------------//
@@ -336,8 +339,8 @@ public:
   //-----------------------------------------------------------------//
   template<typename S>
   branch_id__(
-      const std::array<point<S, dimension>, 2> & range,
-      const point<S, dimension> & p,
+      const std::array<point__<S, dimension>, 2> & range,
+      const point__<S, dimension> & p,
       size_t depth)
       : id_(int_t(1) << depth * dimension + (bits - 1) % dimension) {
     std::array<int_t, dimension> coords;
@@ -497,8 +500,8 @@ public:
   //-----------------------------------------------------------------//
   template<typename S>
   void coordinates(
-      const std::array<point<S, dimension>, 2> & range,
-      point<S, dimension> & p) const {
+      const std::array<point__<S, dimension>, 2> & range,
+      point__<S, dimension> & p) const {
     std::array<int_t, dimension> coords;
     coords.fill(int_t(0));
 
@@ -533,9 +536,9 @@ private:
 
 //-----------------------------------------------------------------//
 //! All tree entities have an associated entity id of this type which is needed
-to interface with the index space.
-    //-----------------------------------------------------------------//
-    class entity_id_t {
+//! to interface with the index space.
+//-----------------------------------------------------------------//
+class entity_id_t {
 public:
   entity_id_t() {}
 
@@ -574,12 +577,164 @@ struct branch_id_hasher__ {
   }
 };
 
+//-----------------------------------------------------------------//
+//! Open-addressing hash map from branch ids to branches. Slots are
+//! stored contiguously and probed linearly. The null branch id marks an
+//! empty slot, and erase shifts the following entries back, so that no
+//! tombstones are needed.
+//-----------------------------------------------------------------//
+template<typename T, size_t DIM, typename B>
+class branch_map__ {
+public:
+  using branch_id_t = branch_id__<T, DIM>;
+
+  branch_map__() {
+    clear();
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the branch with id bid, or nullptr if there is none.
+  //-----------------------------------------------------------------//
+  B * find(const branch_id_t & bid) const {
+    for (size_t i = slot_(bid);; i = (i + 1) & mask_) {
+      const slot_t & s = slots_[i];
+
+      if (s.id == bid) {
+        return s.branch;
+      }
+
+      if (s.id.is_null()) {
+        return nullptr;
+      }
+    }
+  }
+
+  //-----------------------------------------------------------------//
+  //! Insert a branch. An existing entry for bid is replaced.
+  //-----------------------------------------------------------------//
+  void insert(const branch_id_t & bid, B * b) {
+    assert(!bid.is_null() && "null branch id");
+
+    if (2 * (size_ + 1) > slots_.size()) {
+      rehash_(2 * slots_.size());
+    }
+
+    size_t i = slot_(bid);
+
+    while (!slots_[i].id.is_null() && slots_[i].id != bid) {
+      i = (i + 1) & mask_;
+    }
+
+    if (slots_[i].id.is_null()) {
+      ++size_;
+    }
+
+    slots_[i] = {bid, b};
+  }
+
+  //-----------------------------------------------------------------//
+  //! Remove the entry for bid, if any.
+  //-----------------------------------------------------------------//
+  void erase(const branch_id_t & bid) {
+    size_t i = slot_(bid);
+
+    for (;; i = (i + 1) & mask_) {
+      if (slots_[i].id.is_null()) {
+        return;
+      }
+
+      if (slots_[i].id == bid) {
+        break;
+      }
+    }
+
+    // Backward-shift deletion: move back each following entry that
+    // would otherwise become unreachable from its home slot.
+    for (size_t j = (i + 1) & mask_; !slots_[j].id.is_null();
+         j = (j + 1) & mask_) {
+      const size_t home = slot_(slots_[j].id);
+
+      if (((j - home) & mask_) >= ((j - i) & mask_)) {
+        slots_[i] = slots_[j];
+        i = j;
+      }
+    }
+
+    slots_[i] = slot_t();
+    --size_;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Remove all entries. The table keeps its size, so that refilling it
+  //! with as many entries does not rehash.
+  //-----------------------------------------------------------------//
+  void clear() {
+    if (slots_.empty()) {
+      reset_(min_slots);
+    }
+    else {
+      std::fill(slots_.begin(), slots_.end(), slot_t());
+    }
+
+    size_ = 0;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+private:
+  static constexpr size_t min_slots = 64;
+
+  struct slot_t {
+    branch_id_t id;
+    B * branch = nullptr;
+  };
+
+  // Fibonacci hashing spreads the Morton-ordered ids of siblings, which
+  // differ only in their lowest bits, over the table.
+  size_t slot_(const branch_id_t & bid) const {
+    const uint64_t h = branch_id_hasher__<T, DIM>()(bid);
+    return size_t((h * 0x9e3779b97f4a7c15ull) >> shift_) & mask_;
+  }
+
+  // Replace the table with num_slots empty slots. The mask and the
+  // hash shift must always match the table size.
+  void reset_(size_t num_slots) {
+    slots_.assign(num_slots, slot_t());
+    mask_ = num_slots - 1;
+    shift_ = 64 - size_t(std::log2(double(num_slots)));
+  }
+
+  void rehash_(size_t num_slots) {
+    std::vector<slot_t> slots;
+    slots.swap(slots_);
+
+    reset_(num_slots);
+    size_ = 0;
+
+    for (auto & s : slots) {
+      if (!s.id.is_null()) {
+        insert(s.id, s.branch);
+      }
+    }
+  }
+
+  std::vector<slot_t> slots_;
+  size_t mask_ = 0;
+  size_t shift_ = 0;
+  size_t size_ = 0;
+};
+
 //-----------------------------------------------------------------//
 //! When an entity is added or removed from a branch, the user-level
 //! tree may trigger one of these actions.
 //-----------------------------------------------------------------//
 enum class action : uint8_t { none = 0b00, refine = 0b01, coarsen = 0b10 };
 
+template<class P>
+class distributed_tree_topology;
+
 //-----------------------------------------------------------------//
 //! The tree topology is parameterized on a policy P which defines its branch
 //! and entity types.
@@ -593,7 +748,7 @@ public:
 
   using element_t = typename Policy::element_t;
 
-  using point_t = point<element_t, dimension>;
+  using point_t = point__<element_t, dimension>;
 
   using range_t = std::pair<element_t, element_t>;
 
@@ -623,6 +778,39 @@ public:
 
   using subentity_space_t = index_space__<entity_t *, false, true, false>;
 
+  //! A box given by its min/max points.
+  using box_t = std::array<point_t, 2>;
+
+  //-----------------------------------------------------------------//
+  //! The results of a batch of queries in compressed row storage: the
+  //! entities found for query i are entities[offsets[i]] through
+  //! entities[offsets[i + 1] - 1].
+  //-----------------------------------------------------------------//
+  struct neighbor_list_t {
+    std::vector<size_t> offsets;
+    std::vector<entity_t *> entities;
+
+    //! Return the number of queries.
+    size_t size() const {
+      return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    //! Return the number of entities found for query i.
+    size_t count(size_t i) const {
+      return offsets[i + 1] - offsets[i];
+    }
+
+    //! Return the first entity found for query i.
+    entity_t * const * begin(size_t i) const {
+      return entities.data() + offsets[i];
+    }
+
+    //! Return the end of the entities found for query i.
+    entity_t * const * end(size_t i) const {
+      return entities.data() + offsets[i + 1];
+    }
+  };
+
   struct filter_valid {
     bool operator()(entity_t * ent) const {
       return ent->is_valid();
@@ -637,7 +825,7 @@ public:
     branch_id_t bid = branch_id_t::root();
     root_ = new branch_t;
     root_->set_id_(bid);
-    branch_map_.emplace(bid, root_);
+    branch_map_.insert(bid, root_);
 
     max_depth_ = 0;
     max_scale_ = element_t(1);
@@ -654,12 +842,12 @@ public:
   //! each dimension.
   //-----------------------------------------------------------------//
   tree_topology(
-      const point<element_t, dimension> & start,
-      const point<element_t, dimension> & end) {
+      const point__<element_t, dimension> & start,
+      const point__<element_t, dimension> & end) {
     branch_id_t bid = branch_id_t::root();
     root_ = new branch_t;
     root_->set_id_(bid);
-    branch_map_.emplace(bid, root_);
+    branch_map_.insert(bid, root_);
 
     max_depth_ = 0;
 
@@ -672,11 +860,12 @@ public:
   }
 
   ~tree_topology() {
+    // The storage is owned by the pools.
     for (auto ent : entities_) {
-      delete ent;
+      ent->~entity_t();
     }
 
-    root_->template dealloc_<branch_t>();
+    root_->template dealloc_<branch_t>(branch_pool_);
     delete root_;
   }
 
@@ -711,10 +900,9 @@ public:
 
   //-----------------------------------------------------------------//
   //! Update is called when an entity's coordinates have changed and may trigger
-  a reinsertion.
-      //-----------------------------------------------------------------//
-      void
-      update(entity_t * ent) {
+  //! a reinsertion.
+  //-----------------------------------------------------------------//
+  void update(entity_t * ent) {
     branch_id_t bid = ent->get_branch_id();
     branch_id_t nid = to_branch_id(ent->coordinates(), bid.depth());
 
@@ -726,20 +914,44 @@ public:
     insert(ent, max_depth_);
   }
 
+  //-----------------------------------------------------------------//
+  //! Build the tree from all entities at once. Rather than inserting the
+  //! entities one at a time, the entities are sorted by their branch ids
+  //! at the maximum depth, so that the entities of every branch form a
+  //! contiguous range. The leaves are found from these ranges, then their
+  //! parents are created, and finally the entities are inserted into the
+  //! leaves. Any existing branches are discarded.
+  //!
+  //! A branch is refined if the policy requests it while its range is
+  //! inserted, so the resulting branches are the same as with incremental
+  //! insertion, and the entities of each leaf are in Morton order.
+  //-----------------------------------------------------------------//
+  void build() {
+    build_(nullptr);
+  }
+
+  //-----------------------------------------------------------------//
+  //! Build the tree from all entities at once, computing the branch ids,
+  //! finding the leaves and inserting the entities concurrently.
+  //-----------------------------------------------------------------//
+  void build(thread_pool & pool) {
+    build_(&pool);
+  }
+
   //-----------------------------------------------------------------//
   //! Effectively re-insert all entities into the tree. Called when all entity
   //! coordinates are assumed to have changed.
   //-----------------------------------------------------------------//
   void update_all() {
-    root_->template dealloc_<branch_t>();
-    max_depth_ = 0;
-    branch_map_.clear();
-    branch_map_.emplace(root_->id(), root_);
+    build();
+  }
 
-    for (auto ent : entities_) {
-      ent->set_branch_id_(branch_id_t::null());
-      insert(ent);
-    }
+  //-----------------------------------------------------------------//
+  //! Effectively re-insert all entities into the tree. Called when all entity
+  //! coordinates are assumed to have changed. (Concurrent version.)
+  //-----------------------------------------------------------------//
+  void update_all(thread_pool & pool) {
+    build(pool);
   }
 
   //-----------------------------------------------------------------//
@@ -748,8 +960,8 @@ public:
   //! the coordinate ranges of each dimension to [start, end].
   //-----------------------------------------------------------------//
   void update_all(
-      const point<element_t, dimension> & start,
-      const point<element_t, dimension> & end) {
+      const point__<element_t, dimension> & start,
+      const point__<element_t, dimension> & end) {
 
     for (size_t d = 0; d < dimension; ++d) {
       scale_[d] = end[d] - start[d];
@@ -758,15 +970,7 @@ public:
       range_[1][d] = end[d];
     }
 
-    root_->template dealloc_<branch_t>();
-    max_depth_ = 0;
-    branch_map_.clear();
-    branch_map_.emplace(root_->id(), root_);
-
-    for (auto ent : entities_) {
-      ent->set_branch_id_(branch_id_t::null());
-      insert(ent);
-    }
+    build();
   }
 
   //-----------------------------------------------------------------//
@@ -777,9 +981,8 @@ public:
   void remove(entity_t * ent) {
     assert(!ent->get_branch_id().is_null());
 
-    auto itr = branch_map_.find(ent->get_branch_id());
-    assert(itr != branch_map_.end());
-    branch_t * b = itr->second;
+    branch_t * b = branch_map_.find(ent->get_branch_id());
+    assert(b);
 
     b->remove(ent);
     ent->set_branch_id_(branch_id_t::null());
@@ -817,10 +1020,9 @@ public:
 
   //-----------------------------------------------------------------//
   //! Return an index space containing all entities within the specified
-  spheroid.
-      //-----------------------------------------------------------------//
-      subentity_space_t
-      find_in_radius(const point_t & center, element_t radius) {
+  //! spheroid.
+  //-----------------------------------------------------------------//
+  subentity_space_t find_in_radius(const point_t & center, element_t radius) {
     subentity_space_t ents;
     ents.set_master(entities_);
 
@@ -846,14 +1048,13 @@ public:
   find_in_radius(thread_pool & pool, const point_t & center, element_t radius) {
 
     size_t queue_depth = get_queue_depth(pool);
-    size_t m = branch_int_t(1) << queue_depth * P::dimension;
 
     auto ef = [&](entity_t * ent, const point_t & center,
                   element_t radius) -> bool {
       return geometry_t::within(ent->coordinates(), center, radius);
     };
 
-    virtual_semaphore sem(1 - int(m));
+    wait_group wg;
     std::mutex mtx;
 
     subentity_space_t ents;
@@ -865,10 +1066,10 @@ public:
     queue_depth += depth;
 
     find_(
-        pool, sem, mtx, queue_depth, depth, b, size, ents, ef,
+        pool, wg, mtx, queue_depth, depth, b, size, ents, ef,
         geometry_t::intersects, center, radius);
 
-    sem.acquire();
+    pool.wait(wg);
 
     return ents;
   }
@@ -913,7 +1114,6 @@ public:
   subentity_space_t
   find_in_box(thread_pool & pool, const point_t & min, const point_t & max) {
     size_t queue_depth = get_queue_depth(pool);
-    size_t m = branch_int_t(1) << queue_depth * P::dimension;
 
     auto ef = [&](entity_t * ent, const point_t & min,
                   const point_t & max) -> bool {
@@ -940,18 +1140,97 @@ public:
 
     queue_depth += depth;
 
-    virtual_semaphore sem(1 - int(m));
+    wait_group wg;
     std::mutex mtx;
 
     find_(
-        pool, sem, mtx, queue_depth, depth, b, size, ents, ef,
+        pool, wg, mtx, queue_depth, depth, b, size, ents, ef,
         geometry_t::intersects_box, min, max);
 
-    sem.acquire();
+    pool.wait(wg);
+
+    return ents;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return an index space containing the k entities nearest to the
+  //! specified point, ordered by distance (ties by entity id).
+  //-----------------------------------------------------------------//
+  subentity_space_t find_nearest(const point_t & p, size_t k) {
+    subentity_space_t ents;
+    ents.set_master(entities_);
+
+    cursor_t c = {root_, branch_box(root_->id())};
+    std::vector<entity_t *> found;
+    find_nearest_(c, p, k, found);
+
+    for (auto ent : found) {
+      ents.push_back(ent);
+    }
 
     return ents;
   }
 
+  //-----------------------------------------------------------------//
+  //! Find the entities within radius of each of the specified centers.
+  //! The queries are processed in Morton order, and each query starts
+  //! from the leaf of the previous query rather than from the root, so
+  //! that neighboring queries share most of their traversal.
+  //!
+  //! This is the batched counterpart of find_in_radius. The batched
+  //! queries have their own names, so that a braced point still selects
+  //! the single query.
+  //-----------------------------------------------------------------//
+  neighbor_list_t find_in_radius_batch(
+      const std::vector<point_t> & centers,
+      element_t radius) {
+    return batch_(nullptr, centers, [&](cursor_t & c, const point_t & p,
+                                        std::vector<entity_t *> & found) {
+      find_in_radius_(c, p, radius, found);
+    });
+  }
+
+  /*!
+    Find the entities within radius of each of the specified centers.
+    (Concurrent version.)
+   */
+  neighbor_list_t find_in_radius_batch(
+      thread_pool & pool,
+      const std::vector<point_t> & centers,
+      element_t radius) {
+    return batch_(&pool, centers, [&](cursor_t & c, const point_t & p,
+                                      std::vector<entity_t *> & found) {
+      find_in_radius_(c, p, radius, found);
+    });
+  }
+
+  //-----------------------------------------------------------------//
+  //! Find the k nearest entities of each of the specified points,
+  //! ordered by distance. The queries are processed in Morton order,
+  //! starting from the leaf of the previous query.
+  //-----------------------------------------------------------------//
+  neighbor_list_t
+  find_nearest_batch(const std::vector<point_t> & points, size_t k) {
+    return batch_(nullptr, points, [&](cursor_t & c, const point_t & p,
+                                       std::vector<entity_t *> & found) {
+      find_nearest_(c, p, k, found);
+    });
+  }
+
+  /*!
+    Find the k nearest entities of each of the specified points.
+    (Concurrent version.)
+   */
+  neighbor_list_t find_nearest_batch(
+      thread_pool & pool,
+      const std::vector<point_t> & points,
+      size_t k) {
+    return batch_(&pool, points, [&](cursor_t & c, const point_t & p,
+                                     std::vector<entity_t *> & found) {
+      find_nearest_(c, p, k, found);
+    });
+  }
+
   //-----------------------------------------------------------------//
   //! For all entities within the specified spheroid, apply the given callable
   //! object ef with args.
@@ -989,7 +1268,6 @@ public:
       ARGS &&... args) {
 
     size_t queue_depth = get_queue_depth(pool);
-    size_t m = branch_int_t(1) << queue_depth * P::dimension;
 
     auto f = [&](entity_t * ent, const point_t & center, element_t radius) {
       if (geometry_t::within(ent->coordinates(), center, radius)) {
@@ -1002,13 +1280,13 @@ public:
     branch_t * b = find_start_(center, radius, depth, size);
     queue_depth += depth;
 
-    virtual_semaphore sem(1 - int(m));
+    wait_group wg;
 
     apply_(
-        pool, sem, queue_depth, depth, b, size, f, geometry_t::intersects,
+        pool, wg, queue_depth, depth, b, size, f, geometry_t::intersects,
         center, radius);
 
-    sem.acquire();
+    pool.wait(wg);
   }
 
   //-----------------------------------------------------------------//
@@ -1024,7 +1302,6 @@ public:
       ARGS &&... args) {
 
     size_t queue_depth = get_queue_depth(pool);
-    size_t m = branch_int_t(1) << queue_depth * P::dimension;
 
     auto f = [&](entity_t * ent, const point_t & min, const point_t & max) {
       if (geometry_t::within_box(ent->coordinates(), min, max)) {
@@ -1048,13 +1325,13 @@ public:
     branch_t * b = find_start_(center, radius, depth, size);
     queue_depth += depth;
 
-    virtual_semaphore sem(1 - int(m));
+    wait_group wg;
 
     apply_(
-        pool, sem, queue_depth, depth, b, size, f, geometry_t::intersects_box,
+        pool, wg, queue_depth, depth, b, size, f, geometry_t::intersects_box,
         min, max);
 
-    sem.acquire();
+    pool.wait(wg);
   }
 
   /*!
@@ -1093,17 +1370,52 @@ public:
 
   //-----------------------------------------------------------------//
   //! Construct a new entity. The entity's constructor should not be called
-  //! directly.
+  //! directly. Entities are allocated contiguously from a pool owned by
+  //! the tree, and are destroyed with it.
   //-----------------------------------------------------------------//
   template<class... Args>
   entity_t * make_entity(Args &&... args) {
-    auto ent = new entity_t(std::forward<Args>(args)...);
+    auto ent =
+        new (entity_pool_.allocate()) entity_t(std::forward<Args>(args)...);
     entity_id_t id = entities_.size();
     ent->set_id_(id);
     entities_.push_back(ent);
     return ent;
   }
 
+  //-----------------------------------------------------------------//
+  //! Remove and destroy the entities for which pred returns true. The
+  //! remaining entities keep their relative order but are renumbered, so
+  //! this invalidates entity ids, as well as pointers to the destroyed
+  //! entities.
+  //-----------------------------------------------------------------//
+  template<typename F>
+  void erase_entities(F && pred) {
+    std::vector<entity_t *> kept;
+    kept.reserve(entities_.size());
+
+    for (auto ent : entities_) {
+      if (!pred(ent)) {
+        kept.push_back(ent);
+        continue;
+      }
+
+      if (ent->is_valid()) {
+        remove(ent);
+      }
+
+      ent->~entity_t();
+      entity_pool_.deallocate(ent);
+    }
+
+    entities_.clear();
+
+    for (auto ent : kept) {
+      ent->set_id_(entities_.size());
+      entities_.push_back(ent);
+    }
+  }
+
   //-----------------------------------------------------------------//
   //! Return the tree's current max depth.
   //-----------------------------------------------------------------//
@@ -1120,9 +1432,9 @@ public:
   }
 
   branch_t * get(branch_id_t id) {
-    auto itr = branch_map_.find(id);
-    assert(itr != branch_map_.end());
-    return itr->second;
+    branch_t * b = branch_map_.find(id);
+    assert(b);
+    return b;
   }
 
   //-----------------------------------------------------------------//
@@ -1148,15 +1460,14 @@ public:
   template<typename F, typename... ARGS>
   void visit(thread_pool & pool, branch_t * b, F && f, ARGS &&... args) {
     size_t queue_depth = get_queue_depth(pool);
-    size_t m = branch_int_t(1) << queue_depth * P::dimension;
 
-    virtual_semaphore sem(1 - int(m));
+    wait_group wg;
 
     visit_(
-        pool, sem, b, 0, queue_depth, std::forward<F>(f),
+        pool, wg, b, 0, queue_depth, std::forward<F>(f),
         std::forward<ARGS>(args)...);
 
-    sem.acquire();
+    pool.wait(wg);
   }
 
   //-----------------------------------------------------------------//
@@ -1186,15 +1497,126 @@ public:
   void
   visit_children(thread_pool & pool, branch_t * b, F && f, ARGS &&... args) {
     size_t queue_depth = get_queue_depth(pool);
-    size_t m = branch_int_t(1) << queue_depth * P::dimension;
 
-    virtual_semaphore sem(1 - int(m));
+    wait_group wg;
 
     visit_children_(
-        pool, sem, 0, queue_depth, b, std::forward<F>(f),
+        pool, wg, 0, queue_depth, b, std::forward<F>(f),
         std::forward<ARGS>(args)...);
 
-    sem.acquire();
+    pool.wait(wg);
+  }
+
+  //-----------------------------------------------------------------//
+  //! Return the box of a branch.
+  //-----------------------------------------------------------------//
+  box_t branch_box(branch_id_t id) const {
+    std::array<branch_int_t, dimension> coords;
+    coords.fill(branch_int_t(0));
+
+    const size_t depth = id.depth();
+    branch_int_t bits = id.value_();
+
+    for (size_t d = 0; d < depth; ++d) {
+      for (size_t j = 0; j < dimension; ++j) {
+        coords[j] |= ((bits >> j) & branch_int_t(1)) << d;
+      }
+      bits >>= dimension;
+    }
+
+    const element_t size = std::ldexp(element_t(1), -int(depth));
+
+    box_t box;
+
+    for (size_t j = 0; j < dimension; ++j) {
+      box[0][j] = range_[0][j] + scale_[j] * size * element_t(coords[j]);
+      box[1][j] = box[0][j] + scale_[j] * size;
+    }
+
+    return box;
+  }
+
+  //-----------------------------------------------------------------//
+  //! Upward pass: compute the payload of every branch, from the leaves to
+  //! the root. The callable object p2m(branch_t *) is called on each leaf
+  //! to compute its payload from its entities, and m2m(branch_t *) is
+  //! called on every other branch, after all of its children, to combine
+  //! the payloads of its children.
+  //-----------------------------------------------------------------//
+  template<typename P2M, typename M2M>
+  void accumulate(P2M && p2m, M2M && m2m) {
+    accumulate_(root_, p2m, m2m);
+  }
+
+  /*!
+    Upward pass: compute the payload of every branch, from the leaves to
+    the root. (Concurrent version.)
+   */
+  template<typename P2M, typename M2M>
+  void accumulate(thread_pool & pool, P2M && p2m, M2M && m2m) {
+    size_t queue_depth = get_queue_depth(pool);
+
+    wait_group wg;
+
+    accumulate_(pool, wg, root_, 0, queue_depth, p2m, m2m);
+
+    pool.wait(wg);
+
+    combine_(root_, 0, queue_depth, m2m);
+  }
+
+  //-----------------------------------------------------------------//
+  //! Dual-tree traversal and downward pass of a fast multipole or
+  //! Barnes-Hut method. The kernel object provides:
+  //!
+  //!   bool accept(branch_t * t, branch_t * s): the multipole acceptance
+  //!     criterion, i.e., true if the payload of source branch s may be
+  //!     used for target branch t. It must reject overlapping branches.
+  //!   void m2l(branch_t * t, branch_t * s): add the contribution of the
+  //!     payload of s to the local expansion of t.
+  //!   void p2p(branch_t * t, branch_t * s): add the contributions of the
+  //!     entities of leaf s to the entities of leaf t, which may be s.
+  //!   void l2l(branch_t * p, branch_t * c): add the local expansion of p
+  //!     to its child c.
+  //!   void l2p(branch_t * b): apply the local expansion of leaf b to
+  //!     its entities.
+  //!
+  //! Every pair of entities is covered by exactly one m2l or p2p call.
+  //! The payloads must be up to date (see accumulate()), and the local
+  //! expansions must have been reset, e.g., in the upward pass.
+  //-----------------------------------------------------------------//
+  template<typename K>
+  void interact(K & kernel) {
+    interact_(root_, 0, root_, 0, kernel);
+    downward_(root_, kernel);
+  }
+
+  /*!
+    Dual-tree traversal and downward pass of a fast multipole or
+    Barnes-Hut method. (Concurrent version.)
+
+    The target branches at the queue depth are processed concurrently,
+    each against the whole source tree. The kernel calls only modify the
+    target branch t (or c, or b) and its entities, so they may run
+    concurrently for different targets.
+   */
+  template<typename K>
+  void interact(thread_pool & pool, K & kernel) {
+    size_t queue_depth = get_queue_depth(pool);
+
+    std::vector<std::pair<branch_t *, size_t>> targets;
+    targets_(root_, 0, queue_depth, targets);
+
+    wait_group wg;
+
+    for (auto & t : targets) {
+      pool.spawn(wg, [&kernel, t, this]() {
+        interact_(t.first, t.second, root_, 0, kernel);
+        downward_(t.first, kernel);
+      });
+    }
+
+    pool.wait(wg);
   }
 
   //-----------------------------------------------------------------//
@@ -1257,7 +1679,7 @@ public:
     pos += sizeof(num_entities);
 
     for (size_t entity_id = 0; entity_id < num_entities; ++entity_id) {
-      entity_t * ent = new entity_t;
+      entity_t * ent = new (entity_pool_.allocate()) entity_t;
       ent->set_id_(entity_id);
 
       entities_.push_back(ent);
@@ -1274,10 +1696,15 @@ public:
   }
 
 private:
-  using branch_map_t = std::unordered_map<
-      branch_id_t,
-      branch_t *,
-      branch_id_hasher__<branch_int_t, dimension>>;
+  template<class>
+  friend class distributed_tree_topology;
+
+  using branch_map_t = branch_map__<branch_int_t, dimension, branch_t>;
+
+  // Children are allocated together, one block per refined branch.
+  using branch_pool_t = utils::object_pool__<branch_t, branch_t::num_children>;
+
+  using entity_pool_t = utils::object_pool__<entity_t, 1, 4096>;
 
   branch_id_t to_branch_id(const point_t & p, size_t max_depth) {
     return branch_id_t(range_, p, max_depth);
@@ -1324,9 +1751,9 @@ private:
 
   branch_t * find_parent_(branch_id_t bid) {
     for (;;) {
-      auto itr = branch_map_.find(bid);
-      if (itr != branch_map_.end()) {
-        return itr->second;
+      branch_t * b = branch_map_.find(bid);
+      if (b) {
+        return b;
       }
       bid.pop();
     }
@@ -1351,13 +1778,13 @@ private:
     branch_id_t pid = b->id();
     size_t depth = pid.depth() + 1;
 
-    if (!b->template into_branch_<branch_t>()) {
+    if (!b->template into_branch_<branch_t>(branch_pool_)) {
       return;
     }
 
     for (size_t i = 0; i < branch_t::num_children; ++i) {
       branch_t * ci = b->template child_<branch_t>(i);
-      branch_map_.emplace(ci->id(), ci);
+      branch_map_.insert(ci->id(), ci);
     }
 
     max_depth_ = std::max(max_depth_, depth);
@@ -1393,56 +1820,295 @@ private:
 
   void coarsen_(branch_t * p) {
     coarsen_(p, p);
-    p->template into_leaf_<branch_t>();
+
+    // Return the whole subtree to the pool.
+    p->template dealloc_<branch_t>(branch_pool_);
     p->reset();
   }
 
-  size_t get_queue_depth(thread_pool & pool) {
-    size_t n = pool.num_threads();
-    constexpr size_t rb = branch_int_t(1) << P::dimension;
-    double bn = std::log2(double(rb));
-    return std::log2(double(n)) / bn + 1;
-  }
+  // An entity and its branch id at the maximum depth.
+  using keyed_entity_t = std::pair<branch_int_t, entity_t *>;
 
-  branch_t * find_start_(
-      const point_t & center,
-      element_t radius,
-      size_t & depth,
-      element_t & size) {
+  void build_(thread_pool * pool) {
+    root_->template dealloc_<branch_t>(branch_pool_);
+    root_->clear();
+    root_->reset();
+    max_depth_ = 0;
+    branch_map_.clear();
+    branch_map_.insert(root_->id(), root_);
 
-    element_t norm_radius = radius / max_scale_;
+    const size_t n = entities_.size();
+    std::vector<keyed_entity_t> keys(n);
 
-    branch_id_t bid = to_branch_id(center, max_depth_);
+    auto compute_keys = [&](size_t first, size_t last) {
+      for (size_t i = first; i < last; ++i) {
+        entity_t * ent = entities_[i];
+        keys[i] = {to_branch_id(ent->coordinates(), branch_id_t::max_depth)
+                       .value_(),
+            ent};
+      }
+    };
 
-    int d = -std::log2(norm_radius) - 1;
+    constexpr size_t grain = 4096;
 
-    while (d > 0) {
-      branch_t * b = find_parent(bid, d);
+    if (pool && pool->num_threads() > 0 && n > grain) {
+      wait_group wg;
 
-      point_t p2;
-      b->id().coordinates(range_, p2);
+      for (size_t first = 0; first < n; first += grain) {
+        const size_t last = std::min(n, first + grain);
+        pool->spawn(wg, [&compute_keys, first, last] {
+          compute_keys(first, last);
+        });
+      }
 
-      size = std::pow(element_t(2), -d);
+      pool->wait(wg);
+    }
+    else {
+      compute_keys(0, n);
+    }
 
-      bool found = true;
-      for (size_t dim = 0; dim < dimension; ++dim) {
-        if (!(center[dim] - radius > p2[dim] &&
-              center[dim] + radius < p2[dim] + size)) {
-          found = false;
+    utils::radix_sort(keys);
+
+    // Find the leaves from the sorted keys. The subtrees below the first
+    // few levels are independent, so they are searched concurrently.
+    build_range_t all{root_->id(), keys.data(), keys.data() + n};
+    std::vector<build_range_t> subtrees{all};
+
+    if (pool && pool->num_threads() > 0 && n > grain) {
+      branch_t scratch;
+
+      while (subtrees.size() < 8 * pool->num_threads()) {
+        std::vector<build_range_t> next;
+        bool split = false;
+
+        for (const build_range_t & r : subtrees) {
+          if (size_t(r.last - r.first) > grain && refines_(scratch, r)) {
+            split_range_(r, next);
+            split = true;
+          }
+          else {
+            next.push_back(r);
+          } // if
+        } // for
+
+        subtrees.swap(next);
+
+        if (!split) {
           break;
-        }
-      }
+        } // if
+      } // while
+    } // if
 
-      if (found) {
-        depth = d;
-        return b;
+    std::vector<std::vector<build_range_t>> leaves(subtrees.size());
+
+    auto find_leaves = [&](size_t i) {
+      branch_t scratch;
+      find_leaves_(scratch, subtrees[i], leaves[i]);
+    };
+
+    if (pool && subtrees.size() > 1) {
+      wait_group wg;
+
+      for (size_t i = 0; i < subtrees.size(); ++i) {
+        pool->spawn(wg, [&find_leaves, i] { find_leaves(i); });
       }
 
-      --d;
+      pool->wait(wg);
+    }
+    else {
+      find_leaves(0);
     }
 
-    depth = 0;
-    size = element_t(1);
+    // Create the parents of the leaves. This is the only serial part, and
+    // it is linear in the number of branches.
+    std::vector<std::pair<branch_t *, build_range_t>> filled;
+
+    for (auto & ls : leaves) {
+      for (const build_range_t & r : ls) {
+        branch_t * b = make_branch_(r.id);
+        max_depth_ = std::max(max_depth_, r.id.depth());
+        filled.emplace_back(b, r);
+      } // for
+    } // for
+
+    // Insert the entities of each leaf, concurrently for distinct leaves.
+    auto fill = [&](size_t first, size_t last) {
+      for (size_t i = first; i < last; ++i) {
+        branch_t * b = filled[i].first;
+
+        for (keyed_entity_t * itr = filled[i].second.first;
+             itr != filled[i].second.last; ++itr) {
+          itr->second->set_branch_id_(b->id());
+          b->insert(itr->second);
+        } // for
+
+        b->reset();
+      } // for
+    };
+
+    if (pool && pool->num_threads() > 0 && n > grain) {
+      wait_group wg;
+      const size_t chunk = std::max(
+          size_t(1), filled.size() / (8 * pool->num_threads()));
+
+      for (size_t first = 0; first < filled.size(); first += chunk) {
+        const size_t last = std::min(filled.size(), first + chunk);
+        pool->spawn(wg, [&fill, first, last] { fill(first, last); });
+      }
+
+      pool->wait(wg);
+    }
+    else {
+      fill(0, filled.size());
+    }
+  }
+
+  // A branch id and the sorted entities [first, last) that fall within it.
+  struct build_range_t {
+    branch_id_t id;
+    keyed_entity_t * first;
+    keyed_entity_t * last;
+  };
+
+  // Check if the policy refines a branch holding the entities of r. The
+  // entities are inserted into a scratch branch, which is left empty.
+  bool refines_(branch_t & scratch, const build_range_t & r) {
+    if (r.id.depth() >= branch_id_t::max_depth) {
+      return false;
+    }
+
+    scratch.set_id_(r.id);
+
+    bool refine = false;
+
+    for (keyed_entity_t * itr = r.first; itr != r.last; ++itr) {
+      scratch.insert(itr->second);
+
+      if (scratch.requested_action_() == action::refine) {
+        refine = true;
+        break;
+      } // if
+    } // for
+
+    scratch.clear();
+    scratch.reset();
+
+    return refine;
+  }
+
+  // Split r into the ranges of its children. The child index at the next
+  // depth is the next digit of the keys, which are sorted, so the
+  // children's ranges are consecutive.
+  void split_range_(
+      const build_range_t & r,
+      std::vector<build_range_t> & out) {
+    const size_t shift =
+        (branch_id_t::max_depth - r.id.depth() - 1) * dimension;
+    constexpr branch_int_t mask = branch_t::num_children - 1;
+
+    keyed_entity_t * first = r.first;
+
+    for (size_t ci = 0; ci < branch_t::num_children; ++ci) {
+      branch_id_t id = r.id;
+      id.push(ci);
+
+      keyed_entity_t * end =
+          std::partition_point(first, r.last, [=](const keyed_entity_t & k) {
+            return ((k.first >> shift) & mask) <= ci;
+          });
+
+      out.push_back({id, first, end});
+      first = end;
+    } // for
+  }
+
+  // Append the leaves below r to out, in Morton order. A branch is a leaf
+  // if the policy does not refine it with its entities, so the leaves are
+  // the same as with incremental insertion.
+  void find_leaves_(
+      branch_t & scratch,
+      const build_range_t & r,
+      std::vector<build_range_t> & out) {
+    if (!refines_(scratch, r)) {
+      out.push_back(r);
+      return;
+    }
+
+    std::vector<build_range_t> children;
+    children.reserve(branch_t::num_children);
+    split_range_(r, children);
+
+    for (const build_range_t & c : children) {
+      find_leaves_(scratch, c, out);
+    }
+  }
+
+  // Return the branch with the given id, creating its parent, and so all
+  // of its siblings, if it does not exist yet.
+  branch_t * make_branch_(const branch_id_t & id) {
+    branch_t * b = branch_map_.find(id);
+
+    if (b) {
+      return b;
+    }
+
+    branch_t * p = make_branch_(id.parent());
+    p->template into_branch_<branch_t>(branch_pool_);
+
+    for (size_t ci = 0; ci < branch_t::num_children; ++ci) {
+      branch_t * c = p->template child_<branch_t>(ci);
+      branch_map_.insert(c->id(), c);
+    }
+
+    return branch_map_.find(id);
+  }
+
+  size_t get_queue_depth(thread_pool & pool) {
+    size_t n = pool.num_threads();
+    constexpr size_t rb = branch_int_t(1) << P::dimension;
+    double bn = std::log2(double(rb));
+    return std::log2(double(n)) / bn + 1;
+  }
+
+  branch_t * find_start_(
+      const point_t & center,
+      element_t radius,
+      size_t & depth,
+      element_t & size) {
+
+    element_t norm_radius = radius / max_scale_;
+
+    branch_id_t bid = to_branch_id(center, max_depth_);
+
+    int d = -std::log2(norm_radius) - 1;
+
+    while (d > 0) {
+      branch_t * b = find_parent(bid, d);
+
+      point_t p2;
+      b->id().coordinates(range_, p2);
+
+      size = std::pow(element_t(2), -d);
+
+      bool found = true;
+      for (size_t dim = 0; dim < dimension; ++dim) {
+        if (!(center[dim] - radius > p2[dim] &&
+              center[dim] + radius < p2[dim] + size)) {
+          found = false;
+          break;
+        }
+      }
+
+      if (found) {
+        depth = d;
+        return b;
+      }
+
+      --d;
+    }
+
+    depth = 0;
+    size = element_t(1);
     return root_;
   }
 
@@ -1474,7 +2140,7 @@ private:
   template<typename EF, typename BF, typename... ARGS>
   void apply_(
       thread_pool & pool,
-      virtual_semaphore & sem,
+      wait_group & wg,
       size_t queue_depth,
       size_t depth,
       branch_t * b,
@@ -1488,12 +2154,6 @@ private:
         ef(ent, std::forward<ARGS>(args)...);
       }
 
-      size_t m = branch_int_t(1) << (queue_depth - depth) * P::dimension;
-
-      for (size_t i = 0; i < m; ++i) {
-        sem.release();
-      }
-
       return;
     }
 
@@ -1507,30 +2167,16 @@ private:
              std::forward<ARGS>(args)...)) {
         if (depth == queue_depth) {
 
-          auto f = [&, size, ci]() {
+          pool.spawn(wg, [&, size, ci]() {
             apply_(
                 ci, size, std::forward<EF>(ef), std::forward<BF>(bf),
                 std::forward<ARGS>(args)...);
-
-            sem.release();
-          };
-
-          pool.queue(f);
+          });
         } else {
           apply_(
-              pool, sem, queue_depth, depth, ci, size, std::forward<EF>(ef),
+              pool, wg, queue_depth, depth, ci, size, std::forward<EF>(ef),
               std::forward<BF>(bf), std::forward<ARGS>(args)...);
         }
-      } else {
-        if (depth > queue_depth) {
-          continue;
-        }
-
-        size_t m = branch_int_t(1) << (queue_depth - depth) * P::dimension;
-
-        for (size_t i = 0; i < m; ++i) {
-          sem.release();
-        }
       }
     }
   }
@@ -1570,7 +2216,7 @@ private:
   template<typename EF, typename BF, typename... ARGS>
   void find_(
       thread_pool & pool,
-      virtual_semaphore & sem,
+      wait_group & wg,
       std::mutex & mtx,
       size_t queue_depth,
       size_t depth,
@@ -1590,12 +2236,6 @@ private:
       }
       mtx.unlock();
 
-      size_t m = branch_int_t(1) << (queue_depth - depth) * P::dimension;
-
-      for (size_t i = 0; i < m; ++i) {
-        sem.release();
-      }
-
       return;
     }
 
@@ -1609,7 +2249,7 @@ private:
              std::forward<ARGS>(args)...)) {
         if (depth == queue_depth) {
 
-          auto f = [&, size, ci]() {
+          pool.spawn(wg, [&, size, ci]() {
             subentity_space_t branch_ents;
 
             find_(
@@ -1619,27 +2259,13 @@ private:
             mtx.lock();
             ents.append(branch_ents);
             mtx.unlock();
-
-            sem.release();
-          };
-
-          pool.queue(f);
+          });
         } else {
           find_(
-              pool, sem, mtx, queue_depth, depth, ci, size, ents,
+              pool, wg, mtx, queue_depth, depth, ci, size, ents,
               std::forward<EF>(ef), std::forward<BF>(bf),
               std::forward<ARGS>(args)...);
         }
-      } else {
-        if (depth > queue_depth) {
-          continue;
-        }
-
-        size_t m = branch_int_t(1) << (queue_depth - depth) * P::dimension;
-
-        for (size_t i = 0; i < m; ++i) {
-          sem.release();
-        }
       }
     }
   }
@@ -1663,7 +2289,7 @@ private:
   template<typename F, typename... ARGS>
   void visit_(
       thread_pool & pool,
-      virtual_semaphore & sem,
+      wait_group & wg,
       branch_t * b,
       size_t depth,
       size_t queue_depth,
@@ -1671,32 +2297,18 @@ private:
       ARGS &&... args) {
 
     if (depth == queue_depth) {
-      auto vf = [&, depth, b]() {
+      pool.spawn(wg, [&, depth, b]() {
         visit_(b, depth, std::forward<F>(f), std::forward<ARGS>(args)...);
-        sem.release();
-      };
+      });
 
-      pool.queue(vf);
       return;
     }
 
     if (f(b, depth, std::forward<ARGS>(args)...)) {
-      size_t m = branch_int_t(1) << (queue_depth - depth) * P::dimension;
-
-      for (size_t i = 0; i < m; ++i) {
-        sem.release();
-      }
-
       return;
     }
 
     if (b->is_leaf()) {
-      size_t m = branch_int_t(1) << (queue_depth - depth) * P::dimension;
-
-      for (size_t i = 0; i < m; ++i) {
-        sem.release();
-      }
-
       return;
     }
 
@@ -1704,7 +2316,7 @@ private:
       branch_t * bi = b->template child_<branch_t>(i);
 
       visit_(
-          pool, sem, bi, depth + 1, queue_depth, std::forward<F>(f),
+          pool, wg, bi, depth + 1, queue_depth, std::forward<F>(f),
           std::forward<ARGS>(args)...);
     }
   }
@@ -1712,7 +2324,7 @@ private:
   template<typename F, typename... ARGS>
   void visit_children_(
       thread_pool & pool,
-      virtual_semaphore & sem,
+      wait_group & wg,
       size_t depth,
       size_t queue_depth,
       branch_t * b,
@@ -1720,12 +2332,10 @@ private:
       ARGS &&... args) {
 
     if (depth == queue_depth) {
-      auto vf = [&, b]() {
+      pool.spawn(wg, [&, b]() {
         visit_children(b, std::forward<F>(f), std::forward<ARGS>(args)...);
-        sem.release();
-      };
+      });
 
-      pool.queue(vf);
       return;
     }
 
@@ -1734,29 +2344,459 @@ private:
         f(ent, std::forward<ARGS>(args)...);
       }
 
-      size_t m = branch_int_t(1) << (queue_depth - depth) * P::dimension;
-
-      for (size_t i = 0; i < m; ++i) {
-        sem.release();
-      }
-
       return;
     }
 
     for (size_t i = 0; i < branch_t::num_children; ++i) {
       branch_t * bi = b->template child_<branch_t>(i);
       visit_children_(
-          pool, sem, depth + 1, queue_depth, bi, std::forward<F>(f),
+          pool, wg, depth + 1, queue_depth, bi, std::forward<F>(f),
           std::forward<ARGS>(args)...);
     }
   }
 
+  // A branch and its box, the traversal state that is carried from one
+  // query to the next.
+  struct cursor_t {
+    branch_t * b;
+    box_t box;
+  };
+
+  // A nearest neighbor candidate.
+  struct candidate_t {
+    element_t d2;
+    entity_t * ent;
+
+    bool operator<(const candidate_t & c) const {
+      return d2 < c.d2 || (d2 == c.d2 && ent->id() < c.ent->id());
+    }
+  };
+
+  static element_t distance2_(const point_t & a, const point_t & b) {
+    element_t d2 = 0;
+
+    for (size_t j = 0; j < dimension; ++j) {
+      d2 += (a[j] - b[j]) * (a[j] - b[j]);
+    }
+
+    return d2;
+  }
+
+  // Squared distance between a point and a box.
+  static element_t distance2_(const box_t & box, const point_t & p) {
+    element_t d2 = 0;
+
+    for (size_t j = 0; j < dimension; ++j) {
+      const element_t d =
+          std::max({box[0][j] - p[j], p[j] - box[1][j], element_t(0)});
+      d2 += d * d;
+    }
+
+    return d2;
+  }
+
+  // Return true if the box contains the spheroid.
+  static bool
+  contains_(const box_t & box, const point_t & center, element_t radius) {
+    for (size_t j = 0; j < dimension; ++j) {
+      if (center[j] - radius < box[0][j] || center[j] + radius > box[1][j]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  static box_t child_box_(const box_t & box, size_t ci) {
+    box_t cb;
+
+    for (size_t j = 0; j < dimension; ++j) {
+      const element_t mid = box[0][j] + (box[1][j] - box[0][j]) / 2;
+
+      if (ci & size_t(1) << j) {
+        cb[0][j] = mid;
+        cb[1][j] = box[1][j];
+      } else {
+        cb[0][j] = box[0][j];
+        cb[1][j] = mid;
+      }
+    }
+
+    return cb;
+  }
+
+  void up_(cursor_t & c) {
+    c.b = static_cast<branch_t *>(c.b->parent());
+    c.box = branch_box(c.b->id());
+  }
+
+  // Move the cursor to the leaf containing p.
+  void locate_(cursor_t & c, const point_t & p) {
+    while (c.b != root_ && !contains_(c.box, p, element_t(0))) {
+      up_(c);
+    }
+
+    while (!c.b->is_leaf()) {
+      size_t ci = 0;
+
+      for (size_t j = 0; j < dimension; ++j) {
+        if (p[j] >= c.box[0][j] + (c.box[1][j] - c.box[0][j]) / 2) {
+          ci |= size_t(1) << j;
+        }
+      }
+
+      c.b = c.b->template child_<branch_t>(ci);
+      c.box = child_box_(c.box, ci);
+    }
+  }
+
+  void find_in_radius_(
+      cursor_t & c,
+      const point_t & p,
+      element_t radius,
+      std::vector<entity_t *> & found) {
+
+    locate_(c, p);
+
+    // The smallest ancestor of the leaf that contains the spheroid.
+    cursor_t start = c;
+
+    while (start.b != root_ && !contains_(start.box, p, radius)) {
+      up_(start);
+    }
+
+    find_in_radius_(start.b, start.box, p, radius * radius, found);
+  }
+
+  void find_in_radius_(
+      branch_t * b,
+      const box_t & box,
+      const point_t & p,
+      element_t radius2,
+      std::vector<entity_t *> & found) {
+
+    if (distance2_(box, p) > radius2) {
+      return;
+    }
+
+    if (b->is_leaf()) {
+      for (auto ent : *b) {
+        if (distance2_(ent->coordinates(), p) <= radius2) {
+          found.push_back(ent);
+        }
+      }
+
+      return;
+    }
+
+    for (size_t i = 0; i < branch_t::num_children; ++i) {
+      find_in_radius_(
+          b->template child_<branch_t>(i), child_box_(box, i), p, radius2,
+          found);
+    }
+  }
+
+  void find_nearest_(
+      cursor_t & c,
+      const point_t & p,
+      size_t k,
+      std::vector<entity_t *> & found) {
+
+    if (k == 0) {
+      return;
+    }
+
+    locate_(c, p);
+
+    // Search the leaf, then the siblings of its ancestors, until the
+    // current branch contains the spheroid of the k-th nearest candidate.
+    std::vector<candidate_t> heap;
+    find_nearest_(c.b, c.box, p, k, heap);
+
+    cursor_t cur = c;
+
+    while (cur.b != root_ &&
+           (heap.size() < k ||
+            !contains_(cur.box, p, std::sqrt(heap.front().d2)))) {
+      branch_t * prev = cur.b;
+      up_(cur);
+
+      for (size_t i = 0; i < branch_t::num_children; ++i) {
+        branch_t * ci = cur.b->template child_<branch_t>(i);
+
+        if (ci != prev) {
+          find_nearest_(ci, child_box_(cur.box, i), p, k, heap);
+        }
+      }
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+
+    for (auto & h : heap) {
+      found.push_back(h.ent);
+    }
+  }
+
+  void find_nearest_(
+      branch_t * b,
+      const box_t & box,
+      const point_t & p,
+      size_t k,
+      std::vector<candidate_t> & heap) {
+
+    if (heap.size() == k && distance2_(box, p) > heap.front().d2) {
+      return;
+    }
+
+    if (b->is_leaf()) {
+      for (auto ent : *b) {
+        candidate_t h = {distance2_(ent->coordinates(), p), ent};
+
+        if (heap.size() < k) {
+          heap.push_back(h);
+          std::push_heap(heap.begin(), heap.end());
+        } else if (h < heap.front()) {
+          std::pop_heap(heap.begin(), heap.end());
+          heap.back() = h;
+          std::push_heap(heap.begin(), heap.end());
+        }
+      }
+
+      return;
+    }
+
+    // Visit the nearest children first, to tighten the bound early.
+    std::array<std::pair<element_t, size_t>, branch_t::num_children> order;
+
+    for (size_t i = 0; i < branch_t::num_children; ++i) {
+      order[i] = {distance2_(child_box_(box, i), p), i};
+    }
+
+    std::sort(order.begin(), order.end());
+
+    for (auto & o : order) {
+      find_nearest_(
+          b->template child_<branch_t>(o.second), child_box_(box, o.second),
+          p, k, heap);
+    }
+  }
+
+  // Run a query for each point, in Morton order, and gather the results
+  // by point.
+  template<typename Q>
+  neighbor_list_t
+  batch_(thread_pool * pool, const std::vector<point_t> & points, Q && query) {
+    const size_t n = points.size();
+
+    std::vector<std::pair<branch_int_t, size_t>> order(n);
+
+    for (size_t i = 0; i < n; ++i) {
+      order[i] = {to_branch_id(points[i], branch_id_t::max_depth).value_(), i};
+    }
+
+    utils::radix_sort(order);
+
+    // Each chunk of queries keeps its own cursor and results.
+    constexpr size_t grain = 1024;
+    const size_t num_chunks = (n + grain - 1) / grain;
+
+    std::vector<std::vector<entity_t *>> results(num_chunks);
+    std::vector<size_t> counts(n);
+
+    auto run = [&](size_t chunk) {
+      cursor_t c = {root_, branch_box(root_->id())};
+      std::vector<entity_t *> & found = results[chunk];
+
+      for (size_t q = chunk * grain; q < std::min(n, (chunk + 1) * grain);
+           ++q) {
+        const size_t before = found.size();
+        query(c, points[order[q].second], found);
+        counts[order[q].second] = found.size() - before;
+      }
+    };
+
+    auto gather = [&](size_t chunk, neighbor_list_t & nl) {
+      auto itr = results[chunk].begin();
+
+      for (size_t q = chunk * grain; q < std::min(n, (chunk + 1) * grain);
+           ++q) {
+        const size_t i = order[q].second;
+        std::copy(
+            itr, itr + counts[i], nl.entities.begin() + nl.offsets[i]);
+        itr += counts[i];
+      }
+    };
+
+    if (pool && pool->num_threads() > 0 && num_chunks > 1) {
+      wait_group wg;
+
+      for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+        pool->spawn(wg, [&run, chunk] { run(chunk); });
+      }
+
+      pool->wait(wg);
+    } else {
+      for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+        run(chunk);
+      }
+    }
+
+    neighbor_list_t nl;
+    nl.offsets.resize(n + 1);
+    nl.offsets[0] = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+      nl.offsets[i + 1] = nl.offsets[i] + counts[i];
+    }
+
+    nl.entities.resize(nl.offsets[n]);
+
+    if (pool && pool->num_threads() > 0 && num_chunks > 1) {
+      wait_group wg;
+
+      for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+        pool->spawn(wg, [&gather, &nl, chunk] { gather(chunk, nl); });
+      }
+
+      pool->wait(wg);
+    } else {
+      for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+        gather(chunk, nl);
+      }
+    }
+
+    return nl;
+  }
+
+  template<typename P2M, typename M2M>
+  void accumulate_(branch_t * b, P2M & p2m, M2M & m2m) {
+    if (b->is_leaf()) {
+      p2m(b);
+      return;
+    }
+
+    for (size_t i = 0; i < branch_t::num_children; ++i) {
+      accumulate_(b->template child_<branch_t>(i), p2m, m2m);
+    }
+
+    m2m(b);
+  }
+
+  template<typename P2M, typename M2M>
+  void accumulate_(
+      thread_pool & pool,
+      wait_group & wg,
+      branch_t * b,
+      size_t depth,
+      size_t queue_depth,
+      P2M & p2m,
+      M2M & m2m) {
+
+    if (b->is_leaf()) {
+      p2m(b);
+      return;
+    }
+
+    if (depth == queue_depth) {
+      pool.spawn(wg, [&, b]() { accumulate_(b, p2m, m2m); });
+      return;
+    }
+
+    for (size_t i = 0; i < branch_t::num_children; ++i) {
+      accumulate_(
+          pool, wg, b->template child_<branch_t>(i), depth + 1, queue_depth,
+          p2m, m2m);
+    }
+  }
+
+  // Combine the payloads of the branches above the queue depth.
+  template<typename M2M>
+  void combine_(branch_t * b, size_t depth, size_t queue_depth, M2M & m2m) {
+    if (b->is_leaf() || depth == queue_depth) {
+      return;
+    }
+
+    for (size_t i = 0; i < branch_t::num_children; ++i) {
+      combine_(b->template child_<branch_t>(i), depth + 1, queue_depth, m2m);
+    }
+
+    m2m(b);
+  }
+
+  template<typename K>
+  void interact_(
+      branch_t * t,
+      size_t target_depth,
+      branch_t * s,
+      size_t source_depth,
+      K & kernel) {
+
+    if (t != s && kernel.accept(t, s)) {
+      kernel.m2l(t, s);
+      return;
+    }
+
+    if (t->is_leaf() && s->is_leaf()) {
+      kernel.p2p(t, s);
+      return;
+    }
+
+    // Split the larger branch, or the source if the target is a leaf.
+    if (t->is_leaf() || (!s->is_leaf() && source_depth <= target_depth)) {
+      for (size_t i = 0; i < branch_t::num_children; ++i) {
+        interact_(
+            t, target_depth, s->template child_<branch_t>(i),
+            source_depth + 1, kernel);
+      }
+    } else {
+      for (size_t i = 0; i < branch_t::num_children; ++i) {
+        interact_(
+            t->template child_<branch_t>(i), target_depth + 1, s,
+            source_depth, kernel);
+      }
+    }
+  }
+
+  template<typename K>
+  void downward_(branch_t * b, K & kernel) {
+    if (b->is_leaf()) {
+      kernel.l2p(b);
+      return;
+    }
+
+    for (size_t i = 0; i < branch_t::num_children; ++i) {
+      branch_t * ci = b->template child_<branch_t>(i);
+      kernel.l2l(b, ci);
+      downward_(ci, kernel);
+    }
+  }
+
+  // Collect the branches at the queue depth, and the leaves above it.
+  void targets_(
+      branch_t * b,
+      size_t depth,
+      size_t queue_depth,
+      std::vector<std::pair<branch_t *, size_t>> & targets) {
+
+    if (b->is_leaf() || depth == queue_depth) {
+      targets.emplace_back(b, depth);
+      return;
+    }
+
+    for (size_t i = 0; i < branch_t::num_children; ++i) {
+      targets_(
+          b->template child_<branch_t>(i), depth + 1, queue_depth, targets);
+    }
+  }
+
+  branch_pool_t branch_pool_;
+  entity_pool_t entity_pool_;
   branch_map_t branch_map_;
   size_t max_depth_;
   branch_t * root_;
   entity_space_t entities_;
-  std::array<point<element_t, dimension>, 2> range_;
-  point<element_t, dimension> scale_;
+  std::array<point__<element_t, dimension>, 2> range_;
+  point__<element_t, dimension> scale_;
   element_t max_scale_;
 };
 
@@ -1881,16 +2921,16 @@ private:
     return static_cast<B *>(children_) + ci;
   }
 
-  template<class B>
-  bool into_branch_() {
+  template<class B, class POOL>
+  bool into_branch_(POOL & pool) {
     if (children_) {
       return false;
     }
 
-    auto c = new B[num_children];
+    B * c = pool.allocate();
 
     for (branch_int_t bi = 0; bi < num_children; ++bi) {
-      B & ci = c[bi];
+      B & ci = *new (c + bi) B;
       ci.id_ = id_;
       ci.id_.push(bi);
       ci.parent_ = this;
@@ -1902,22 +2942,17 @@ private:
     return true;
   }
 
-  template<class B>
-  void into_leaf_() {
+  template<class B, class POOL>
+  void dealloc_(POOL & pool) {
     if (children_) {
-      delete[] static_cast<B *>(children_);
-      children_ = nullptr;
-    }
-  }
+      B * c = static_cast<B *>(children_);
 
-  template<class B>
-  void dealloc_() {
-    if (children_) {
       for (size_t i = 0; i < num_children; ++i) {
-        static_cast<B *>(children_)[i].template dealloc_<B>();
+        c[i].template dealloc_<B>(pool);
+        c[i].~B();
       }
 
-      delete[] static_cast<B *>(children_);
+      pool.deallocate(c);
       children_ = nullptr;
     }
   }
@@ -0,0 +1,322 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace flecsi {
+namespace utils {
+
+/*!
+  A set stored as a sorted vector of unique values.
+
+  flat_set__ provides the part of the interface of std::set that is used
+  to build and query index sets, so that it can replace std::set where
+  sets are large and mostly built in order: a value that is greater than
+  all values of the set is appended in constant time, and a range of
+  values is inserted with a sort of the range and a merge. Other
+  insertions and erasures are linear in the size of the set. As with
+  std::set, the values are not modifiable through iterators.
+
+  @tparam T       The value type.
+  @tparam COMPARE The strict weak ordering of the values.
+ */
+
+template<typename T, typename COMPARE = std::less<T>>
+class flat_set__
+{
+public:
+  using vector_t = std::vector<T>;
+
+  using key_type = T;
+  using value_type = T;
+  using key_compare = COMPARE;
+  using value_compare = COMPARE;
+  using size_type = typename vector_t::size_type;
+  using difference_type = typename vector_t::difference_type;
+  using reference = const T &;
+  using const_reference = const T &;
+  using iterator = typename vector_t::const_iterator;
+  using const_iterator = typename vector_t::const_iterator;
+  using reverse_iterator = typename vector_t::const_reverse_iterator;
+  using const_reverse_iterator = typename vector_t::const_reverse_iterator;
+
+  //! Tag to construct a set from values that are sorted and unique.
+  struct sorted_unique_t {};
+
+  //--------------------------------------------------------------------------//
+  // Construction.
+  //--------------------------------------------------------------------------//
+
+  flat_set__() {}
+
+  flat_set__(std::initializer_list<T> values) {
+    insert(values.begin(), values.end());
+  } // flat_set__
+
+  template<typename ITERATOR>
+  flat_set__(ITERATOR first, ITERATOR last) {
+    insert(first, last);
+  } // flat_set__
+
+  /*!
+    Construct a set from the values of a std::set. This conversion is
+    implicit, so that sets can be passed where a flat_set__ is expected.
+   */
+
+  flat_set__(const std::set<T, COMPARE> & values)
+      : values_(values.begin(), values.end()) {}
+
+  /*!
+    Construct a set from a vector of values, which need not be sorted.
+   */
+
+  explicit flat_set__(vector_t && values) : values_(std::move(values)) {
+    normalize(0);
+  } // flat_set__
+
+  /*!
+    Construct a set from a vector of sorted and unique values.
+   */
+
+  flat_set__(sorted_unique_t, vector_t && values)
+      : values_(std::move(values)) {
+    assert_sorted_unique();
+  } // flat_set__
+
+  //--------------------------------------------------------------------------//
+  // Iterators and capacity.
+  //--------------------------------------------------------------------------//
+
+  const_iterator begin() const {
+    return values_.begin();
+  }
+
+  const_iterator end() const {
+    return values_.end();
+  }
+
+  const_iterator cbegin() const {
+    return values_.cbegin();
+  }
+
+  const_iterator cend() const {
+    return values_.cend();
+  }
+
+  const_reverse_iterator rbegin() const {
+    return values_.rbegin();
+  }
+
+  const_reverse_iterator rend() const {
+    return values_.rend();
+  }
+
+  bool empty() const {
+    return values_.empty();
+  }
+
+  size_type size() const {
+    return values_.size();
+  }
+
+  void reserve(size_type n) {
+    values_.reserve(n);
+  }
+
+  void shrink_to_fit() {
+    values_.shrink_to_fit();
+  }
+
+  void clear() {
+    values_.clear();
+  }
+
+  void swap(flat_set__ & s) {
+    values_.swap(s.values_);
+  }
+
+  //! The sorted values of the set.
+  const vector_t & values() const {
+    return values_;
+  }
+
+  //! The i-th smallest value of the set.
+  const T & operator[](size_type i) const {
+    return values_[i];
+  }
+
+  //--------------------------------------------------------------------------//
+  // Lookup.
+  //--------------------------------------------------------------------------//
+
+  const_iterator lower_bound(const T & value) const {
+    return std::lower_bound(values_.begin(), values_.end(), value, COMPARE());
+  }
+
+  const_iterator upper_bound(const T & value) const {
+    return std::upper_bound(values_.begin(), values_.end(), value, COMPARE());
+  }
+
+  const_iterator find(const T & value) const {
+    auto itr = lower_bound(value);
+    return itr != values_.end() && !COMPARE()(value, *itr) ? itr
+                                                            : values_.end();
+  } // find
+
+  size_type count(const T & value) const {
+    return find(value) != values_.end();
+  }
+
+  //--------------------------------------------------------------------------//
+  // Modifiers.
+  //--------------------------------------------------------------------------//
+
+  std::pair<iterator, bool> insert(const T & value) {
+    // Appending in order is the common case.
+    if (values_.empty() || COMPARE()(values_.back(), value)) {
+      values_.push_back(value);
+      return {values_.end() - 1, true};
+    } // if
+
+    auto itr = lower_bound(value);
+    if (!COMPARE()(value, *itr)) {
+      return {itr, false};
+    } // if
+
+    return {values_.insert(itr, value), true};
+  } // insert
+
+  iterator insert(const_iterator, const T & value) {
+    return insert(value).first;
+  }
+
+  template<typename... ARGS>
+  std::pair<iterator, bool> emplace(ARGS &&... args) {
+    return insert(T(std::forward<ARGS>(args)...));
+  }
+
+  /*!
+    Insert a range of values: the values are appended, sorted and merged
+    with the values of the set. If values are equivalent, the value that
+    was inserted first is kept, as with std::set.
+   */
+
+  template<typename ITERATOR>
+  void insert(ITERATOR first, ITERATOR last) {
+    const size_type n = values_.size();
+    values_.insert(values_.end(), first, last);
+    normalize(n);
+  } // insert
+
+  void insert(std::initializer_list<T> values) {
+    insert(values.begin(), values.end());
+  }
+
+  size_type erase(const T & value) {
+    auto itr = find(value);
+    if (itr == values_.end()) {
+      return 0;
+    } // if
+
+    values_.erase(itr);
+    return 1;
+  } // erase
+
+  iterator erase(const_iterator position) {
+    return values_.erase(position);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    return values_.erase(first, last);
+  }
+
+  //--------------------------------------------------------------------------//
+  // Comparison.
+  //--------------------------------------------------------------------------//
+
+  bool operator==(const flat_set__ & s) const {
+    return values_ == s.values_;
+  }
+
+  bool operator!=(const flat_set__ & s) const {
+    return values_ != s.values_;
+  }
+
+  bool operator<(const flat_set__ & s) const {
+    return std::lexicographical_compare(
+        values_.begin(), values_.end(), s.values_.begin(), s.values_.end(),
+        COMPARE());
+  } // operator <
+
+private:
+  static bool equivalent(const T & a, const T & b) {
+    return !COMPARE()(a, b) && !COMPARE()(b, a);
+  }
+
+  // Sort the values from position n on, merge them with the sorted
+  // values before n, and remove duplicates, keeping the first.
+  void normalize(size_type n) {
+    auto middle = values_.begin() + n;
+
+    if (!std::is_sorted(middle, values_.end(), COMPARE())) {
+      std::stable_sort(middle, values_.end(), COMPARE());
+    } // if
+
+    if (n != 0 && middle != values_.end() &&
+        COMPARE()(*middle, *(middle - 1))) {
+      std::inplace_merge(values_.begin(), middle, values_.end(), COMPARE());
+    } // if
+
+    values_.erase(
+        std::unique(values_.begin(), values_.end(), equivalent),
+        values_.end());
+  } // normalize
+
+  void assert_sorted_unique() const {
+    assert(
+        std::adjacent_find(
+            values_.begin(), values_.end(),
+            [](const T & a, const T & b) { return !COMPARE()(a, b); }) ==
+            values_.end() &&
+        "values are not sorted and unique");
+  } // assert_sorted_unique
+
+  vector_t values_;
+}; // class flat_set__
+
+//! True if S is a flat_set__.
+template<typename S>
+struct is_flat_set : std::false_type {};
+
+template<typename T, typename COMPARE>
+struct is_flat_set<flat_set__<T, COMPARE>> : std::true_type {};
+
+} // namespace utils
+} // namespace flecsi
+
+/*~-------------------------------------------------------------------------~-*
+ * Formatting options
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~-------------------------------------------------------------------------~-*/
@@ -0,0 +1,128 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace flecsi {
+namespace utils {
+
+/*!
+  The object_pool__ type is a fixed-size block allocator. Each block holds
+  N contiguous objects of type T, and blocks are carved out of chunks of
+  CHUNK blocks, so that consecutive allocations are adjacent in memory.
+  Released blocks are recycled (most recently released first) before new
+  storage is used, and memory is only returned to the system when the
+  pool is destroyed.
+
+  The pool hands out uninitialized storage: objects are constructed and
+  destroyed by the caller, e.g., with placement new. The pool is not
+  thread-safe.
+
+  @tparam T     The object type.
+  @tparam N     The number of objects per block.
+  @tparam CHUNK The number of blocks per chunk.
+ */
+
+template<typename T, size_t N = 1, size_t CHUNK = 256>
+class object_pool__ {
+public:
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+    "object_pool__ does not support over-aligned types");
+
+  object_pool__() = default;
+
+  /// Copy constructor (disabled)
+  object_pool__(const object_pool__ &) = delete;
+
+  /// Assignment operator (disabled)
+  object_pool__ & operator=(const object_pool__ &) = delete;
+
+  /*!
+    Return storage for N contiguous objects of type T.
+   */
+
+  T * allocate() {
+    slot_t * slot;
+
+    if (free_) {
+      slot = free_;
+      free_ = free_->next;
+    }
+    else {
+      if (next_ == CHUNK) {
+        chunks_.emplace_back(new slot_t[CHUNK]);
+        next_ = 0;
+      } // if
+
+      slot = &chunks_.back()[next_++];
+    } // if
+
+    ++size_;
+
+    return reinterpret_cast<T *>(&slot->storage);
+  } // allocate
+
+  /*!
+    Return a block to the pool. The objects in the block must already have
+    been destroyed.
+   */
+
+  void deallocate(T * p) {
+    assert(p && size_ > 0);
+
+    slot_t * slot = reinterpret_cast<slot_t *>(p);
+    slot->next = free_;
+    free_ = slot;
+
+    --size_;
+  } // deallocate
+
+  /*!
+    Return the number of allocated blocks.
+   */
+
+  size_t size() const {
+    return size_;
+  } // size
+
+  /*!
+    Return the number of blocks for which memory has been reserved.
+   */
+
+  size_t capacity() const {
+    return chunks_.size() * CHUNK;
+  } // capacity
+
+private:
+  union slot_t {
+    slot_t * next;
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type storage;
+  }; // union slot_t
+
+  std::vector<std::unique_ptr<slot_t[]>> chunks_;
+  slot_t * free_ = nullptr;
+  size_t next_ = CHUNK;
+  size_t size_ = 0;
+
+}; // class object_pool__
+
+} // namespace utils
+} // namespace flecsi
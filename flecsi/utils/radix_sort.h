@@ -0,0 +1,98 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace flecsi {
+namespace utils {
+
+namespace radix_sort_detail {
+
+template<typename KEY, typename VALUE>
+void
+radix_sort(std::vector<std::pair<KEY, VALUE>> & v, std::true_type) {
+  constexpr size_t digit_bits = 8;
+  constexpr size_t radix = size_t(1) << digit_bits;
+  constexpr size_t passes = (sizeof(KEY) * 8 + digit_bits - 1) / digit_bits;
+
+  std::vector<std::pair<KEY, VALUE>> scratch(v.size());
+
+  for (size_t pass = 0; pass < passes; ++pass) {
+    const size_t shift = pass * digit_bits;
+
+    std::array<size_t, radix> counts;
+    counts.fill(0);
+
+    for (const auto & p : v) {
+      ++counts[(p.first >> shift) & (radix - 1)];
+    } // for
+
+    // Skip the digits that are the same for all keys, e.g., the high
+    // digits of small keys.
+    if (std::find(counts.begin(), counts.end(), v.size()) != counts.end()) {
+      continue;
+    } // if
+
+    size_t offset = 0;
+    for (auto & c : counts) {
+      const size_t n = c;
+      c = offset;
+      offset += n;
+    } // for
+
+    for (auto & p : v) {
+      scratch[counts[(p.first >> shift) & (radix - 1)]++] = std::move(p);
+    } // for
+
+    v.swap(scratch);
+  } // for
+} // radix_sort
+
+template<typename KEY, typename VALUE>
+void
+radix_sort(std::vector<std::pair<KEY, VALUE>> & v, std::false_type) {
+  std::stable_sort(v.begin(), v.end(),
+    [](const std::pair<KEY, VALUE> & a, const std::pair<KEY, VALUE> & b) {
+      return a.first < b.first;
+    });
+} // radix_sort
+
+} // namespace radix_sort_detail
+
+/*!
+  Stable sort of key/value pairs by key. Unsigned integer keys are sorted
+  with a least-significant-digit radix sort in O(N) time. Other key types
+  fall back to std::stable_sort.
+
+  @param v The key/value pairs to sort.
+ */
+
+template<typename KEY, typename VALUE>
+void
+radix_sort(std::vector<std::pair<KEY, VALUE>> & v) {
+  radix_sort_detail::radix_sort(v,
+    std::integral_constant<bool,
+      std::is_integral<KEY>::value && std::is_unsigned<KEY>::value>());
+} // radix_sort
+
+} // namespace utils
+} // namespace flecsi
@@ -16,7 +16,12 @@
 /*! @file */
 
 #include <algorithm>
+#include <iterator>
 #include <set>
+#include <type_traits>
+#include <vector>
+
+#include <flecsi/utils/flat_set.h>
 
 namespace flecsi {
 namespace utils {
@@ -87,5 +92,67 @@ set_difference(const std::set<T> & s1, const std::set<T> & s2) {
   return difference;
 } // set_difference
 
+//!
+//! The result type of the set operations below, which are selected when
+//! at least one of the sets is a flat_set__.
+//!
+template<class S1, class S2>
+using flat_set_result_t = std::enable_if_t<
+    is_flat_set<S1>::value || is_flat_set<S2>::value,
+    flat_set__<typename S1::value_type>>;
+
+//!
+//! Merge-based version of set_intersection for flat sets. Either of the
+//! sets may be a std::set.
+//!
+template<class S1, class S2>
+inline flat_set_result_t<S1, S2>
+set_intersection(const S1 & s1, const S2 & s2) {
+  std::vector<typename S1::value_type> intersection;
+  intersection.reserve(std::min(s1.size(), s2.size()));
+
+  std::set_intersection(
+      s1.begin(), s1.end(), s2.begin(), s2.end(),
+      std::back_inserter(intersection));
+
+  return {typename flat_set_result_t<S1, S2>::sorted_unique_t(),
+      std::move(intersection)};
+} // set_intersection
+
+//!
+//! Merge-based version of set_union for flat sets. Either of the sets may
+//! be a std::set.
+//!
+template<class S1, class S2>
+inline flat_set_result_t<S1, S2>
+set_union(const S1 & s1, const S2 & s2) {
+  std::vector<typename S1::value_type> sunion;
+  sunion.reserve(s1.size() + s2.size());
+
+  std::set_union(
+      s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(sunion));
+
+  return {typename flat_set_result_t<S1, S2>::sorted_unique_t(),
+      std::move(sunion)};
+} // set_union
+
+//!
+//! Merge-based version of set_difference for flat sets. Either of the
+//! sets may be a std::set.
+//!
+template<class S1, class S2>
+inline flat_set_result_t<S1, S2>
+set_difference(const S1 & s1, const S2 & s2) {
+  std::vector<typename S1::value_type> difference;
+  difference.reserve(s1.size());
+
+  std::set_difference(
+      s1.begin(), s1.end(), s2.begin(), s2.end(),
+      std::back_inserter(difference));
+
+  return {typename flat_set_result_t<S1, S2>::sorted_unique_t(),
+      std::move(difference)};
+} // set_difference
+
 } // namespace utils
 } // namespace flecsi
@@ -0,0 +1,160 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2018 Los Alamos National Security, LLC
+ * All rights reserved
+ *~-------------------------------------------------------------------------~~*/
+
+// includes: flecsi
+#include <flecsi/utils/flat_set.h>
+#include <flecsi/utils/set_utils.h>
+
+// includes: C++
+#include <random>
+#include <set>
+#include <vector>
+
+// includes: other
+#include <cinchtest.h>
+
+using flat_set_t = flecsi::utils::flat_set__<std::size_t>;
+
+// equal
+template<class S1, class S2>
+inline bool
+equal(const S1 & s1, const S2 & s2) {
+  return s1.size() == s2.size() &&
+         std::equal(s1.begin(), s1.end(), s2.begin());
+}
+
+// A value that is ordered by key only
+struct keyed_t {
+  std::size_t key;
+  std::size_t value;
+
+  bool operator<(const keyed_t & k) const {
+    return key < k.key;
+  }
+
+  bool operator==(const keyed_t & k) const {
+    return key == k.key && value == k.value;
+  }
+};
+
+// =============================================================================
+// Test flecsi::utils::flat_set__
+// =============================================================================
+
+// TEST
+TEST(flat_set, insert) {
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<std::size_t> dist(0, 200);
+
+  std::set<std::size_t> reference;
+  flat_set_t s;
+
+  // In order, out of order and repeated values.
+  for (std::size_t i = 0; i < 50; ++i) {
+    EXPECT_EQ(s.insert(2 * i).second, reference.insert(2 * i).second);
+  }
+
+  for (std::size_t i = 0; i < 500; ++i) {
+    const std::size_t v = dist(gen);
+    auto r = s.insert(v);
+    EXPECT_EQ(r.second, reference.insert(v).second);
+    EXPECT_EQ(*r.first, v);
+  }
+
+  EXPECT_TRUE(equal(s, reference));
+
+  // Ranges.
+  std::vector<std::size_t> values;
+  for (std::size_t i = 0; i < 300; ++i) {
+    values.push_back(dist(gen) + 100);
+  }
+
+  s.insert(values.begin(), values.end());
+  reference.insert(values.begin(), values.end());
+  EXPECT_TRUE(equal(s, reference));
+
+  EXPECT_TRUE(equal(flat_set_t(values.begin(), values.end()),
+    std::set<std::size_t>(values.begin(), values.end())));
+  EXPECT_TRUE(equal(flat_set_t(std::vector<std::size_t>(values)),
+    std::set<std::size_t>(values.begin(), values.end())));
+
+  // Conversion from std::set.
+  EXPECT_EQ(flat_set_t(reference), s);
+} // TEST
+
+// TEST
+TEST(flat_set, find_erase) {
+  flat_set_t s = {9, 1, 7, 3, 5, 3};
+
+  EXPECT_EQ(s.size(), 5);
+  EXPECT_EQ(s[0], 1);
+  EXPECT_EQ(s[4], 9);
+
+  EXPECT_EQ(s.count(3), 1);
+  EXPECT_EQ(s.count(4), 0);
+  EXPECT_TRUE(s.find(4) == s.end());
+  EXPECT_EQ(*s.find(7), 7);
+  EXPECT_EQ(*s.lower_bound(4), 5);
+  EXPECT_EQ(*s.upper_bound(5), 7);
+
+  EXPECT_EQ(s.erase(4), 0);
+  EXPECT_EQ(s.erase(3), 1);
+  s.erase(s.begin());
+  EXPECT_EQ(s, flat_set_t({5, 7, 9}));
+
+  flat_set_t t;
+  t.swap(s);
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(t.size(), 3);
+} // TEST
+
+// TEST
+TEST(flat_set, first_inserted) {
+  // As with std::set, of equivalent values, the first inserted is kept.
+  flecsi::utils::flat_set__<keyed_t> s;
+  std::set<keyed_t> reference;
+
+  std::vector<keyed_t> values = {{3, 0}, {1, 0}, {3, 1}, {2, 0}, {1, 1}};
+
+  for (auto & v : values) {
+    s.insert(v);
+    reference.insert(v);
+  }
+
+  EXPECT_TRUE(equal(s, reference));
+
+  std::vector<keyed_t> more = {{4, 0}, {2, 1}, {4, 1}, {0, 0}};
+  s.insert(more.begin(), more.end());
+  reference.insert(more.begin(), more.end());
+
+  EXPECT_TRUE(equal(s, reference));
+} // TEST
+
+// TEST
+TEST(flat_set, set_utils) {
+  std::set<std::size_t> a = {1, 3, 5, 7, 10, 11};
+  std::set<std::size_t> b = {2, 3, 6, 7, 10, 12};
+
+  const flat_set_t fa(a), fb(b);
+
+  EXPECT_TRUE(equal(flecsi::utils::set_intersection(fa, fb),
+    flecsi::utils::set_intersection(a, b)));
+  EXPECT_TRUE(equal(flecsi::utils::set_union(fa, fb),
+    flecsi::utils::set_union(a, b)));
+  EXPECT_TRUE(equal(flecsi::utils::set_difference(fa, fb),
+    flecsi::utils::set_difference(a, b)));
+
+  // Mixed arguments give a flat set.
+  flat_set_t u = flecsi::utils::set_union(a, fb);
+  flat_set_t d = flecsi::utils::set_difference(fa, b);
+
+  EXPECT_TRUE(equal(u, flecsi::utils::set_union(a, b)));
+  EXPECT_TRUE(equal(d, flecsi::utils::set_difference(a, b)));
+} // TEST
+
+/*~-------------------------------------------------------------------------~-*
+ * Formatting options
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~-------------------------------------------------------------------------~-*/
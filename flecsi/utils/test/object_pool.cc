@@ -0,0 +1,74 @@
+/*~--------------------------------------------------------------------------~*
+ *  @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+ * /@@/////  /@@          @@////@@ @@////// /@@
+ * /@@       /@@  @@@@@  @@    // /@@       /@@
+ * /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+ * /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+ * /@@       /@@/@@//// //@@    @@       /@@/@@
+ * /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+ * //       ///  //////   //////  ////////  //
+ *
+ * Copyright (c) 2016 Los Alamos National Laboratory, LLC
+ * All rights reserved
+ *~--------------------------------------------------------------------------~*/
+
+// user includes
+#include <flecsi/utils/object_pool.h>
+
+// system includes
+#include <cinchtest.h>
+#include <cstdint>
+#include <set>
+
+using flecsi::utils::object_pool__;
+
+struct vector4_t {
+  double x[4];
+};
+
+TEST(object_pool, allocate) {
+  object_pool__<vector4_t, 4, 8> pool;
+
+  // Blocks within a chunk are contiguous.
+  vector4_t * a = pool.allocate();
+  vector4_t * b = pool.allocate();
+  ASSERT_EQ(b, a + 4);
+
+  std::set<vector4_t *> blocks = {a, b};
+  for(size_t i = 0; i < 30; ++i) {
+    vector4_t * p = pool.allocate();
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(vector4_t), 0);
+    ASSERT_TRUE(blocks.insert(p).second);
+
+    // The block must be writable.
+    for(size_t j = 0; j < 4; ++j) {
+      p[j].x[3] = double(i);
+    } // for
+  } // for
+
+  ASSERT_EQ(pool.size(), 32);
+  ASSERT_EQ(pool.capacity(), 32);
+} // TEST
+
+TEST(object_pool, recycle) {
+  object_pool__<int, 2, 4> pool;
+
+  int * a = pool.allocate();
+  int * b = pool.allocate();
+  int * c = pool.allocate();
+
+  pool.deallocate(b);
+  pool.deallocate(a);
+  ASSERT_EQ(pool.size(), 1);
+
+  // Released blocks are reused, most recent first.
+  ASSERT_EQ(pool.allocate(), a);
+  ASSERT_EQ(pool.allocate(), b);
+  ASSERT_NE(pool.allocate(), c);
+  ASSERT_EQ(pool.capacity(), 4);
+} // TEST
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
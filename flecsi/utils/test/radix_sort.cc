@@ -0,0 +1,71 @@
+/*~--------------------------------------------------------------------------~*
+ *  @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+ * /@@/////  /@@          @@////@@ @@////// /@@
+ * /@@       /@@  @@@@@  @@    // /@@       /@@
+ * /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+ * /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+ * /@@       /@@/@@//// //@@    @@       /@@/@@
+ * /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+ * //       ///  //////   //////  ////////  //
+ *
+ * Copyright (c) 2016 Los Alamos National Laboratory, LLC
+ * All rights reserved
+ *~--------------------------------------------------------------------------~*/
+
+// user includes
+#include <flecsi/utils/radix_sort.h>
+
+// system includes
+#include <cinchtest.h>
+#include <cstdint>
+#include <random>
+
+using flecsi::utils::radix_sort;
+
+template<typename KEY>
+void
+check_sort(size_t n, KEY max) {
+  std::mt19937_64 gen(n);
+  std::uniform_int_distribution<uint64_t> dist(0, uint64_t(max));
+
+  std::vector<std::pair<KEY, size_t>> v;
+  for(size_t i = 0; i < n; ++i) {
+    v.emplace_back(KEY(dist(gen)), i);
+  } // for
+
+  auto expected = v;
+  std::stable_sort(expected.begin(), expected.end(),
+    [](const std::pair<KEY, size_t> & a, const std::pair<KEY, size_t> & b) {
+      return a.first < b.first;
+    });
+
+  radix_sort(v);
+  ASSERT_EQ(v, expected);
+} // check_sort
+
+TEST(radix_sort, unsigned_keys) {
+  check_sort<uint64_t>(0, ~uint64_t(0));
+  check_sort<uint64_t>(1, ~uint64_t(0));
+  check_sort<uint64_t>(10000, ~uint64_t(0));
+  check_sort<uint32_t>(10000, ~uint32_t(0));
+  check_sort<uint8_t>(1000, 255);
+
+  // Many equal keys and uniform high digits: the sort must be stable.
+  check_sort<uint64_t>(10000, 100);
+} // TEST
+
+TEST(radix_sort, other_keys) {
+  std::vector<std::pair<double, int>> v = {{2.0, 0}, {-1.0, 1}, {2.0, 2},
+    {0.5, 3}};
+
+  radix_sort(v);
+
+  std::vector<std::pair<double, int>> expected = {{-1.0, 1}, {0.5, 3},
+    {2.0, 0}, {2.0, 2}};
+  ASSERT_EQ(v, expected);
+} // TEST
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
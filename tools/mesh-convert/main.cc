@@ -0,0 +1,72 @@
+/*----------------------------------------------------------------------------*
+ *----------------------------------------------------------------------------*/
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <flecsi/io/csr_definition.h>
+#include <flecsi/io/indexed_definition.h>
+
+//----------------------------------------------------------------------------//
+// Convert a .msh file of the given dimension to the binary CSR format.
+//
+// Exodus inputs are converted the same way: any mesh definition that
+// provides vertex() can be passed to flecsi::io::write_csr_definition,
+// so a specialization's Exodus-backed definition can reuse this path.
+//----------------------------------------------------------------------------//
+
+template<size_t D>
+void convert(const char * input, const char * output) {
+	flecsi::io::indexed_definition__<D> md(input);
+	flecsi::io::write_csr_definition(md, output);
+
+	std::cout << "wrote " << output << ": " << md.num_entities(0) <<
+		" vertices, " << md.num_entities(D) << " cells" << std::endl;
+} // convert
+
+int main(int argc, char ** argv) {
+
+	if(argc < 3) {
+		std::cout << "Usage: " << argv[0] <<
+			" [-d dimension] input.msh output.csr" << std::endl;
+		std::exit(1);
+	} // if
+
+	// Parse the optional dimension flag.
+	size_t arg(1);
+	size_t dimension(2);
+	std::string flag("-d");
+
+	if(flag.compare(argv[1]) == 0) {
+		if(argc < 5) {
+			std::cout << "Usage: " << argv[0] <<
+				" [-d dimension] input.msh output.csr" << std::endl;
+			std::exit(1);
+		} // if
+
+		dimension = atoi(argv[2]);
+		arg = 3;
+	} // if
+
+	const char * input = argv[arg];
+	const char * output = argv[arg+1];
+
+	switch(dimension) {
+		case 1:
+			convert<1>(input, output);
+			break;
+		case 2:
+			convert<2>(input, output);
+			break;
+		case 3:
+			convert<3>(input, output);
+			break;
+		default:
+			std::cout << "invalid dimension " << dimension << std::endl;
+			std::exit(1);
+	} // switch
+
+	return 0;
+} // main